@@ -93,6 +93,44 @@ public:
 
     const AIGINDEX GetMaxIndex() const {return (AIGINDEX)m_IsVarRef.size();}
 
+    // remove the inputs (by position) the output does not depend on, every reference to a removed input is replaced by the constant false
+    // the indexes of the other inputs and the gates are kept
+    void RemoveInputs(const std::vector<bool>& isInputRemoved)
+    {
+        assert(isInputRemoved.size() == m_Inputs.size());
+
+        std::vector<bool> isIndexRemoved(m_IsVarRef.size(), false);
+        std::vector<AIGLIT> keptInputs;
+        for (size_t i = 0; i < m_Inputs.size(); i++)
+        {
+            if (isInputRemoved[i])
+            {
+                isIndexRemoved[AIGLitToAIGIndex(m_Inputs[i])] = true;
+                m_IsVarRef[AIGLitToAIGIndex(m_Inputs[i])] = false;
+            }
+            else
+            {
+                keptInputs.push_back(m_Inputs[i]);
+            }
+        }
+        m_Inputs = keptInputs;
+
+        // a negated removed input is the constant true
+        auto replaceLit = [&](AIGLIT lit) -> AIGLIT
+        {
+            return isIndexRemoved[AIGLitToAIGIndex(lit)] ? (IsAIGLitNeg(lit) ? 1 : 0) : lit;
+        };
+
+        for (AigAndGate& gate : m_AndGates)
+        {
+            gate = AigAndGate(gate.GetL(), replaceLit(gate.GetR0()), replaceLit(gate.GetR1()));
+        }
+        for (AIGLIT& outLit : m_Outputs)
+        {
+            outLit = replaceLit(outLit);
+        }
+    }
+
 protected:
 
     mutable std::vector<AIGLIT> m_Inputs;
@@ -6,4 +6,16 @@
 // #include "BoolMatchAlg/Iterative/DualRailEnc/BoolMatchAlgIterDREnc.hpp"
 
 // add all the headers of the blocking algorithms
-#include "BoolMatchAlg/Blocking/TseitinEnc/BoolMatchAlgBlockTseitinEnc.hpp"
\ No newline at end of file
+#include "BoolMatchAlg/Blocking/TseitinEnc/BoolMatchAlgBlockTseitinEnc.hpp"
+
+// add the header of the hybrid of the iterative and blocking algorithms
+#include "BoolMatchAlg/Hybrid/BoolMatchAlgHybrid.hpp"
+
+// add the header of the branch and bound over partial matches
+#include "BoolMatchAlg/BranchBound/BoolMatchAlgBranchBound.hpp"
+
+// add the header of the parallel run of the algorithms
+#include "BoolMatchAlg/Parallel/BoolMatchAlgParallel.hpp"
+
+// add the header of the race of several modes
+#include "BoolMatchAlg/Race/BoolMatchAlgRace.hpp"
\ No newline at end of file
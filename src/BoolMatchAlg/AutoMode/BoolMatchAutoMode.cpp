@@ -0,0 +1,284 @@
+#include "BoolMatchAlg/AutoMode/BoolMatchAutoMode.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <cmath>
+
+#include "Globals/BoolMatchAlgGlobals.hpp"
+#include "BoolMatchAlg/Algorithms.hpp"
+#include "CirSimulation/CirBitSim.hpp"
+
+using namespace std;
+
+
+BoolMatchAutoMode::BoolMatchAutoMode(const InputParser& inputParser):
+m_InputParser(inputParser),
+m_AllowInputNegMap(inputParser.getBoolCmdOption("/alg/allow_input_neg_map", false)),
+// default is 0 i.e. choose only by the rules
+m_ProbeTime(inputParser.getUintCmdOption("/mode/auto/probe_time", 0)),
+m_NumOfInputs(0),
+m_NumOfGates(0),
+m_MatchSpace(0),
+m_SymPairsRatio(0),
+m_PosUnateRatio(0),
+m_NegUnateRatio(0)
+{
+}
+
+
+vector<string> BoolMatchAutoMode::SelectParams(const string& srcFileName, const string& trgFileName)
+{
+    BoolMatchAlgBase::ParseAigFile(srcFileName, m_AigParserSrc);
+    BoolMatchAlgBase::ParseAigFile(trgFileName, m_AigParserTrg);
+
+    if (m_AigParserSrc.GetInputs().size() != m_AigParserTrg.GetInputs().size())
+    {
+        throw runtime_error("The number of inputs of the src and trg must be the same");
+    }
+
+    ComputeStructFeatures();
+    ComputeSimFeatures();
+    PrintFeatures();
+
+    vector<vector<string>> candidates = CreateCandidates();
+    size_t chosenCandidate = 0;
+
+    if (m_ProbeTime > 0)
+    {
+        double bestTime = -1;
+        for (size_t candIndex = 0; candIndex < candidates.size(); candIndex++)
+        {
+            double probeTime = RunProbe(candidates[candIndex]);
+            if (probeTime < 0)
+            {
+                cout << "c Auto mode probe " << candIndex << ": not finished in " << m_ProbeTime << " seconds" << endl;
+            }
+            else
+            {
+                cout << "c Auto mode probe " << candIndex << ": finished in " << probeTime << " seconds" << endl;
+                if (bestTime < 0 || probeTime < bestTime)
+                {
+                    bestTime = probeTime;
+                    chosenCandidate = candIndex;
+                }
+            }
+        }
+    }
+
+    cout << "c Auto mode chose:";
+    for (const string& param : candidates[chosenCandidate])
+    {
+        cout << " " << param;
+    }
+    cout << endl;
+
+    return candidates[chosenCandidate];
+}
+
+
+void BoolMatchAutoMode::ComputeStructFeatures()
+{
+    m_NumOfInputs = m_AigParserSrc.GetInputs().size();
+
+    m_NumOfGates = max(m_AigParserSrc.GetAndGated().size(), m_AigParserTrg.GetAndGated().size());
+
+    m_MatchSpace = tgamma((double)m_NumOfInputs + 1);
+    if (m_AllowInputNegMap)
+    {
+        m_MatchSpace *= pow(2.0, (double)m_NumOfInputs);
+    }
+}
+
+
+void BoolMatchAutoMode::ComputeSimFeatures()
+{
+    CirBitSim bitSim(m_AigParserSrc);
+
+    // use a fixed seed so the choice is deterministic
+    mt19937_64 randGen(0);
+
+    vector<vector<uint64_t>> patterns(NUM_OF_SIM_WORDS, vector<uint64_t>(m_NumOfInputs));
+    vector<uint64_t> outVals(NUM_OF_SIM_WORDS);
+    for (unsigned word = 0; word < NUM_OF_SIM_WORDS; word++)
+    {
+        for (size_t i = 0; i < m_NumOfInputs; i++)
+        {
+            patterns[word][i] = randGen();
+        }
+        outVals[word] = bitSim.SimulateOutput(patterns[word]);
+    }
+
+    // unate probe, compare the output when the input is fixed to 1 and to 0
+    size_t numOfPosUnate = 0;
+    size_t numOfNegUnate = 0;
+    for (size_t i = 0; i < m_NumOfInputs; i++)
+    {
+        bool isPosUnate = true;
+        bool isNegUnate = true;
+        for (unsigned word = 0; word < NUM_OF_SIM_WORDS && (isPosUnate || isNegUnate); word++)
+        {
+            vector<uint64_t> inputsVal = patterns[word];
+            inputsVal[i] = ~(uint64_t)0;
+            uint64_t outWhenTrue = bitSim.SimulateOutput(inputsVal);
+            inputsVal[i] = 0;
+            uint64_t outWhenFalse = bitSim.SimulateOutput(inputsVal);
+
+            isPosUnate = isPosUnate && (outWhenFalse & ~outWhenTrue) == 0;
+            isNegUnate = isNegUnate && (outWhenTrue & ~outWhenFalse) == 0;
+        }
+        numOfPosUnate += isPosUnate ? 1 : 0;
+        numOfNegUnate += isNegUnate ? 1 : 0;
+    }
+    // a circuit without inputs has no unate inputs
+    m_PosUnateRatio = m_NumOfInputs == 0 ? 0 : (double)numOfPosUnate / m_NumOfInputs;
+    m_NegUnateRatio = m_NumOfInputs == 0 ? 0 : (double)numOfNegUnate / m_NumOfInputs;
+
+    // symmetry probe, sample pairs if there are too many
+    vector<pair<size_t, size_t>> probePairs;
+    const size_t numOfPairs = m_NumOfInputs * (m_NumOfInputs - 1) / 2;
+    if (numOfPairs <= MAX_SYM_PROBE_PAIRS)
+    {
+        for (size_t i = 0; i < m_NumOfInputs; i++)
+        {
+            for (size_t j = i + 1; j < m_NumOfInputs; j++)
+            {
+                probePairs.push_back({i, j});
+            }
+        }
+    }
+    else
+    {
+        while (probePairs.size() < MAX_SYM_PROBE_PAIRS)
+        {
+            size_t i = randGen() % m_NumOfInputs;
+            size_t j = randGen() % m_NumOfInputs;
+            if (i != j)
+            {
+                probePairs.push_back({min(i, j), max(i, j)});
+            }
+        }
+    }
+
+    size_t numOfSymPairs = 0;
+    for (const auto& [i, j] : probePairs)
+    {
+        bool isSym = true;
+        bool isNegSym = m_AllowInputNegMap;
+        for (unsigned word = 0; word < NUM_OF_SIM_WORDS && (isSym || isNegSym); word++)
+        {
+            vector<uint64_t> inputsVal = patterns[word];
+            swap(inputsVal[i], inputsVal[j]);
+            isSym = isSym && bitSim.SimulateOutput(inputsVal) == outVals[word];
+
+            if (isNegSym)
+            {
+                inputsVal[i] = ~inputsVal[i];
+                inputsVal[j] = ~inputsVal[j];
+                isNegSym = bitSim.SimulateOutput(inputsVal) == outVals[word];
+            }
+        }
+        numOfSymPairs += (isSym || isNegSym) ? 1 : 0;
+    }
+    m_SymPairsRatio = probePairs.empty() ? 0 : (double)numOfSymPairs / probePairs.size();
+}
+
+
+vector<vector<string>> BoolMatchAutoMode::CreateCandidates() const
+{
+    // the parameters of the chosen mode are appended after the specific choices, so the specific choices take precedence
+    vector<string> tweaks;
+
+    if (m_AllowInputNegMap && m_NumOfGates > LARGE_CIR_NUM_OF_GATES)
+    {
+        // use only the simulation generalization
+        tweaks.insert(tweaks.end(), {"/alg/use_ucore", "0"});
+    }
+
+    if (!m_AllowInputNegMap)
+    {
+        // in a unate circuit the witnesses tend to the same value, so we do not alternate the max value
+        if (m_PosUnateRatio >= UNATE_RATIO_FOR_FIXED_MAX_VAL)
+        {
+            tweaks.insert(tweaks.end(), {"/alg/use_adap_for_max_val_apprx_strat", "0", "/alg/max_val_apprx_strat_init_val", "1"});
+        }
+        else if (m_NegUnateRatio >= UNATE_RATIO_FOR_FIXED_MAX_VAL)
+        {
+            tweaks.insert(tweaks.end(), {"/alg/use_adap_for_max_val_apprx_strat", "0", "/alg/max_val_apprx_strat_init_val", "0"});
+        }
+    }
+    // NOTE: the block type is left dynamic (the default of the modes), which choose the blocking of every witness by its cost
+
+    const string& blockMode = m_AllowInputNegMap ? EBATC_NP_BEST : EBATC_P_BEST;
+    const string& iterMode = m_AllowInputNegMap ? EBATP_NP_BEST : EBATP_P_BEST;
+
+    // in a small match space the iterative algorithm checks every match directly without the blocking overhead
+    // unless the circuit is symmetric, where the many valid matches are better covered by the strengthening of the blocking algorithm
+    const bool preferIter = m_MatchSpace <= ITER_MAX_MATCH_SPACE && m_SymPairsRatio < HIGH_SYM_PAIRS_RATIO;
+
+    vector<vector<string>> candidates;
+    for (const string& mode : preferIter ? vector<string>{iterMode, blockMode} : vector<string>{blockMode, iterMode})
+    {
+        vector<string> candidate = tweaks;
+        const vector<string>& modeParams = MODE_PARAMS.at(mode);
+        candidate.insert(candidate.end(), modeParams.begin(), modeParams.end());
+        candidates.push_back(candidate);
+    }
+
+    return candidates;
+}
+
+
+double BoolMatchAutoMode::RunProbe(const vector<string>& params) const
+{
+    InputParser probeInputParser = m_InputParser;
+    // the probe must not touch the checkpoint of the real run
+    probeInputParser.PrependParams({"/general/timeout", to_string(m_ProbeTime), "/general/print_matches", "0", "/general/checkpoint", "", "/general/resume", ""});
+    probeInputParser.AppendParams(params);
+
+    // the output of the probe is not needed
+    ostringstream probeOutput;
+    streambuf* coutBuf = cout.rdbuf(probeOutput.rdbuf());
+
+    BoolMatchAlgBase* probeAlg = nullptr;
+    double probeTime = -1;
+    try
+    {
+        if (probeInputParser.getCmdOptionWDef("/alg", "iter") == "iter")
+        {
+            probeAlg = new BoolMatchAlgIterTseitinEnc(probeInputParser);
+        }
+        else
+        {
+            probeAlg = new BoolMatchAlgBlockTseitinEnc(probeInputParser);
+        }
+
+        auto beforeProbe = chrono::steady_clock::now();
+        probeAlg->InitializeFromAIGs(m_AigParserSrc, m_AigParserTrg);
+        probeAlg->FindAllMatches(false);
+
+        if (!probeAlg->IsTimeOut())
+        {
+            probeTime = chrono::duration<double>(chrono::steady_clock::now() - beforeProbe).count();
+        }
+    }
+    catch (exception&)
+    {
+        // the candidate is not usable with the given parameters
+        probeTime = -1;
+    }
+
+    cout.rdbuf(coutBuf);
+    delete probeAlg;
+
+    return probeTime;
+}
+
+
+void BoolMatchAutoMode::PrintFeatures() const
+{
+    cout << "c Auto mode features: inputs " << m_NumOfInputs << ", gates " << m_NumOfGates
+        << ", match space " << m_MatchSpace << ", symmetric pairs " << m_SymPairsRatio
+        << ", positive unate inputs " << m_PosUnateRatio << ", negative unate inputs " << m_NegUnateRatio << endl;
+}
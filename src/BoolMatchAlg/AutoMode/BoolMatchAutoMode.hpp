@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "Globals/BoolMatchGloblas.hpp"
+#include "Aiger/AigerParser.hpp"
+#include "Utilities/InputParser.hpp"
+
+/*
+    choose the algorithm and its parameters for "/mode auto" from cheap features of the circuits
+    the features are the inputs and gates counts and a short simulation probe for symmetric and unate inputs
+    the choice is made by fixed rules, optionally the best candidates are run for a short time ("/mode/auto/probe_time") and the fastest is used
+*/
+class BoolMatchAutoMode
+{
+    public:
+
+        BoolMatchAutoMode(const InputParser& inputParser);
+
+        // compute the features of the given aiger files and choose the parameters
+        // return the parameters to append to the command line, the parameters given by the user take precedence
+        std::vector<std::string> SelectParams(const std::string& srcFileName, const std::string& trgFileName);
+
+    protected:
+
+        // compute the structural features of the circuits
+        void ComputeStructFeatures();
+
+        // simulate the src circuit to estimate the fraction of symmetric input pairs and unate inputs
+        void ComputeSimFeatures();
+
+        // create the candidate parameters from the features, where the first one is chosen by the rules
+        std::vector<std::vector<std::string>> CreateCandidates() const;
+
+        // run the algorithm with the parameters for at most m_ProbeTime seconds
+        // return the wall time if the run finished, or a negative value on timeout or error
+        double RunProbe(const std::vector<std::string>& params) const;
+
+        void PrintFeatures() const;
+
+        // *** Params ***
+
+        const InputParser& m_InputParser;
+        // if the negated map of the inputs is allowed (NP), otherwise P
+        const bool m_AllowInputNegMap;
+        // the timeout in seconds of every probe run, 0 means no probe runs
+        const unsigned m_ProbeTime;
+
+        // the number of 64 bit random patterns words to simulate
+        static const unsigned NUM_OF_SIM_WORDS = 8;
+        // the maximal number of input pairs to check for symmetry, sampled if there are more
+        static const size_t MAX_SYM_PROBE_PAIRS = 512;
+        // up to this number of matches, the iterative algorithm checks each match directly
+        static constexpr double ITER_MAX_MATCH_SPACE = 40320;
+        // from this fraction of symmetric input pairs, the circuit is expected to have many valid matches
+        static constexpr double HIGH_SYM_PAIRS_RATIO = 0.2;
+        // above this number of gates, the UnSAT core generalization of every witness is too expensive
+        static const size_t LARGE_CIR_NUM_OF_GATES = 20000;
+        // the fraction of unate inputs needed to fix the max-value strategy
+        static constexpr double UNATE_RATIO_FOR_FIXED_MAX_VAL = 0.9;
+
+        // *** Variables ***
+
+        AigerParser m_AigParserSrc;
+        AigerParser m_AigParserTrg;
+
+        // *** Features ***
+
+        size_t m_NumOfInputs;
+        // the number of gates of the larger circuit
+        size_t m_NumOfGates;
+        // the number of matches, n! for P and n!*2^n for NP
+        double m_MatchSpace;
+        // the fraction of probed input pairs where swapping the inputs (or swapping with negation in NP) keeps the output on all the patterns
+        double m_SymPairsRatio;
+        // the fraction of inputs where the output is only increasing (positive) -or- only decreasing (negative) in the input on all the patterns
+        double m_PosUnateRatio;
+        double m_NegUnateRatio;
+};
@@ -1,6 +1,6 @@
 #include "BoolMatchAlg/Blocking/BoolMatchAlgBlockBase.hpp"
 
-#include "BoolMatchMatrix/BoolMatchMatrixSingleVars/BoolMatchMatrixSingleVars.hpp"
+#include "BoolMatchMatrix/BoolMatchMatrices.hpp"
 
 using namespace std;
 
@@ -8,24 +8,85 @@ using namespace std;
 BoolMatchAlgBlockBase::BoolMatchAlgBlockBase(const InputParser& inputParser):
 BoolMatchAlgGenEnumerBase(inputParser),
 m_BlockMatchTypeWithInputsVal(ConvertToBoolMatchBlockType(inputParser.getUintCmdOption("/alg/block/block_match_type", DEF_BLOCK_MATCH_TYPE_UINT))),
-m_StopAfterBlockingAllNonValidMatches(inputParser.getBoolCmdOption("/alg/block/stop_after_blocking_all_non_valid_matches", false))
+m_StopAfterBlockingAllNonValidMatches(inputParser.getBoolCmdOption("/alg/block/stop_after_blocking_all_non_valid_matches", false)),
+// default is 0 i.e. only the solver model
+m_MaxExtraWitnesses(inputParser.getUintCmdOption("/alg/block/max_extra_witnesses", 0)),
+// default is 0 i.e. generalize in the solver thread
+// without any generalization method there is nothing to pipeline
+m_NumOfGenThreads(m_UseCirSim || m_UseDualSolver ? inputParser.getUintCmdOption("/alg/block/gen_threads", 0) : 0),
+m_ValidMatchSolver(nullptr),
+m_OnlyValidMatchMatrix(nullptr),
+m_SrcBitSim(nullptr),
+m_TrgBitSim(nullptr),
+m_NumOfExtraWitnesses(0)
 {
 }
 
 BoolMatchAlgBlockBase::~BoolMatchAlgBlockBase() 
 {
+    // the matrix is deleted before its solver
+    delete m_OnlyValidMatchMatrix;
+    delete m_ValidMatchSolver;
+
+    delete m_SrcBitSim;
+    delete m_TrgBitSim;
 }
 
 
-void BoolMatchAlgBlockBase::_InitMatchMatrix()
+void BoolMatchAlgBlockBase::PrintResult(bool wasInterrupted)
 {
-    MatrixIndexVecMatch initMatch = {};
+    BoolMatchAlgGenEnumerBase::PrintResult(wasInterrupted);
+
+    if (m_MaxExtraWitnesses > 0)
+    {
+        cout << "c Number of extra witnesses blocked: " << m_NumOfExtraWitnesses << endl;
+    }
+}
+
+
+void BoolMatchAlgBlockBase::_InitializeFromAIGs()
+{
+    if (m_MaxExtraWitnesses > 0)
+    {
+        m_SrcBitSim = new CirBitSim(m_AigParserSrc);
+        m_TrgBitSim = new CirBitSim(m_AigParserTrg);
+    }
+
+    BoolMatchAlgGenEnumerBase::_InitializeFromAIGs();
+}
 
+
+void BoolMatchAlgBlockBase::_InitMatchMatrix()
+{
     vector<SATLIT> srcInputs = m_Solver->GetLitsFromAIGInputs(m_SrcInputs, true);
     vector<SATLIT> trgInputs = m_Solver->GetLitsFromAIGInputs(m_TrgInputs, false);
 
     // TODO: edit the params here for the matrix
-    m_InputMatchMatrix = new BoolMatchMatrixSingleVars(m_Solver, srcInputs, trgInputs, m_BlockMatchTypeWithInputsVal, m_AllowInputNegMap, initMatch, false);
+    m_InputMatchMatrix = CreateBoolMatchMatrix(m_MatrixType, m_Solver, srcInputs, trgInputs, m_BlockMatchTypeWithInputsVal, m_AllowInputNegMap, m_ForbiddenPairs->GetFixedMatch(), m_AllowOutputNegMap, m_ForbiddenPairs->GetFeasibleMatches());
+    m_ForbiddenPairs->EliminateForbiddenPairs(m_InputMatchMatrix);
+
+    if (m_CompressSymMatches)
+    {
+        m_InputMatchMatrix->BreakInputSymmetries(m_SrcSymClasses, m_TrgSymClasses);
+    }
+
+    // TODO add param to use either topor or ipasir
+    m_ValidMatchSolver = new BoolMatchSolverTopor(m_InputParser, CirEncoding::TSEITIN_ENC, false);
+
+    m_OnlyValidMatchMatrix = CreateBoolMatchMatrix(m_MatrixType, m_ValidMatchSolver, m_InputSize, BoolMatchBlockType::DYNAMIC_BLOCK, m_AllowInputNegMap, m_ForbiddenPairs->GetFixedMatch(), m_AllowOutputNegMap, m_ForbiddenPairs->GetFeasibleMatches());
+    m_ForbiddenPairs->EliminateForbiddenPairs(m_OnlyValidMatchMatrix);
+    if (m_CompressSymMatches)
+    {
+        m_OnlyValidMatchMatrix->BreakInputSymmetries(m_SrcSymClasses, m_TrgSymClasses);
+    }
+}
+
+
+void BoolMatchAlgBlockBase::ResetMatchMatrices()
+{
+    BoolMatchAlgGenEnumerBase::ResetMatchMatrices();
+
+    m_OnlyValidMatchMatrix->ResetEliminatedMatches();
 }
 
 
@@ -35,4 +96,96 @@ void BoolMatchAlgBlockBase::PrintInitialInformation()
 
     cout << "c Use Blocking based algorithm" << endl;
     cout << "c Blocking type with inputs values: " << ConvertBoolMatchBlockTypeToString(m_BlockMatchTypeWithInputsVal) << endl;
+    if (m_MaxExtraWitnesses > 0)
+    {
+        cout << "c Max extra witnesses per solver call: " << m_MaxExtraWitnesses << endl;
+    }
+    if (m_NumOfGenThreads > 0)
+    {
+        cout << "c Generalize the witnesses in " << m_NumOfGenThreads << " threads" << endl;
+    }
+}
+
+
+vector<pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>> BoolMatchAlgBlockBase::FindExtraWitnesses(const INPUT_ASSIGNMENT& srcAssg, const INPUT_ASSIGNMENT& trgAssg)
+{
+    vector<pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>> extraWitnesses;
+
+    if (m_MaxExtraWitnesses == 0)
+    {
+        return extraWitnesses;
+    }
+
+    assert(m_SrcBitSim != nullptr && m_TrgBitSim != nullptr);
+
+    // all the 64 patterns hold the model values
+    auto getAssgWords = [](const INPUT_ASSIGNMENT& assg)
+    {
+        vector<uint64_t> words(assg.size());
+        for (size_t i = 0; i < assg.size(); i++)
+        {
+            words[i] = assg[i].second == TVal::True ? ~0ULL : 0ULL;
+        }
+        return words;
+    };
+
+    for (bool isSrc : {true, false})
+    {
+        const INPUT_ASSIGNMENT& currAssg = isSrc ? srcAssg : trgAssg;
+        CirBitSim* currBitSim = isSrc ? m_SrcBitSim : m_TrgBitSim;
+        CirBitSim* otherBitSim = isSrc ? m_TrgBitSim : m_SrcBitSim;
+
+        // the other side is fixed, a candidate is a witness if its output differs from the other output (or is equal to it for the negated output)
+        const uint64_t otherOut = otherBitSim->SimulateOutput(getAssgWords(isSrc ? trgAssg : srcAssg)) ^ (m_IsOutputNegMatch ? ~0ULL : 0ULL);
+
+        const vector<uint64_t> baseWords = getAssgWords(currAssg);
+
+        // all the swaps of two inputs with different values
+        vector<pair<size_t, size_t>> swaps;
+        for (size_t i = 0; i < currAssg.size(); i++)
+        {
+            for (size_t j = i + 1; j < currAssg.size(); j++)
+            {
+                if ((baseWords[i] != 0) != (baseWords[j] != 0))
+                {
+                    swaps.push_back({i, j});
+                }
+            }
+        }
+
+        for (size_t first = 0; first < swaps.size() && extraWitnesses.size() < m_MaxExtraWitnesses; first += 64)
+        {
+            const size_t batchSize = min((size_t)64, swaps.size() - first);
+
+            // every bit of the words is a different candidate
+            vector<uint64_t> words = baseWords;
+            for (size_t c = 0; c < batchSize; c++)
+            {
+                const uint64_t bit = 1ULL << c;
+                words[swaps[first + c].first] ^= bit;
+                words[swaps[first + c].second] ^= bit;
+            }
+
+            uint64_t witnessBits = currBitSim->SimulateOutput(words) ^ otherOut;
+            for (size_t c = 0; c < batchSize && extraWitnesses.size() < m_MaxExtraWitnesses; c++)
+            {
+                if ((witnessBits >> c) & 1ULL)
+                {
+                    INPUT_ASSIGNMENT witnessAssg = currAssg;
+                    swap(witnessAssg[swaps[first + c].first].second, witnessAssg[swaps[first + c].second].second);
+
+                    if (isSrc)
+                    {
+                        extraWitnesses.push_back({witnessAssg, trgAssg});
+                    }
+                    else
+                    {
+                        extraWitnesses.push_back({srcAssg, witnessAssg});
+                    }
+                }
+            }
+        }
+    }
+
+    return extraWitnesses;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "BoolMatchSolver/Solvers.hpp"
 #include "BoolMatchMatrix/BoolMatchMatrixBase.hpp"
 #include "CirSimulation/CirSim.hpp"
+#include "CirSimulation/CirBitSim.hpp"
 
 /*
     Solver for boolean matching base on the iteration algorithm
@@ -17,23 +18,52 @@ class BoolMatchAlgBlockBase : public BoolMatchAlgGenEnumerBase
 
         virtual ~BoolMatchAlgBlockBase();
 
+        void PrintResult(bool wasInterrupted = false) override;
+
     protected:
 
         // print initial information, timeout etc..
         virtual void PrintInitialInformation();
 
+        void _InitializeFromAIGs() override;
+
         void _InitMatchMatrix() override;
 
+        // also reset the valid matches matrix
+        void ResetMatchMatrices() override;
+
+        // find up to m_MaxExtraWitnesses more non-valid matches witnesses near the given one (srcAssg, trgAssg)
+        // each witness is a neighbor of the given one, where two inputs with different values are swapped on one side
+        // swapping keeps the number of ones, so the witness is also valid for the P blocking
+        // NOTE: the candidates are evaluated with bit-parallel simulation, 64 at a time
+        std::vector<std::pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>> FindExtraWitnesses(const INPUT_ASSIGNMENT& srcAssg, const INPUT_ASSIGNMENT& trgAssg);
+
         // *** Params ***
 
         // choose the blocking type for the matrix when we use the inputs values for the blocking
         const BoolMatchBlockType m_BlockMatchTypeWithInputsVal;
         // if to stop after blocking all the non-valid matches
         const bool m_StopAfterBlockingAllNonValidMatches;
+        // the maximal number of extra witnesses to block for every solver call, 0 means only the solver model
+        const unsigned m_MaxExtraWitnesses;
+        // the number of threads that generalize the witnesses while the solver search for the next one, 0 means no pipeline
+        // in the pipeline every witness is blocked at once, and blocked again after it is generalized
+        const unsigned m_NumOfGenThreads;
   
         // *** Variables ***
 
+        // solver for the matrix of only the valid matches, where all the non-valid matches are blocked
+        BoolMatchSolverBase* m_ValidMatchSolver;
+        // the matrix of only the valid matches, kept between the calls to FindAllMatchesUnderOutputAssert (work cubes)
+        BoolMatchMatrixBase* m_OnlyValidMatchMatrix;
+
+        // bit-parallel simulation used for finding extra witnesses
+        CirBitSim* m_SrcBitSim;
+        CirBitSim* m_TrgBitSim;
 
 		// *** Stats ***
 
+        // number of extra witnesses that were blocked
+        unsigned long m_NumOfExtraWitnesses;
+
 };
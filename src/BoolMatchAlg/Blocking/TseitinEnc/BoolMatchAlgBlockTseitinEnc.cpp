@@ -1,6 +1,13 @@
 #include "BoolMatchAlg/Blocking/TseitinEnc/BoolMatchAlgBlockTseitinEnc.hpp"
 
-#include "BoolMatchMatrix/BoolMatchMatrixSingleVars/BoolMatchMatrixSingleVars.hpp"
+#include "BoolMatchMatrix/BoolMatchMatrices.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 
@@ -11,6 +18,17 @@ m_UseIpaisrAsDual(inputParser.getBoolCmdOption("/alg/block/use_ipasir_for_dual",
 m_UseUcoreForValidMatch(inputParser.getBoolCmdOption("/alg/block/use_ucore_for_valid_match", false)),
 m_UcoreSolverForValidMatch(nullptr)
 {
+    // a partial valid match does not represent a known number of symmetric matches
+    if (m_UseUcoreForValidMatch && m_CompressSymMatches)
+    {
+        throw runtime_error("Can not use UnSAT core for valid match when compressing symmetric matches");
+    }
+
+    if (m_NumOfSamples > 0)
+    {
+        throw runtime_error("Sampling valid matches is supported only by the iterative algorithm");
+    }
+
     if (m_UseIpaisrAsPrimary)
     {
         m_Solver = new BoolMatchSolverIpasir(inputParser, CirEncoding::TSEITIN_ENC, false);
@@ -39,11 +57,75 @@ m_UcoreSolverForValidMatch(nullptr)
         // NOET: currently we use ipasir for the ucore solver since it should be better for the ucore extraction
         m_UcoreSolverForValidMatch = new BoolMatchSolverIpasir(inputParser, CirEncoding::TSEITIN_ENC, false);
     }
+
+    for (unsigned genThreadId = 0; genThreadId < m_NumOfGenThreads; genThreadId++)
+    {
+        if (m_UseDualSolver)
+        {
+            if (m_UseIpaisrAsDual)
+            {
+                m_GenDualSolvers.push_back(new BoolMatchSolverIpasir(inputParser, CirEncoding::TSEITIN_ENC, true));
+            }
+            else
+            {
+                m_GenDualSolvers.push_back(new BoolMatchSolverTopor(inputParser, CirEncoding::TSEITIN_ENC, true));
+            }
+        }
+        else
+        {
+            m_GenDualSolvers.push_back(nullptr);
+        }
+    }
 }
 
 BoolMatchAlgBlockTseitinEnc::~BoolMatchAlgBlockTseitinEnc()
 {
     delete m_UcoreSolverForValidMatch;
+
+    for (BoolMatchSolverBase* genDualSolver : m_GenDualSolvers)
+    {
+        delete genDualSolver;
+    }
+    for (CirSim* genCirSim : m_GenSrcCirSims)
+    {
+        delete genCirSim;
+    }
+    for (CirSim* genCirSim : m_GenTrgCirSims)
+    {
+        delete genCirSim;
+    }
+}
+
+void BoolMatchAlgBlockTseitinEnc::_InitializeFromAIGs()
+{
+    BoolMatchAlgBlockBase::_InitializeFromAIGs();
+
+    // if needed initialize m_UcoreSolverForValidMatch
+    if (m_UseUcoreForValidMatch)
+    {
+        m_UcoreSolverForValidMatch->InitializeSolverFromAIG(m_AigParserSrc, m_AigParserTrg);
+        AssertOutputMitter(m_UcoreSolverForValidMatch, false);
+    }
+
+    for (unsigned genThreadId = 0; genThreadId < m_NumOfGenThreads; genThreadId++)
+    {
+        if (m_UseCirSim)
+        {
+            m_GenSrcCirSims.push_back(new CirSim(m_AigParserSrc, m_UseTopToBotSim ? SimStrat::TopToBot : SimStrat::BotToTop));
+            m_GenTrgCirSims.push_back(new CirSim(m_AigParserTrg, m_UseTopToBotSim ? SimStrat::TopToBot : SimStrat::BotToTop));
+        }
+        else
+        {
+            m_GenSrcCirSims.push_back(nullptr);
+            m_GenTrgCirSims.push_back(nullptr);
+        }
+
+        if (m_UseDualSolver)
+        {
+            m_GenDualSolvers[genThreadId]->InitializeSolverFromAIG(m_AigParserSrc, m_AigParserTrg);
+            AssertOutputMitter(m_GenDualSolvers[genThreadId], true);
+        }
+    }
 }
 
 void BoolMatchAlgBlockTseitinEnc::PrintInitialInformation()
@@ -57,158 +139,268 @@ void BoolMatchAlgBlockTseitinEnc::PrintInitialInformation()
     }
 }
 
-void BoolMatchAlgBlockTseitinEnc::FindAllMatchesUnderOutputAssert()
+void BoolMatchAlgBlockTseitinEnc::BlockCurrNonValidWitness()
 {
-    // if we use match selector we need to add it to the assumption
-    vector<SATLIT> assump = {m_InputMatchMatrix->GetMatchSelector()};
+    INPUT_ASSIGNMENT srcAssg = m_Solver->GetAssignmentForAIGLits(m_SrcInputs, true);
+    INPUT_ASSIGNMENT trgAssg = m_Solver->GetAssignmentForAIGLits(m_TrgInputs, false);
+    
+    // cout << "c Found Invalid Match" << endl;
+    // PrintModel(srcAssg);
+    // PrintModel(trgAssg);
 
-    // TODO add param to use either topor or ipasir
-    BoolMatchSolverTopor validMatchSolver = BoolMatchSolverTopor(m_InputParser, CirEncoding::TSEITIN_ENC, false);
+    clock_t beforeGen = ThreadClock();
+    pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> srcAndTrgGen = GeneralizeModel(srcAssg, trgAssg);
+    unsigned long genCpuTimeTaken =  ThreadClock() - beforeGen;
+    double genTime = (double)(genCpuTimeTaken)/(double)(CLOCKS_PER_SEC);
 
-    MatrixIndexVecMatch initMatch = {};
-    BoolMatchMatrixSingleVars onlyValidMatchMatrix = BoolMatchMatrixSingleVars(&validMatchSolver, m_InputSize, BoolMatchBlockType::DYNAMIC_BLOCK, m_AllowInputNegMap, initMatch, false);
+    m_TimeOnGeneralization += genTime;
 
-    // this is to use locally, we also have the global one (m_TotalNumberOfMatches)
-    unsigned numOfNonValidMatch = 0;
+    // cout << "c After generalization" << endl;
+    // PrintModel(srcAndTrgGen.first);
+    // PrintModel(srcAndTrgGen.second);
 
-    unsigned lastMaxVal = m_MaxValApprxStratInitVal;
+    BlockWitness(InputAssg2Indx(srcAndTrgGen.first, true), InputAssg2Indx(srcAndTrgGen.second, false), m_OnlyValidMatchMatrix);
 
-    // while we have non valid matches - meaning we get SAT (false) from the solver
-    while (!CheckSolverUnderAssump(m_Solver, assump, m_UseMaxValApprxStrat, lastMaxVal, m_MaxValApprxStratBoostVal))
+    // block more witnesses near the model without calling the solver again
+    for (const pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>& witness : FindExtraWitnesses(srcAssg, trgAssg))
     {
-        numOfNonValidMatch++;
-        m_TotalNumberOfMatches++;
+        beforeGen = ThreadClock();
+        pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> witnessGen = GeneralizeModel(witness.first, witness.second);
+        m_TimeOnGeneralization += (double)(ThreadClock() - beforeGen)/(double)(CLOCKS_PER_SEC);
+
+        BlockWitness(InputAssg2Indx(witnessGen.first, true), InputAssg2Indx(witnessGen.second, false), m_OnlyValidMatchMatrix);
+        m_NumOfExtraWitnesses++;
+    }
+}
 
-        INPUT_ASSIGNMENT srcAssg = m_Solver->GetAssignmentForAIGLits(m_SrcInputs, true);
-        INPUT_ASSIGNMENT trgAssg = m_Solver->GetAssignmentForAIGLits(m_TrgInputs, false);
-        
-        // cout << "c Found Invalid Match" << endl;
-        // PrintModel(srcAssg);
-        // PrintModel(trgAssg);
 
-        clock_t beforeGen = clock();
-        pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> srcAndTrgGen = GeneralizeModel(srcAssg, trgAssg);
-        unsigned long genCpuTimeTaken =  clock() - beforeGen;
-        double genTime = (double)(genCpuTimeTaken)/(double)(CLOCKS_PER_SEC);
+unsigned BoolMatchAlgBlockTseitinEnc::BlockNonValidMatchesPipelined(vector<SATLIT>& assump)
+{
+    unsigned numOfNonValidMatch = 0;
+
+    unsigned lastMaxVal = m_MaxValApprxStratInitVal;
 
-        m_TimeOnGeneralization += genTime;
+    // the witnesses to generalize and the generalized ones, both guarded by witnessesMutex
+    deque<pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>> witnessesToGen;
+    deque<pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>> genWitnesses;
+    mutex witnessesMutex;
+    condition_variable witnessesCond;
+    bool isDone = false;
 
-        // cout << "c After generalization" << endl;
-        // PrintModel(srcAndTrgGen.first);
-        // PrintModel(srcAndTrgGen.second);
+    // the first error of the generalization threads
+    exception_ptr genError = nullptr;
+    // the time of every generalization thread, summed after the threads finished
+    vector<double> genTimes(m_NumOfGenThreads, 0);
 
-        m_InputMatchMatrix->BlockMatchesByInputsVal(InputAssg2Indx(srcAndTrgGen.first, true), InputAssg2Indx(srcAndTrgGen.second, false), &onlyValidMatchMatrix);
+    auto runGenThread = [&](unsigned genThreadId)
+    {
+        BlockStopSignals();
 
-        if (m_UseMaxValApprxStrat && m_UseAdapForMaxValApprxStrat)
+        try
         {
-            // try to switch between 0 and 1
-            lastMaxVal = m_InputMatchMatrix->GetLastMaxVal() > 0 ? 0 : 1;
-            // lastMaxVal = m_InputMatchMatrix->GetLastMaxVal();
-        }
-    }
+            while (true)
+            {
+                pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> witness;
+                {
+                    unique_lock<mutex> lock(witnessesMutex);
+                    witnessesCond.wait(lock, [&] { return isDone || !witnessesToGen.empty(); });
+                    if (isDone)
+                    {
+                        return;
+                    }
+                    witness = move(witnessesToGen.front());
+                    witnessesToGen.pop_front();
+                }
 
-    cout << "c Finished blocking " << numOfNonValidMatch << " non-valid matches" << endl;
+                auto beforeGen = chrono::steady_clock::now();
+                pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> witnessGen = GeneralizeModel(witness.first, witness.second,
+                    m_GenSrcCirSims[genThreadId], m_GenTrgCirSims[genThreadId], m_GenDualSolvers[genThreadId]);
+                genTimes[genThreadId] += chrono::duration<double>(chrono::steady_clock::now() - beforeGen).count();
 
-    if (m_StopAfterBlockingAllNonValidMatches)
-    {
-        return;
-    }
+                lock_guard<mutex> lock(witnessesMutex);
+                genWitnesses.push_back(move(witnessGen));
+            }
+        }
+        catch (...)
+        {
+            lock_guard<mutex> lock(witnessesMutex);
+            if (genError == nullptr)
+            {
+                genError = current_exception();
+            }
+        }
+    };
 
-    // if needed initialize m_UcoreSolverForValidMatch
-    if (m_UseUcoreForValidMatch)
+    vector<thread> genThreads;
+    for (unsigned genThreadId = 0; genThreadId < m_NumOfGenThreads; genThreadId++)
     {
-        m_UcoreSolverForValidMatch->InitializeSolverFromAIG(m_AigParserSrc, m_AigParserTrg);
-        m_UcoreSolverForValidMatch->AssertOutputDiff(false);
+        genThreads.emplace_back(runGenThread, genThreadId);
     }
 
-    SOLVER_RET_STATUS nextValidMatchStatus = onlyValidMatchMatrix.FindNextMatch();
-    while (nextValidMatchStatus == SAT_RET_STATUS)
+    auto stopGenThreads = [&]()
     {
-        m_TotalNumberOfMatches++;
-        m_NumberOfValidMatches++;
+        {
+            lock_guard<mutex> lock(witnessesMutex);
+            isDone = true;
+        }
+        witnessesCond.notify_all();
+
+        for (thread& genThread : genThreads)
+        {
+            genThread.join();
+        }
 
-        MatrixIndexVecMatch currMatch = onlyValidMatchMatrix.GetCurrMatch();
-        
-        if (m_UseUcoreForValidMatch)
+        for (double genTime : genTimes)
         {
-            vector<SATLIT> assump = GetInputMatchAssump(m_UcoreSolverForValidMatch, currMatch);
+            m_TimeOnGeneralization += genTime;
+        }
+    };
+
+    try
+    {
+        // while we have non valid matches - meaning we get SAT (false) from the solver
+        while (!IsStopRequested() && !CheckSolverUnderAssump(m_Solver, assump, m_UseMaxValApprxStrat, lastMaxVal, m_MaxValApprxStratBoostVal))
+        {
+            numOfNonValidMatch++;
+            m_TotalNumberOfMatches++;
+
+            INPUT_ASSIGNMENT srcAssg = m_Solver->GetAssignmentForAIGLits(m_SrcInputs, true);
+            INPUT_ASSIGNMENT trgAssg = m_Solver->GetAssignmentForAIGLits(m_TrgInputs, false);
 
-		    SOLVER_RET_STATUS res = m_UcoreSolverForValidMatch->SolveUnderAssump(assump);
-            if (res == TIMEOUT_RET_STATUS)
+            vector<pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>> newWitnesses = {{srcAssg, trgAssg}};
+            // block more witnesses near the model without calling the solver again
+            for (const pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>& witness : FindExtraWitnesses(srcAssg, trgAssg))
             {
-                m_IsTimeOut = true;
-                throw runtime_error("Timeout reached");
+                newWitnesses.push_back(witness);
+                m_NumOfExtraWitnesses++;
             }
-            // response must be unsat at this point, throw exception if not
-            if (res != UNSAT_RET_STATUS)
+
+            // block the witnesses at once so the solver will not return them again, the generalized ones are blocked later
+            // they are also recorded (checkpoint and shared with other workers), since the queued ones are dropped when the search stops
+            for (const pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>& witness : newWitnesses)
             {
-                throw runtime_error("Solver return non - Unsatisfiable status when using UnSAT core for valid matches");
+                BlockWitness(InputAssg2Indx(witness.first, true), InputAssg2Indx(witness.second, false), m_OnlyValidMatchMatrix);
             }
 
-            // TODO - from now on this code is duplicated from src/BoolMatchAlg/Iterative/TseitinEnc/BoolMatchAlgIterTseitinEnc.cpp, should we create a function for this?
-
-            // will hold the partial map of the inputs suffice for valid mapping, meaning no matter how we complete the rest of the mapping
-            MatrixIndexVecMatch currPartialValidMatch;
-            // NOTE: at this point we know the only assumption used are the matches assumptions, this is important for the UCore extraction
-            // go over the match assumptions and try to remove
-            for (size_t matchIndex = 0; matchIndex < currMatch.size(); matchIndex++)
+            vector<pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>> readyWitnesses;
             {
-                if (m_UcoreSolverForValidMatch->IsAssumptionRequired(matchIndex))
+                lock_guard<mutex> lock(witnessesMutex);
+                if (genError != nullptr)
                 {
-                    currPartialValidMatch.push_back(currMatch[matchIndex]);
+                    break;
                 }
+                witnessesToGen.insert(witnessesToGen.end(), newWitnesses.begin(), newWitnesses.end());
+                readyWitnesses.assign(genWitnesses.begin(), genWitnesses.end());
+                genWitnesses.clear();
             }
+            witnessesCond.notify_all();
 
-            //TODO add param
-            // now do minimal unsat core with drop lit
-            // iterating from back to begin to support remove and iteration of vector
-            for (int matchIndex = currPartialValidMatch.size() - 1; matchIndex >= 0; --matchIndex) 
+            // the solver is used only by this thread, so the generalized witnesses are blocked here between the solver calls
+            for (const pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT>& witnessGen : readyWitnesses)
             {
-                // Temporary store the current match
-                MatrixIndexMatch tempMatch = currPartialValidMatch[matchIndex];
-
-                // Remove the current lit from the, copy the last element
-                currPartialValidMatch[matchIndex] = currPartialValidMatch.back();
-                currPartialValidMatch.pop_back();
-
-                vector<SATLIT> currAssump = GetInputMatchAssump(m_UcoreSolverForValidMatch, currPartialValidMatch);
-                if (CheckSolverUnderAssump(m_UcoreSolverForValidMatch, currAssump)) 
-                {
-                    // this mean we manage to remove the match from the core
-                    // TODO add here recurisve unsat core extraction?			
-                } 
-                else 
-                {
-                    // we can not remove the match from the core
-                    // restore the lit to the vector, where the position is changed (should not be a problem)
-                    currPartialValidMatch.push_back(tempMatch);
-                }
+                BlockWitness(InputAssg2Indx(witnessGen.first, true), InputAssg2Indx(witnessGen.second, false), m_OnlyValidMatchMatrix);
             }
 
-            // NOTE: should we iterate and create the full matches form the partial?
-            currMatch = currPartialValidMatch;
-
-            // check if we manage to generalize the match to tautology
-            if (currMatch.size() == 0)
+            if (m_UseMaxValApprxStrat && m_UseAdapForMaxValApprxStrat)
             {
-                // we have a tautology
-                cout << "c Found tautology when using UnSAT core for valid matches" << endl;
+                // try to switch between 0 and 1
+                lastMaxVal = m_InputMatchMatrix->GetLastMaxVal() > 0 ? 0 : 1;
             }
+
+            BlockSharedWitnesses(m_OnlyValidMatchMatrix);
         }
+    }
+    catch (...)
+    {
+        stopGenThreads();
+        throw;
+    }
+
+    // the witnesses left in the queues are already blocked and recorded without generalization
+    stopGenThreads();
+
+    if (genError != nullptr)
+    {
+        rethrow_exception(genError);
+    }
+
+    return numOfNonValidMatch;
+}
+
+void BoolMatchAlgBlockTseitinEnc::FindAllMatchesUnderOutputAssert()
+{
+    // if we use match selector we need to add it to the assumption
+    vector<SATLIT> assump = {m_InputMatchMatrix->GetMatchSelector()};
+    // restrict the matches to the work cube in a parallel run
+    vector<SATLIT> workCubeAssump = GetWorkCubeAssump(m_InputMatchMatrix);
+    assump.insert(assump.end(), workCubeAssump.begin(), workCubeAssump.end());
+
+    // this is to use locally, we also have the global one (m_TotalNumberOfMatches)
+    unsigned numOfNonValidMatch = 0;
+
+    unsigned lastMaxVal = m_MaxValApprxStratInitVal;
 
-        if (m_PrintMatches)
+    BlockSharedWitnesses(m_OnlyValidMatchMatrix);
+
+    if (m_NumOfGenThreads > 0)
+    {
+        numOfNonValidMatch = BlockNonValidMatchesPipelined(assump);
+    }
+    else
+    {
+        // while we have non valid matches - meaning we get SAT (false) from the solver
+        while (!IsStopRequested() && !CheckSolverUnderAssump(m_Solver, assump, m_UseMaxValApprxStrat, lastMaxVal, m_MaxValApprxStratBoostVal))
         {
-            PrintMatrixIndexMatchAsAIG(currMatch);
+            numOfNonValidMatch++;
+            m_TotalNumberOfMatches++;
+
+            BlockCurrNonValidWitness();
+
+            if (m_UseMaxValApprxStrat && m_UseAdapForMaxValApprxStrat)
+            {
+                // try to switch between 0 and 1
+                lastMaxVal = m_InputMatchMatrix->GetLastMaxVal() > 0 ? 0 : 1;
+                // lastMaxVal = m_InputMatchMatrix->GetLastMaxVal();
+            }
+
+            BlockSharedWitnesses(m_OnlyValidMatchMatrix);
         }
+    }
+
+    // in a parallel run the workers report the results at the end
+    if (m_ParallelState == nullptr)
+    {
+        cout << "c Finished blocking " << numOfNonValidMatch << " non-valid matches" << endl;
+    }
+
+    if (m_StopAfterBlockingAllNonValidMatches)
+    {
+        return;
+    }
+
+    EnumerateValidMatches();
+}
+
+
+void BoolMatchAlgBlockTseitinEnc::EnumerateValidMatches()
+{
+    const vector<SATLIT> validWorkCubeAssump = GetWorkCubeAssump(m_OnlyValidMatchMatrix);
+
+    SOLVER_RET_STATUS nextValidMatchStatus = m_OnlyValidMatchMatrix->FindNextMatch(validWorkCubeAssump);
+    while (nextValidMatchStatus == SAT_RET_STATUS && !IsStopRequested())
+    {
+        m_TotalNumberOfMatches++;
+
+        HandleValidMatch(m_OnlyValidMatchMatrix->GetCurrMatch());
 
         if (m_StopAtFirstValidMatch)
         {
             return;
         }
 
-        onlyValidMatchMatrix.EliminateMatch(currMatch);
+        SaveCheckpointPeriodically();
 
-        nextValidMatchStatus = onlyValidMatchMatrix.FindNextMatch();
+        nextValidMatchStatus = m_OnlyValidMatchMatrix->FindNextMatch(validWorkCubeAssump);
     }
 
     // check for timeout
@@ -217,4 +409,27 @@ void BoolMatchAlgBlockTseitinEnc::FindAllMatchesUnderOutputAssert()
         m_IsTimeOut = true;
 		throw runtime_error("Timeout reached");
     }
-}
\ No newline at end of file
+}
+
+
+void BoolMatchAlgBlockTseitinEnc::HandleValidMatch(MatrixIndexVecMatch currMatch)
+{
+    if (m_UseUcoreForValidMatch)
+    {
+        vector<SATLIT> assump = GetInputMatchAssump(m_UcoreSolverForValidMatch, currMatch);
+
+        SOLVER_RET_STATUS res = m_UcoreSolverForValidMatch->SolveUnderAssump(assump);
+        if (res == TIMEOUT_RET_STATUS)
+        {
+            m_IsTimeOut = true;
+            throw runtime_error("Timeout reached");
+        }
+        // response must be unsat at this point, throw exception if not
+        if (res != UNSAT_RET_STATUS)
+        {
+            throw runtime_error("Solver return non - Unsatisfiable status when using UnSAT core for valid matches");
+        }
+    }
+
+    BoolMatchAlgGenEnumerBase::HandleValidMatch(currMatch, m_UseUcoreForValidMatch ? m_UcoreSolverForValidMatch : nullptr, m_OnlyValidMatchMatrix);
+}
@@ -18,7 +18,24 @@ class BoolMatchAlgBlockTseitinEnc : public BoolMatchAlgBlockBase
         // print initial information, timeout etc..
         virtual void PrintInitialInformation();
 
+        void _InitializeFromAIGs() override;
+
         virtual void FindAllMatchesUnderOutputAssert();
+
+        // generalize the non-valid witness of the current m_Solver model and block it, together with its extra witnesses
+        void BlockCurrNonValidWitness();
+
+        // enumerate the valid matches left in m_OnlyValidMatchMatrix, used after all the non-valid matches were blocked
+        void EnumerateValidMatches();
+
+        // count, strengthen (if m_UseUcoreForValidMatch) and print the valid match, then eliminate it from m_OnlyValidMatchMatrix
+        void HandleValidMatch(MatrixIndexVecMatch currMatch);
+        using BoolMatchAlgGenEnumerBase::HandleValidMatch;
+
+        // block all the non-valid matches under the assumptions, where the witnesses are generalized by m_NumOfGenThreads threads
+        // every witness is blocked at once, and the generalized one is blocked by this (solver) thread between the solver calls
+        // return the number of non-valid matches
+        unsigned BlockNonValidMatchesPipelined(std::vector<SATLIT>& assump);
         
         // *** Params ***
 
@@ -34,6 +51,11 @@ class BoolMatchAlgBlockTseitinEnc : public BoolMatchAlgBlockBase
         // solver for the circuits mitter if m_UseUcoreForValidMatch is used
         BoolMatchSolverBase* m_UcoreSolverForValidMatch;
 
+        // the simulations and dual solvers of the generalization threads, one for every thread
+        std::vector<CirSim*> m_GenSrcCirSims;
+        std::vector<CirSim*> m_GenTrgCirSims;
+        std::vector<BoolMatchSolverBase*> m_GenDualSolvers;
+
 
 		// *** Stats ***
 
@@ -1,6 +1,10 @@
 #include "BoolMatchAlg/BoolMatchAlgBase.hpp"
 
+#include <climits>
+#include <signal.h>
+
 #include "Globals/BoolMatchAlgGlobals.hpp"
+#include "BoolMatchAlg/Invariants/BoolMatchInputInvariants.hpp"
 #include "Utilities/StringUtilities.hpp"
 
 using namespace std;
@@ -17,12 +21,19 @@ m_UseTimeOut(inputParser.cmdOptionExists("/general/timeout")),
 m_TimeOut(inputParser.getUintCmdOption("/general/timeout", DEF_TIMEOUT)),
 // *** alg related params ***
 m_AllowInputNegMap(inputParser.getBoolCmdOption("/alg/allow_input_neg_map", false)),
+// default is false
+m_AllowOutputNegMap(inputParser.getBoolCmdOption("/alg/allow_output_neg_map", false)),
 m_StopAtFirstValidMatch(inputParser.getBoolCmdOption("/alg/stop_at_first_valid_match", false)),
+// default is false
+m_ReduceToSupport(inputParser.getBoolCmdOption("/alg/reduce_to_support", false)),
 m_IsInit(false),
 m_IsTimeOut(false), 
+m_IsStopRequested(false),
+m_IsSupportSizeDiff(false),
 m_TimeOnGeneralization(0),
 m_NumberOfValidMatches(0),
-m_TotalNumberOfMatches(0)
+m_TotalNumberOfMatches(0),
+m_NumOfIrrelevantMatches(1)
 {
     m_Clk = clock();
 }
@@ -58,6 +69,38 @@ void BoolMatchAlgBase::PrintInitialInformation()
     {
         cout << "c Do not allow negated map to the inputs" << endl;
     }
+    if (m_AllowOutputNegMap)
+    {
+        cout << "c Allow negated map to the output" << endl;
+    }
+    if (m_ReduceToSupport)
+    {
+        if (m_IsSupportSizeDiff)
+        {
+            cout << "c Reduce to the support, the src and trg supports have different sizes, there is no valid match" << endl;
+        }
+        else
+        {
+            cout << "c Reduce to the support, " << m_SrcIrrelevantInputs.size() << " irrelevant inputs are matched freely, each valid match counts for " <<
+                m_NumOfIrrelevantMatches << " matches" << endl;
+        }
+
+        if (m_PrintMatches && !m_SrcIrrelevantInputs.empty())
+        {
+            cout << "c Src irrelevant inputs:";
+            for (const AIGLIT inputLit : m_SrcIrrelevantInputs)
+            {
+                cout << " " << inputLit;
+            }
+            cout << endl;
+            cout << "c Trg irrelevant inputs:";
+            for (const AIGLIT inputLit : m_TrgIrrelevantInputs)
+            {
+                cout << " " << inputLit;
+            }
+            cout << endl;
+        }
+    }
 }
 
 
@@ -89,6 +132,90 @@ void BoolMatchAlgBase::InitializeFromAIGs(const std::string& srcFileName, const
     ParseAigFile(srcFileName, m_AigParserSrc);
     ParseAigFile(trgFileName, m_AigParserTrg);
 
+    if (m_ReduceToSupport)
+    {
+        ReduceToSupport();
+    }
+
+    InitializeFromParsedAIGs();
+}
+
+void BoolMatchAlgBase::InitializeFromAIGs(const AigerParser& srcAigParser, const AigerParser& trgAigParser)
+{
+    m_AigParserSrc = srcAigParser;
+    m_AigParserTrg = trgAigParser;
+
+    if (m_ReduceToSupport)
+    {
+        ReduceToSupport();
+    }
+
+    InitializeFromParsedAIGs();
+}
+
+void BoolMatchAlgBase::InitializeFromAlg(const BoolMatchAlgBase& otherAlg)
+{
+    m_AigParserSrc = otherAlg.m_AigParserSrc;
+    m_AigParserTrg = otherAlg.m_AigParserTrg;
+
+    m_SrcIrrelevantInputs = otherAlg.m_SrcIrrelevantInputs;
+    m_TrgIrrelevantInputs = otherAlg.m_TrgIrrelevantInputs;
+    m_IsSupportSizeDiff = otherAlg.m_IsSupportSizeDiff;
+    m_NumOfIrrelevantMatches = otherAlg.m_NumOfIrrelevantMatches;
+
+    InitializeFromParsedAIGs();
+}
+
+void BoolMatchAlgBase::ReduceToSupport()
+{
+    const vector<bool> isSrcIrrelevant = BoolMatchInputInvariants(m_InputParser, m_AigParserSrc, BoolMatchInputInvariants::DEF_NUM_OF_THREADS, true).GetIrrelevantInputs();
+    const vector<bool> isTrgIrrelevant = BoolMatchInputInvariants(m_InputParser, m_AigParserTrg, BoolMatchInputInvariants::DEF_NUM_OF_THREADS, true).GetIrrelevantInputs();
+
+    const size_t numOfSrcIrrelevant = count(isSrcIrrelevant.begin(), isSrcIrrelevant.end(), true);
+    const size_t numOfTrgIrrelevant = count(isTrgIrrelevant.begin(), isTrgIrrelevant.end(), true);
+    if (isSrcIrrelevant.size() != isTrgIrrelevant.size())
+    {
+        // the different number of inputs is reported when the inputs are initialized
+        return;
+    }
+    if (numOfSrcIrrelevant != numOfTrgIrrelevant)
+    {
+        // an undecided input is kept in the support, so the sizes may differ only by the timeout
+        m_IsSupportSizeDiff = !m_UseTimeOut;
+        return;
+    }
+
+    // the aiger parser requires at least one input
+    if (numOfSrcIrrelevant == 0 || numOfSrcIrrelevant == isSrcIrrelevant.size())
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < isSrcIrrelevant.size(); i++)
+    {
+        if (isSrcIrrelevant[i])
+        {
+            m_SrcIrrelevantInputs.push_back(m_AigParserSrc.GetInputs()[i]);
+        }
+        if (isTrgIrrelevant[i])
+        {
+            m_TrgIrrelevantInputs.push_back(m_AigParserTrg.GetInputs()[i]);
+        }
+    }
+
+    m_AigParserSrc.RemoveInputs(isSrcIrrelevant);
+    m_AigParserTrg.RemoveInputs(isTrgIrrelevant);
+
+    // every match of the irrelevant inputs, k! and 2^k polarities with negated map
+    for (unsigned long long k = 1; k <= m_SrcIrrelevantInputs.size(); k++)
+    {
+        const unsigned long long mult = m_AllowInputNegMap ? 2 * k : k;
+        m_NumOfIrrelevantMatches = m_NumOfIrrelevantMatches > ULLONG_MAX / mult ? ULLONG_MAX : m_NumOfIrrelevantMatches * mult;
+    }
+}
+
+void BoolMatchAlgBase::InitializeFromParsedAIGs()
+{
     m_SrcInputs = m_AigParserSrc.GetInputs();
     m_TrgInputs = m_AigParserTrg.GetInputs();
 
@@ -114,11 +241,19 @@ void BoolMatchAlgBase::InitializeFromAIGs(const std::string& srcFileName, const
 }
 
 
-void BoolMatchAlgBase::FindAllMatches()
+void BoolMatchAlgBase::FindAllMatches(bool printInitialInformation)
 {
     assert(m_IsInit);
 
-    PrintInitialInformation();
+    if (printInitialInformation)
+    {
+        PrintInitialInformation();
+    }
+
+    if (m_IsSupportSizeDiff)
+    {
+        return;
+    }
 
     try
     {
@@ -139,9 +274,19 @@ void BoolMatchAlgBase::FindAllMatches()
     }
 };
 
+void BoolMatchAlgBase::BlockStopSignals()
+{
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    sigaddset(&stopSignals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+}
+
 void BoolMatchAlgBase::PrintResult(bool wasInterrupted)
 {
-    bool isInterrupted = m_IsTimeOut || wasInterrupted;
+    bool isInterrupted = m_IsTimeOut || wasInterrupted || m_IsStopRequested;
     unsigned long cpu_time =  clock() - m_Clk;
     double Time = (double)(cpu_time)/(double)(CLOCKS_PER_SEC);
     if (isInterrupted)
@@ -152,7 +297,7 @@ void BoolMatchAlgBase::PrintResult(bool wasInterrupted)
     {
         cout << "c Finished solving the problem" << endl;
     }
-    cout << "c Number of valid matches: " << m_NumberOfValidMatches;
+    cout << "c Number of valid matches: " << GetNumOfAllValidMatches(m_NumberOfValidMatches);
     cout << endl;
     cout << "c Total Number of matches iterated: " << m_TotalNumberOfMatches << endl;
     cout << "c Percentage of time spent on generalization: " << m_TimeOnGeneralization/Time;
@@ -234,6 +379,16 @@ void BoolMatchAlgBase::PrintMatrixIndexMatchAsAIG(const MatrixIndexVecMatch& ful
     cout << endl;
 }
 
+unsigned long long BoolMatchAlgBase::GetNumOfAllValidMatches(unsigned long long numOfValidMatches) const
+{
+    if (!IsCountingAllMatches())
+    {
+        return numOfValidMatches;
+    }
+
+    return numOfValidMatches > ULLONG_MAX / m_NumOfIrrelevantMatches ? ULLONG_MAX : numOfValidMatches * m_NumOfIrrelevantMatches;
+}
+
 unsigned BoolMatchAlgBase::GetNumOfDCFromInputAssignment(const INPUT_ASSIGNMENT& assignment) const
 {
     // count number of 1/0 values
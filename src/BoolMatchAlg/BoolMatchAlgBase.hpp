@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <atomic>
 
 #include "Globals/BoolMatchGloblas.hpp"
 #include "Globals/BoolMatchSolverGloblas.hpp"
@@ -25,19 +26,38 @@ class BoolMatchAlgBase
         // call protected function _InitializeFromAIGs which will be implemented in the derived classes
         void InitializeFromAIGs(const std::string& srcFileName, const std::string& trgFileName);
 
+        // intilize with already parsed aiger files for both the src and trg, the parsers are copied
+        void InitializeFromAIGs(const AigerParser& srcAigParser, const AigerParser& trgAigParser);
+
+        // intilize with the parsed aiger files of another algorithm, that were already reduced to their support ("/alg/reduce_to_support")
+        void InitializeFromAlg(const BoolMatchAlgBase& otherAlg);
+
         // find all the boolean matches for the given AIGs 
-        void FindAllMatches();
+        // printInitialInformation - if to print the initial information before the search
+        void FindAllMatches(bool printInitialInformation = true);
 
         virtual void PrintResult(bool wasInterrupted = false);
 
-    protected:
+        // request the search to stop, the matches found so far are kept and the result is printed as interrupted
+        // only sets atomic flags, so it can be called from a signal handler
+        virtual void RequestStop() { m_IsStopRequested = true; };
 
         // print initial information, timeout etc..
         virtual void PrintInitialInformation();
-        
+
+        unsigned long long GetNumberOfValidMatches() const {return m_NumberOfValidMatches;};
+        unsigned long long GetTotalNumberOfMatches() const {return m_TotalNumberOfMatches;};
+        double GetTimeOnGeneralization() const {return m_TimeOnGeneralization;};
+        bool IsTimeOut() const {return m_IsTimeOut;};
+
         // parse aag or aig files
         // initilize either the m_AigParserSrc and m_AigParserTrg
-        void ParseAigFile(const std::string& filename, AigerParser& aigParser);
+        static void ParseAigFile(const std::string& filename, AigerParser& aigParser);
+
+    protected:
+
+        // initialize the inputs from the parsed m_AigParserSrc and m_AigParserTrg and call _InitializeFromAIGs
+        void InitializeFromParsedAIGs();
 
         // handle the initialization after we parse the AIG and init the src and trg inputs
         virtual void _InitializeFromAIGs() = 0;
@@ -45,6 +65,23 @@ class BoolMatchAlgBase
         // handle the main part of the algorithm where we find all the matches
         virtual void _FindAllMatches() = 0;
 
+        // if the search should stop, checked by the search loops
+        virtual bool IsStopRequested() const { return m_IsStopRequested; };
+
+        // block the stop signals (SIGINT, SIGTERM and SIGUSR1) in the calling thread, called by the threads the search creates
+        // so the signals are handled only by the main thread, which joins the threads and prints the result
+        static void BlockStopSignals();
+
+        // if m_NumberOfValidMatches counts all the valid matches, so it is multiplied by the matches of the irrelevant inputs
+        virtual bool IsCountingAllMatches() const { return !m_StopAtFirstValidMatch; };
+
+        // get the number of valid matches of all the inputs from the number of valid matches of the support
+        // NOTE: m_NumberOfValidMatches counts the support only, so it can be saved and summed
+        unsigned long long GetNumOfAllValidMatches(unsigned long long numOfValidMatches) const;
+
+        // remove the inputs the output does not depend on from both circuits, if both have the same number of them
+        void ReduceToSupport();
+
         // print single model for the inputs
         void PrintModel(const INPUT_ASSIGNMENT& model);
         
@@ -74,8 +111,12 @@ class BoolMatchAlgBase
         const double m_TimeOut;
         // if to allow negated map to the inputs
         const bool m_AllowInputNegMap;
+        // if to allow negated map to the output, i.e. enumerate the matches of both the target output and its negation (NPN with m_AllowInputNegMap)
+        const bool m_AllowOutputNegMap;
         // if to stop at first valid match
         const bool m_StopAtFirstValidMatch;
+        // if to match only the inputs the output depends on, the irrelevant inputs are matched freely
+        const bool m_ReduceToSupport;
 		
         // *** Variables ***
         
@@ -85,6 +126,9 @@ class BoolMatchAlgBase
         // if timeout happend
         bool m_IsTimeOut;
 
+        // if RequestStop was called (i.e. by a signal)
+        std::atomic<bool> m_IsStopRequested;
+
         // parser for Aiger files 
         AigerParser m_AigParserSrc;
         AigerParser m_AigParserTrg;
@@ -100,6 +144,12 @@ class BoolMatchAlgBase
         std::unordered_map<AIGLIT, INDEX> srcLit2Indx;
         std::unordered_map<AIGLIT, INDEX> trgLit2Indx;
 
+        // the inputs removed by "/alg/reduce_to_support", every valid match of the support is extended by any match between them
+        std::vector<AIGLIT> m_SrcIrrelevantInputs;
+        std::vector<AIGLIT> m_TrgIrrelevantInputs;
+        // if the src and trg supports have different sizes, so there is no valid match
+        bool m_IsSupportSizeDiff;
+
 		// *** Stats ***
 
 		clock_t m_Clk;
@@ -109,4 +159,6 @@ class BoolMatchAlgBase
         unsigned long long m_NumberOfValidMatches;
         // total number of matches found (valid and invalid)
         unsigned long long m_TotalNumberOfMatches;
+        // the number of matches between the irrelevant inputs, k! or k!*2^k with negated map (saturated)
+        unsigned long long m_NumOfIrrelevantMatches;
 };
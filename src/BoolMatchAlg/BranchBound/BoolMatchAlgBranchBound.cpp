@@ -0,0 +1,212 @@
+#include "BoolMatchAlg/BranchBound/BoolMatchAlgBranchBound.hpp"
+
+#include <cmath>
+
+using namespace std;
+
+BoolMatchAlgBranchBound::BoolMatchAlgBranchBound(const InputParser& inputParser):
+BoolMatchAlgBase(inputParser),
+// default is false
+m_UseIpasir(inputParser.getBoolCmdOption("/alg/bnb/use_ipasir", false)),
+// default is 1, i.e. every partial match is checked
+m_MinCheckDepth(inputParser.getUintCmdOption("/alg/bnb/min_check_depth", 1)),
+m_DRSolver(nullptr),
+m_NumOfPartialChecks(0),
+m_NumOfPrunedSubtrees(0),
+m_NumOfPrunedMatches(0)
+{
+    if (m_AllowOutputNegMap)
+    {
+        throw runtime_error("Negated map to the output is not supported by the branch and bound algorithm");
+    }
+
+    if (m_UseIpasir)
+    {
+        m_DRSolver = new BoolMatchSolverIpasir(inputParser, CirEncoding::DUALRAIL_ENC, false);
+    }
+    else
+    {
+        m_DRSolver = new BoolMatchSolverTopor(inputParser, CirEncoding::DUALRAIL_ENC, false);
+    }
+}
+
+BoolMatchAlgBranchBound::~BoolMatchAlgBranchBound()
+{
+    delete m_DRSolver;
+}
+
+void BoolMatchAlgBranchBound::PrintInitialInformation()
+{
+    BoolMatchAlgBase::PrintInitialInformation();
+
+    cout << "c Use branch and bound over partial matches with dual-rail encoding" << endl;
+    cout << "c Check partial matches from depth " << m_MinCheckDepth << endl;
+}
+
+void BoolMatchAlgBranchBound::PrintResult(bool wasInterrupted)
+{
+    BoolMatchAlgBase::PrintResult(wasInterrupted);
+
+    cout << "c Partial matches checked: " << m_NumOfPartialChecks << ", pruned subtrees: " << m_NumOfPrunedSubtrees << ", pruned matches: " << m_NumOfPrunedMatches << endl;
+}
+
+void BoolMatchAlgBranchBound::_InitializeFromAIGs()
+{
+    m_DRSolver->InitializeSolverFromAIG(m_AigParserSrc, m_AigParserTrg);
+}
+
+void BoolMatchAlgBranchBound::_FindAllMatches()
+{
+    SOLVER_RET_STATUS res = m_DRSolver->Solve();
+
+    if (res == TIMEOUT_RET_STATUS)
+    {
+        m_IsTimeOut = true;
+        throw runtime_error("Timeout reached");
+    }
+
+    if (res != SAT_RET_STATUS)
+    {
+        throw runtime_error("Initial model is not satisfiable. Please verify the logic model of the cells are correct.");
+    }
+
+    // assert mitter on the circuit outputs
+    m_DRSolver->AssertOutputDiff(false);
+
+    MatrixIndexVecMatch partialMatch;
+    partialMatch.reserve(m_InputSize);
+    vector<bool> isTrgUsed(m_InputSize, false);
+
+    ExtendPartialMatch(partialMatch, isTrgUsed);
+}
+
+bool BoolMatchAlgBranchBound::ExtendPartialMatch(MatrixIndexVecMatch& partialMatch, vector<bool>& isTrgUsed)
+{
+    if (IsStopRequested())
+    {
+        return false;
+    }
+
+    if (partialMatch.size() >= m_MinCheckDepth || partialMatch.size() == m_InputSize)
+    {
+        if (partialMatch.size() == m_InputSize)
+        {
+            m_TotalNumberOfMatches++;
+        }
+
+        if (!CheckPartialMatch(partialMatch, isTrgUsed))
+        {
+            m_NumOfPrunedSubtrees++;
+            m_NumOfPrunedMatches += GetNumOfCompletions(partialMatch.size());
+            return true;
+        }
+    }
+
+    if (partialMatch.size() == m_InputSize)
+    {
+        m_NumberOfValidMatches++;
+        if (m_PrintMatches)
+        {
+            PrintMatrixIndexMatchAsAIG(partialMatch);
+        }
+
+        return !m_StopAtFirstValidMatch;
+    }
+
+    // the matrix indices are 1-based
+    const int srcIndex = (int)partialMatch.size() + 1;
+    for (size_t trgIndex = 0; trgIndex < m_InputSize; trgIndex++)
+    {
+        if (isTrgUsed[trgIndex])
+        {
+            continue;
+        }
+
+        isTrgUsed[trgIndex] = true;
+        for (int trgSign : {1, -1})
+        {
+            if (trgSign < 0 && !m_AllowInputNegMap)
+            {
+                continue;
+            }
+
+            partialMatch.push_back({srcIndex, trgSign * ((int)trgIndex + 1)});
+            bool toContinue = ExtendPartialMatch(partialMatch, isTrgUsed);
+            partialMatch.pop_back();
+
+            if (!toContinue)
+            {
+                return false;
+            }
+        }
+        isTrgUsed[trgIndex] = false;
+    }
+
+    return true;
+}
+
+bool BoolMatchAlgBranchBound::CheckPartialMatch(const MatrixIndexVecMatch& partialMatch, const vector<bool>& isTrgUsed)
+{
+    m_NumOfPartialChecks++;
+
+    vector<SATLIT> assump;
+    assump.reserve(partialMatch.size() + 4 * (m_InputSize - partialMatch.size()));
+
+    // X==X is 1, so an input the solver sets to X on both sides is still a valid assignment of the match
+    for (const MatrixIndexMatch& match : partialMatch)
+    {
+        AIGLIT srcLit = m_SrcInputs[GetAbsRealIndex(match.first)];
+        AIGLIT trgLit = m_TrgInputs[GetAbsRealIndex(match.second)];
+
+        assump.push_back(m_DRSolver->GetInputWeakEqAssmp(srcLit, trgLit, IsMatchPos(match)));
+    }
+
+    // the src inputs are mapped in order, so the unmapped ones are the rest
+    for (size_t srcIndex = partialMatch.size(); srcIndex < m_InputSize; srcIndex++)
+    {
+        vector<SATLIT> dcAssump = m_DRSolver->GetInputDCAssmp(m_SrcInputs[srcIndex], true);
+        assump.insert(assump.end(), dcAssump.begin(), dcAssump.end());
+    }
+
+    for (size_t trgIndex = 0; trgIndex < m_InputSize; trgIndex++)
+    {
+        if (!isTrgUsed[trgIndex])
+        {
+            vector<SATLIT> dcAssump = m_DRSolver->GetInputDCAssmp(m_TrgInputs[trgIndex], false);
+            assump.insert(assump.end(), dcAssump.begin(), dcAssump.end());
+        }
+    }
+
+    SOLVER_RET_STATUS res = m_DRSolver->SolveUnderAssump(assump);
+
+    if (res == UNSAT_RET_STATUS)
+    { // no counterexample under the partial match
+        return true;
+    }
+    else if (res == SAT_RET_STATUS)
+    { // the counterexample holds for every completion of the partial match
+        return false;
+    }
+    else if (res == TIMEOUT_RET_STATUS)
+    {
+        m_IsTimeOut = true;
+        throw runtime_error("Timeout reached");
+    }
+    else
+    { // in case of an error etc..
+        throw runtime_error("Solver return err status");
+    }
+}
+
+double BoolMatchAlgBranchBound::GetNumOfCompletions(size_t partialMatchSize) const
+{
+    const size_t numOfUnmapped = m_InputSize - partialMatchSize;
+
+    double numOfCompletions = tgamma((double)numOfUnmapped + 1);
+    if (m_AllowInputNegMap)
+    {
+        numOfCompletions *= pow(2.0, (double)numOfUnmapped);
+    }
+
+    return numOfCompletions;
+}
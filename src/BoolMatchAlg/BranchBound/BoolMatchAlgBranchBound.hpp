@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+#include "BoolMatchAlg/BoolMatchAlgBase.hpp"
+#include "BoolMatchSolver/Solvers.hpp"
+
+/*
+    boolean matching by DFS over the partial matches (branch and bound)
+    the src inputs are mapped one at a time, and every partial match is checked against a dual-rail mitter
+    the mapped inputs are assumed weakly equal and the unmapped inputs are X, so a counterexample holds for every completion
+    in this case the whole subtree of the partial match is pruned, a full match without counterexample is valid
+*/
+class BoolMatchAlgBranchBound : public BoolMatchAlgBase
+{
+    public:
+
+        BoolMatchAlgBranchBound(const InputParser& inputParser);
+
+        virtual ~BoolMatchAlgBranchBound();
+
+        void PrintResult(bool wasInterrupted = false) override;
+
+        // print initial information, timeout etc..
+        void PrintInitialInformation() override;
+
+    protected:
+
+        void _InitializeFromAIGs() override;
+
+        void _FindAllMatches() override;
+
+        // extend the partial match with the next src input
+        // return false if the search should stop
+        bool ExtendPartialMatch(MatrixIndexVecMatch& partialMatch, std::vector<bool>& isTrgUsed);
+
+        // return true if the partial match has no counterexample where the unmapped inputs are X
+        bool CheckPartialMatch(const MatrixIndexVecMatch& partialMatch, const std::vector<bool>& isTrgUsed);
+
+        // the number of full matches that complete a partial match of the given size
+        double GetNumOfCompletions(size_t partialMatchSize) const;
+
+        // *** Params ***
+
+        // if to use ipasir for the dual-rail solver
+        const bool m_UseIpasir;
+        // partial matches smaller than this are not checked, since they rarely have a counterexample
+        const unsigned m_MinCheckDepth;
+
+        // *** Variables ***
+
+        // the dual-rail solver with the mitter on the outputs
+        BoolMatchSolverBase* m_DRSolver;
+
+		// *** Stats ***
+
+        // number of partial matches checked
+        unsigned long long m_NumOfPartialChecks;
+        // number of subtrees pruned
+        unsigned long long m_NumOfPrunedSubtrees;
+        // number of full matches in the pruned subtrees
+        double m_NumOfPrunedMatches;
+};
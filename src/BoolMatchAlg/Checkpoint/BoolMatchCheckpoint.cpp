@@ -0,0 +1,223 @@
+#include "BoolMatchAlg/Checkpoint/BoolMatchCheckpoint.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+using namespace std;
+
+// the first line of every checkpoint file
+static const string CHECKPOINT_HEADER = "c boolmatch checkpoint";
+
+// write the assignment as "<size> <index> <value> .."
+static void WriteIndxAssignment(ostream& out, const MULT_INDX_ASSIGNMENT& assignment)
+{
+    out << " " << assignment.size();
+    for (const INDX_ASSIGNMENT& assign : assignment)
+    {
+        out << " " << GetIndFromAssg(assign) << " " << (unsigned)GetValFromAssg(assign);
+    }
+}
+
+static MULT_INDX_ASSIGNMENT ReadIndxAssignment(istream& in)
+{
+    size_t size = 0;
+    in >> size;
+
+    MULT_INDX_ASSIGNMENT assignment(size);
+    for (INDX_ASSIGNMENT& assign : assignment)
+    {
+        unsigned val = 0;
+        in >> assign.first >> val;
+        assign.second = (TVal)val;
+    }
+
+    return assignment;
+}
+
+// write the match as "<size> <src> <trg> .."
+static void WriteMatch(ostream& out, const MatrixIndexVecMatch& match)
+{
+    out << " " << match.size();
+    for (const MatrixIndexMatch& singleMatch : match)
+    {
+        out << " " << singleMatch.first << " " << singleMatch.second;
+    }
+}
+
+static MatrixIndexVecMatch ReadMatch(istream& in)
+{
+    size_t size = 0;
+    in >> size;
+
+    MatrixIndexVecMatch match(size);
+    for (MatrixIndexMatch& singleMatch : match)
+    {
+        in >> singleMatch.first >> singleMatch.second;
+    }
+
+    return match;
+}
+
+
+BoolMatchCheckpoint::BoolMatchCheckpoint(const string& paramsConfig, const string& circuitsConfig):
+m_ParamsConfig(paramsConfig),
+m_CircuitsConfig(circuitsConfig),
+m_TotalNumOfMatches(0)
+{
+}
+
+void BoolMatchCheckpoint::AddWitness(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues)
+{
+    m_Witnesses.emplace_back(srcValues, trgValues);
+}
+
+void BoolMatchCheckpoint::AddValidMatch(const MatrixIndexVecMatch& match, unsigned long long numOfValidMatches, bool isDisjointCube)
+{
+    m_ValidMatches.emplace_back(match, numOfValidMatches, isDisjointCube);
+}
+
+vector<MatrixIndexVecMatch> BoolMatchCheckpoint::GetValidMatches() const
+{
+    vector<MatrixIndexVecMatch> validMatches;
+    for (const auto& [match, numOfValidMatches, isDisjointCube] : m_ValidMatches)
+    {
+        validMatches.push_back(match);
+    }
+    return validMatches;
+}
+
+vector<MatrixIndexVecMatch> BoolMatchCheckpoint::GetValidMatchCubes() const
+{
+    vector<MatrixIndexVecMatch> validMatchCubes;
+    for (const auto& [match, numOfValidMatches, isDisjointCube] : m_ValidMatches)
+    {
+        if (isDisjointCube)
+        {
+            validMatchCubes.push_back(match);
+        }
+    }
+    return validMatchCubes;
+}
+
+unsigned long long BoolMatchCheckpoint::GetNumOfValidMatches() const
+{
+    unsigned long long numOfAllValidMatches = 0;
+    for (const auto& [match, numOfValidMatches, isDisjointCube] : m_ValidMatches)
+    {
+        numOfAllValidMatches += numOfValidMatches;
+    }
+    return numOfAllValidMatches;
+}
+
+void BoolMatchCheckpoint::Save(const string& fileName, unsigned long long totalNumOfMatches) const
+{
+    const string tmpFileName = fileName + ".tmp";
+    {
+        ofstream out(tmpFileName);
+        if (!out)
+        {
+            throw runtime_error("Failed to open the checkpoint file " + tmpFileName);
+        }
+
+        out << CHECKPOINT_HEADER << "\n";
+        out << "p " << m_ParamsConfig << "\n";
+        out << "n " << m_CircuitsConfig << "\n";
+        out << "s " << GetNumOfValidMatches() << " " << totalNumOfMatches << "\n";
+
+        for (const pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>& witness : m_Witnesses)
+        {
+            out << "w";
+            WriteIndxAssignment(out, witness.first);
+            WriteIndxAssignment(out, witness.second);
+            out << "\n";
+        }
+
+        // "v <num> <match>" for a valid match and "e <num> <cube>" for a disjoint valid cube, where num is the number of valid matches it count
+        for (const auto& [match, numOfValidMatches, isDisjointCube] : m_ValidMatches)
+        {
+            out << (isDisjointCube ? "e " : "v ") << numOfValidMatches;
+            WriteMatch(out, match);
+            out << "\n";
+        }
+
+        if (!out.flush())
+        {
+            throw runtime_error("Failed to write the checkpoint file " + tmpFileName);
+        }
+    }
+
+    if (rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+    {
+        throw runtime_error("Failed to replace the checkpoint file " + fileName);
+    }
+}
+
+void BoolMatchCheckpoint::Load(const string& fileName, bool checkCircuits)
+{
+    ifstream in(fileName);
+    if (!in)
+    {
+        throw runtime_error("Failed to open the checkpoint file " + fileName);
+    }
+
+    string line;
+    if (!getline(in, line) || line != CHECKPOINT_HEADER)
+    {
+        throw runtime_error("Not a checkpoint file " + fileName);
+    }
+
+    if (!getline(in, line) || line != "p " + m_ParamsConfig)
+    {
+        throw runtime_error("The checkpoint " + fileName + " was saved for different parameters");
+    }
+
+    if (!getline(in, line) || (checkCircuits && line != "n " + m_CircuitsConfig))
+    {
+        throw runtime_error("The checkpoint " + fileName + " was saved for different circuits");
+    }
+
+    unsigned long long numOfValidMatches = 0;
+    while (getline(in, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        istringstream lineStream(line.substr(1));
+        switch (line[0])
+        {
+            case 's':
+                lineStream >> numOfValidMatches >> m_TotalNumOfMatches;
+                break;
+            case 'w':
+            {
+                MULT_INDX_ASSIGNMENT srcValues = ReadIndxAssignment(lineStream);
+                MULT_INDX_ASSIGNMENT trgValues = ReadIndxAssignment(lineStream);
+                m_Witnesses.emplace_back(srcValues, trgValues);
+                break;
+            }
+            case 'v':
+            case 'e':
+            {
+                unsigned long long numOfMatchValidMatches = 0;
+                lineStream >> numOfMatchValidMatches;
+                m_ValidMatches.emplace_back(ReadMatch(lineStream), numOfMatchValidMatches, line[0] == 'e');
+                break;
+            }
+            default:
+                throw runtime_error("Unknown line in the checkpoint file " + fileName);
+        }
+
+        if (lineStream.fail())
+        {
+            throw runtime_error("Corrupted line in the checkpoint file " + fileName);
+        }
+    }
+
+    if (numOfValidMatches != GetNumOfValidMatches())
+    {
+        throw runtime_error("The number of valid matches in the checkpoint file " + fileName + " does not agree with its valid matches");
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <tuple>
+
+#include "Globals/BoolMatchGloblas.hpp"
+#include "Globals/BoolMatchSolverGloblas.hpp"
+
+/*
+    the enumeration state kept by "/general/checkpoint <file>" and loaded by "/general/resume <file>"
+    hold the (generalized) witnesses of the non-valid matches, the eliminated valid matches (or the disjoint valid cubes of the exact count) and the counters
+    every valid match is kept with the number of valid matches it count, so the saved counter always agrees with the saved matches
+    the state is replayed on resume by blocking the witnesses and eliminating the valid matches again, so the blocking clauses are not saved as is
+    the config holds the parameters that change the state and the circuits sizes, a checkpoint of a different config can not be resumed
+    in ECO mode ("/general/eco <file>") only the parameters must be the same, since the circuits were changed and every item is checked again
+*/
+class BoolMatchCheckpoint
+{
+    public:
+
+        // paramsConfig - the parameters that change the state, circuitsConfig - the sizes of the circuits
+        BoolMatchCheckpoint(const std::string& paramsConfig, const std::string& circuitsConfig);
+
+        // add the inputs values of a non-valid match witness
+        void AddWitness(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues);
+
+        // add a (partial) valid match that was eliminated, where numOfValidMatches is the number of valid matches it count
+        // isDisjointCube - if the match is a disjoint valid cube of the exact count
+        void AddValidMatch(const MatrixIndexVecMatch& match, unsigned long long numOfValidMatches, bool isDisjointCube);
+
+        // save the state with the given number of iterated matches into fileName
+        // the number of valid matches is the sum over the kept valid matches
+        // the file is replaced at once, so a run stopped while saving keeps the previous checkpoint
+        void Save(const std::string& fileName, unsigned long long totalNumOfMatches) const;
+
+        // load the state from fileName, throw if the file is not a checkpoint of the same config
+        // checkCircuits - if the circuits must also be the same, otherwise only the parameters are checked
+        void Load(const std::string& fileName, bool checkCircuits = true);
+
+        const std::vector<std::pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>>& GetWitnesses() const {return m_Witnesses;};
+        // all the eliminated valid matches, including the disjoint valid cubes
+        std::vector<MatrixIndexVecMatch> GetValidMatches() const;
+        std::vector<MatrixIndexVecMatch> GetValidMatchCubes() const;
+        size_t GetNumOfValidMatchRecords() const {return m_ValidMatches.size();};
+        unsigned long long GetNumOfValidMatches() const;
+        unsigned long long GetTotalNumOfMatches() const {return m_TotalNumOfMatches;};
+
+    protected:
+
+        // *** Params ***
+
+        const std::string m_ParamsConfig;
+        const std::string m_CircuitsConfig;
+
+        // *** Variables ***
+
+        std::vector<std::pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>> m_Witnesses;
+        // the valid matches in the form of <match, number of valid matches it count, if it is a disjoint valid cube>
+        std::vector<std::tuple<MatrixIndexVecMatch, unsigned long long, bool>> m_ValidMatches;
+
+        // the loaded counter
+        unsigned long long m_TotalNumOfMatches;
+};
@@ -0,0 +1,103 @@
+#include "BoolMatchAlg/Checkpoint/BoolMatchEcoFilter.hpp"
+
+using namespace std;
+
+BoolMatchEcoFilter::BoolMatchEcoFilter(const InputParser& inputParser, const AigerParser& srcAig, const AigerParser& trgAig):
+m_SrcInputs(srcAig.GetInputs()),
+m_TrgInputs(trgAig.GetInputs()),
+m_SrcBitSim(srcAig),
+m_TrgBitSim(trgAig),
+m_SrcInputsVal(m_SrcInputs.size()),
+m_TrgInputsVal(m_TrgInputs.size()),
+m_RandGen(0),
+m_EqSolver(inputParser, CirEncoding::TSEITIN_ENC, true),
+m_DiffSolver(inputParser, CirEncoding::TSEITIN_ENC, false)
+{
+    m_EqSolver.InitializeSolverFromAIG(srcAig, trgAig);
+    m_EqSolver.AssertOutputDiff(true);
+
+    m_DiffSolver.InitializeSolverFromAIG(srcAig, trgAig);
+    m_DiffSolver.AssertOutputDiff(false);
+}
+
+bool BoolMatchEcoFilter::IsWitnessKept(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues)
+{
+    // first try to refute the witness by simulation, where the inputs without values are random
+    RandomizeInputsVal();
+
+    vector<SATLIT> assump;
+    auto applyValues = [&](const MULT_INDX_ASSIGNMENT& values, vector<uint64_t>& inputsVal, const vector<AIGLIT>& inputs, bool isSrc)
+    {
+        for (const INDX_ASSIGNMENT& assign : values)
+        {
+            if (!IsTValBoolVal(GetValFromAssg(assign)))
+            {
+                continue;
+            }
+
+            const bool isTrue = GetValFromAssg(assign) == TVal::True;
+            inputsVal[GetIndFromAssg(assign)] = isTrue ? ~0ULL : 0;
+
+            SATLIT lit = m_EqSolver.GetLitsFromAIGInputs({inputs[GetIndFromAssg(assign)]}, isSrc)[0];
+            assump.push_back(isTrue ? lit : NegateSATLit(lit));
+        }
+    };
+    applyValues(srcValues, m_SrcInputsVal, m_SrcInputs, true);
+    applyValues(trgValues, m_TrgInputsVal, m_TrgInputs, false);
+
+    if (m_SrcBitSim.SimulateOutput(m_SrcInputsVal) != ~m_TrgBitSim.SimulateOutput(m_TrgInputsVal))
+    {
+        return false;
+    }
+
+    return IsUnsatUnderAssump(m_EqSolver, assump);
+}
+
+bool BoolMatchEcoFilter::IsValidMatchKept(const MatrixIndexVecMatch& match)
+{
+    // first try to refute the match by simulation, where the unmatched inputs are random
+    RandomizeInputsVal();
+    for (const MatrixIndexMatch& singleMatch : match)
+    {
+        uint64_t srcVal = m_SrcInputsVal[GetAbsRealIndex(singleMatch.first)];
+        m_TrgInputsVal[GetAbsRealIndex(singleMatch.second)] = IsMatchPos(singleMatch) ? srcVal : ~srcVal;
+    }
+
+    if (m_SrcBitSim.SimulateOutput(m_SrcInputsVal) != m_TrgBitSim.SimulateOutput(m_TrgInputsVal))
+    {
+        return false;
+    }
+
+    vector<SATLIT> assump;
+    for (const MatrixIndexMatch& singleMatch : match)
+    {
+        assump.push_back(m_DiffSolver.GetInputEqAssmp(m_SrcInputs[GetAbsRealIndex(singleMatch.first)], m_TrgInputs[GetAbsRealIndex(singleMatch.second)], IsMatchPos(singleMatch)));
+    }
+
+    return IsUnsatUnderAssump(m_DiffSolver, assump);
+}
+
+bool BoolMatchEcoFilter::IsUnsatUnderAssump(BoolMatchSolverBase& solver, vector<SATLIT>& assump)
+{
+    SOLVER_RET_STATUS res = solver.SolveUnderAssump(assump);
+
+    if (res == TIMEOUT_RET_STATUS)
+    {
+        throw runtime_error("Timeout reached");
+    }
+    if (res != UNSAT_RET_STATUS && res != SAT_RET_STATUS)
+    {
+        throw runtime_error("Solver return err status");
+    }
+
+    return res == UNSAT_RET_STATUS;
+}
+
+void BoolMatchEcoFilter::RandomizeInputsVal()
+{
+    for (size_t i = 0; i < m_SrcInputsVal.size(); i++)
+    {
+        m_SrcInputsVal[i] = m_RandGen();
+        m_TrgInputsVal[i] = m_RandGen();
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "Globals/BoolMatchGloblas.hpp"
+#include "Aiger/AigerParser.hpp"
+#include "Utilities/InputParser.hpp"
+#include "CirSimulation/CirBitSim.hpp"
+#include "BoolMatchSolver/Solvers.hpp"
+
+/*
+    check the witnesses and valid matches of a checkpoint of a previous run on slightly different circuits (ECO, "/general/eco <file>")
+    every item is checked on the current circuits, first by bit-parallel simulation with random values for the free inputs and then by a SAT call
+    a witness holds if the outputs can not be equal under its inputs values, and a valid match holds if the outputs can not differ under the match
+*/
+class BoolMatchEcoFilter
+{
+    public:
+
+        BoolMatchEcoFilter(const InputParser& inputParser, const AigerParser& srcAig, const AigerParser& trgAig);
+
+        // return true if the witness still holds on the current circuits
+        bool IsWitnessKept(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues);
+
+        // return true if the (partial) valid match still holds on the current circuits
+        bool IsValidMatchKept(const MatrixIndexVecMatch& match);
+
+    protected:
+
+        // return true if the solver is UNSAT under the assumption, throw on timeout
+        static bool IsUnsatUnderAssump(BoolMatchSolverBase& solver, std::vector<SATLIT>& assump);
+
+        // get random values for every src and trg input
+        void RandomizeInputsVal();
+
+        // *** Params ***
+
+        const std::vector<AIGLIT> m_SrcInputs;
+        const std::vector<AIGLIT> m_TrgInputs;
+
+        // *** Variables ***
+
+        CirBitSim m_SrcBitSim;
+        CirBitSim m_TrgBitSim;
+        // the values of the src and trg inputs for the simulation
+        std::vector<uint64_t> m_SrcInputsVal;
+        std::vector<uint64_t> m_TrgInputsVal;
+        // the same patterns in every run
+        std::mt19937_64 m_RandGen;
+
+        // the solver where the outputs are equal, for the witnesses
+        BoolMatchSolverTopor m_EqSolver;
+        // the solver where the outputs differ, for the valid matches
+        BoolMatchSolverTopor m_DiffSolver;
+};
@@ -0,0 +1,212 @@
+#include "BoolMatchAlg/ExactCount/BoolMatchValidCubes.hpp"
+
+#include <bit>
+#include <climits>
+#include <stdexcept>
+
+using namespace std;
+
+BoolMatchValidCubes::BoolMatchValidCubes(size_t inputSize, bool allowInputNegMap, const MatrixIndexVecMatch& feasibleMatches):
+m_InputSize(inputSize),
+m_AllowInputNegMap(allowInputNegMap),
+m_IsAllFeasible(feasibleMatches.empty()),
+m_NumOfNarrowedCubes(0)
+{
+    if (m_IsAllFeasible)
+    {
+        return;
+    }
+
+    m_NumOfPolarities.assign(m_InputSize, vector<unsigned>(m_InputSize, 0));
+    for (const MatrixIndexMatch& feasibleMatch : feasibleMatches)
+    {
+        if (IsMatchPos(feasibleMatch) || m_AllowInputNegMap)
+        {
+            m_NumOfPolarities[GetAbsRealIndex(feasibleMatch.first)][GetAbsRealIndex(feasibleMatch.second)]++;
+        }
+    }
+}
+
+MatrixIndexVecMatch BoolMatchValidCubes::AddDisjointCube(const MatrixIndexVecMatch& partialMatch, const MatrixIndexVecMatch& fullMatch, const MatrixIndexVecMatch& workCube)
+{
+    // the (signed) trg index of each src input in the full match
+    vector<int> fullTrgOfSrc(m_InputSize, 0);
+    for (const MatrixIndexMatch& singleMatch : fullMatch)
+    {
+        fullTrgOfSrc[GetAbsRealIndex(singleMatch.first)] = singleMatch.second;
+    }
+
+    MatrixIndexVecMatch cube = partialMatch;
+
+    // the (signed) trg index of each src input and the src index of each trg input in the cube, 0 if not matched
+    vector<int> cubeTrgOfSrc(m_InputSize, 0);
+    vector<int> cubeSrcOfTrg(m_InputSize, 0);
+    auto addToCube = [&](const MatrixIndexMatch& singleMatch)
+    {
+        cubeTrgOfSrc[GetAbsRealIndex(singleMatch.first)] = singleMatch.second;
+        cubeSrcOfTrg[GetAbsRealIndex(singleMatch.second)] = singleMatch.first;
+    };
+
+    for (const MatrixIndexMatch& singleMatch : cube)
+    {
+        addToCube(singleMatch);
+    }
+
+    // in a parallel run the other workers count the matches outside of the work cube
+    // NOTE: the full match is in the work cube, so the work cube does not conflict with the partial match
+    for (const MatrixIndexMatch& singleMatch : workCube)
+    {
+        if (cubeTrgOfSrc[GetAbsRealIndex(singleMatch.first)] == 0)
+        {
+            cube.push_back(singleMatch);
+            addToCube(singleMatch);
+        }
+    }
+
+    // two cubes intersect iff their matches do not conflict on any src or trg input
+    auto isIntersect = [&](const MatrixIndexVecMatch& otherCube) -> bool
+    {
+        for (const MatrixIndexMatch& singleMatch : otherCube)
+        {
+            int trgOfSrc = cubeTrgOfSrc[GetAbsRealIndex(singleMatch.first)];
+            int srcOfTrg = cubeSrcOfTrg[GetAbsRealIndex(singleMatch.second)];
+            if ((trgOfSrc != 0 && trgOfSrc != singleMatch.second) || (srcOfTrg != 0 && srcOfTrg != singleMatch.first))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (const MatrixIndexVecMatch& prevCube : m_Cubes)
+    {
+        if (!isIntersect(prevCube))
+        {
+            continue;
+        }
+
+        // the full match is not in the previous cube (it was eliminated), so it conflicts with some match of the previous cube
+        // add the conflicting match of the full match, the cube is still a sub match of the full match
+        bool foundConflict = false;
+        for (const MatrixIndexMatch& singleMatch : prevCube)
+        {
+            int fullTrg = fullTrgOfSrc[GetAbsRealIndex(singleMatch.first)];
+            if (fullTrg != singleMatch.second)
+            {
+                MatrixIndexMatch conflictMatch = {singleMatch.first, fullTrg};
+                cube.push_back(conflictMatch);
+                addToCube(conflictMatch);
+                foundConflict = true;
+                break;
+            }
+        }
+
+        if (!foundConflict)
+        {
+            throw runtime_error("Valid match is already counted in a previous cube");
+        }
+    }
+
+    // with non-feasible matches the completions are counted by the permanent, which is exponential in the unmatched inputs
+    // so the cube is narrowed by more matches of the full match, the narrowed cube is still valid and disjoint and the rest is found later
+    if (!m_IsAllFeasible && m_InputSize - cube.size() > MAX_UNMATCHED_INPUTS_FOR_PERMANENT)
+    {
+        for (const MatrixIndexMatch& singleMatch : fullMatch)
+        {
+            if (m_InputSize - cube.size() <= MAX_UNMATCHED_INPUTS_FOR_PERMANENT)
+            {
+                break;
+            }
+            if (cubeTrgOfSrc[GetAbsRealIndex(singleMatch.first)] == 0)
+            {
+                cube.push_back(singleMatch);
+                addToCube(singleMatch);
+            }
+        }
+        m_NumOfNarrowedCubes++;
+    }
+
+    m_Cubes.push_back(cube);
+
+    return cube;
+}
+
+unsigned long long BoolMatchValidCubes::GetNumOfCompletions(const MatrixIndexVecMatch& cube) const
+{
+    // add and multiply with saturation, the count is not expected to reach the max value
+    auto addSat = [](unsigned long long a, unsigned long long b) -> unsigned long long
+    {
+        return a > ULLONG_MAX - b ? ULLONG_MAX : a + b;
+    };
+    auto mulSat = [](unsigned long long a, unsigned long long b) -> unsigned long long
+    {
+        return (b != 0 && a > ULLONG_MAX / b) ? ULLONG_MAX : a * b;
+    };
+
+    const size_t numOfUnmatched = m_InputSize - cube.size();
+
+    if (m_IsAllFeasible)
+    {
+        // every completion is feasible, any permutation of the unmatched inputs with any polarity (if negated map is allowed)
+        unsigned long long numOfCompletions = 1;
+        for (size_t i = 2; i <= numOfUnmatched; i++)
+        {
+            numOfCompletions = mulSat(numOfCompletions, i);
+        }
+        if (m_AllowInputNegMap)
+        {
+            for (size_t i = 0; i < numOfUnmatched; i++)
+            {
+                numOfCompletions = mulSat(numOfCompletions, 2);
+            }
+        }
+        return numOfCompletions;
+    }
+
+    // the cubes are narrowed by AddDisjointCube
+    if (numOfUnmatched > MAX_UNMATCHED_INPUTS_FOR_PERMANENT)
+    {
+        throw runtime_error("Too many unmatched inputs for counting the completions of a valid match cube");
+    }
+
+    vector<bool> isSrcMatched(m_InputSize, false);
+    vector<bool> isTrgMatched(m_InputSize, false);
+    for (const MatrixIndexMatch& singleMatch : cube)
+    {
+        isSrcMatched[GetAbsRealIndex(singleMatch.first)] = true;
+        isTrgMatched[GetAbsRealIndex(singleMatch.second)] = true;
+    }
+
+    vector<size_t> unmatchedSrc;
+    vector<size_t> unmatchedTrg;
+    for (size_t i = 0; i < m_InputSize; i++)
+    {
+        if (!isSrcMatched[i]) unmatchedSrc.push_back(i);
+        if (!isTrgMatched[i]) unmatchedTrg.push_back(i);
+    }
+
+    // permanent by dynamic programming over the subsets of the unmatched trg inputs
+    // numOfMatches[mask] is the number of feasible matches of the first |mask| unmatched src inputs to the trg inputs in mask
+    vector<unsigned long long> numOfMatches((size_t)1 << numOfUnmatched, 0);
+    numOfMatches[0] = 1;
+    for (size_t mask = 0; mask < numOfMatches.size(); mask++)
+    {
+        size_t row = (size_t)popcount(mask);
+        if (numOfMatches[mask] == 0 || row == numOfUnmatched)
+        {
+            continue;
+        }
+
+        for (size_t col = 0; col < numOfUnmatched; col++)
+        {
+            unsigned polarities = m_NumOfPolarities[unmatchedSrc[row]][unmatchedTrg[col]];
+            if ((mask & ((size_t)1 << col)) == 0 && polarities > 0)
+            {
+                unsigned long long& next = numOfMatches[mask | ((size_t)1 << col)];
+                next = addSat(next, mulSat(numOfMatches[mask], polarities));
+            }
+        }
+    }
+
+    return numOfMatches.back();
+}
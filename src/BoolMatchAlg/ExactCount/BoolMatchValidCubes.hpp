@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+
+#include "Globals/BoolMatchGloblas.hpp"
+
+/*
+    the disjoint cubes (partial matches) of valid matches of the exact count ("/alg/exact_count")
+    every partial valid match is extended to a cube that is disjoint from all the previous cubes, so each valid match is counted by exactly one cube
+    the valid matches of a cube are its feasible completions to a full match, any permutation of the unmatched inputs when every match is feasible
+    and otherwise the permanent of the feasible matches of the unmatched inputs
+*/
+class BoolMatchValidCubes
+{
+    public:
+
+        // feasibleMatches - the matches left by the fixed and forbidden matches, empty means all the matches are feasible
+        BoolMatchValidCubes(size_t inputSize, bool allowInputNegMap, const MatrixIndexVecMatch& feasibleMatches);
+
+        // get a cube of valid matches that is disjoint from all the previous cubes and add it
+        // partialMatch is a partial valid match (all its completions are valid) and fullMatch is a completion of it that is not in any previous cube
+        // the cube extends partialMatch with a match of fullMatch for every previous cube that intersects it, and with the work cube of a parallel run
+        // a cube with more than MAX_UNMATCHED_INPUTS_FOR_PERMANENT unmatched inputs and non-feasible matches is extended with matches of fullMatch
+        MatrixIndexVecMatch AddDisjointCube(const MatrixIndexVecMatch& partialMatch, const MatrixIndexVecMatch& fullMatch, const MatrixIndexVecMatch& workCube);
+
+        // add a cube that is known to be disjoint, from a checkpoint
+        void AddCube(const MatrixIndexVecMatch& cube) { m_Cubes.push_back(cube); };
+
+        // get the number of feasible completions of the cube to a full match
+        unsigned long long GetNumOfCompletions(const MatrixIndexVecMatch& cube) const;
+
+        // remove all the cubes, the cubes are disjoint only among the matches of the same output
+        void Clear() { m_Cubes.clear(); };
+
+        size_t GetNumOfCubes() const { return m_Cubes.size(); };
+
+        size_t GetNumOfNarrowedCubes() const { return m_NumOfNarrowedCubes; };
+
+        // the max number of unmatched inputs for computing the permanent of a cube with non-feasible matches
+        static const size_t MAX_UNMATCHED_INPUTS_FOR_PERMANENT = 20;
+
+    protected:
+
+        // *** Params ***
+
+        const size_t m_InputSize;
+        const bool m_AllowInputNegMap;
+        // if every match is feasible
+        const bool m_IsAllFeasible;
+
+        // *** Variables ***
+
+        // the number of feasible polarities for each src and trg pair, used only if not every match is feasible
+        std::vector<std::vector<unsigned>> m_NumOfPolarities;
+        // the disjoint cubes added so far
+        std::vector<MatrixIndexVecMatch> m_Cubes;
+
+        // *** Stats ***
+
+        // the number of cubes narrowed by AddDisjointCube, so their completions can be counted
+        size_t m_NumOfNarrowedCubes;
+};
@@ -0,0 +1,324 @@
+#include "BoolMatchAlg/ForbiddenPairs/BoolMatchForbiddenPairs.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+
+#include "CirSimulation/CirDecomp.hpp"
+
+using namespace std;
+
+// FNV-1a hash of the sorted matches
+static uint64_t GetMatchesHash(MatrixIndexVecMatch matches)
+{
+    sort(matches.begin(), matches.end());
+
+    uint64_t h = 14695981039346656037ULL;
+    for (const MatrixIndexMatch& match : matches)
+    {
+        for (const int index : {match.first, match.second})
+        {
+            h = (h ^ (uint32_t)index) * 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+BoolMatchForbiddenPairs::BoolMatchForbiddenPairs(const AigerParser& srcAig, const AigerParser& trgAig, bool allowInputNegMap, bool allowOutputNegMap):
+m_AigParserSrc(srcAig),
+m_AigParserTrg(trgAig),
+m_SrcInputs(srcAig.GetInputs()),
+m_TrgInputs(trgAig.GetInputs()),
+m_InputSize(m_SrcInputs.size()),
+m_AllowInputNegMap(allowInputNegMap),
+m_AllowOutputNegMap(allowOutputNegMap),
+m_IsMatchSpaceEmpty(false),
+m_NumOfDsdBlocks({0, 0}),
+m_NumOfDsdExactBlocks({0, 0}),
+m_NumOfDsdForbiddenPairs(0),
+m_NumOfInvariantForbiddenPairs(0)
+{
+}
+
+void BoolMatchForbiddenPairs::ReadUserPairs(const string& fixedMapFile, const string& forbiddenPairsFile)
+{
+    m_FixedMapFile = fixedMapFile;
+    m_ForbiddenPairsFile = forbiddenPairsFile;
+
+    if (!m_FixedMapFile.empty())
+    {
+        m_FixedMatch = ReadMatchesFile(m_FixedMapFile);
+    }
+    if (!m_ForbiddenPairsFile.empty())
+    {
+        m_ForbiddenPairs = ReadMatchesFile(m_ForbiddenPairsFile);
+    }
+}
+
+void BoolMatchForbiddenPairs::AddDsdPairs(unsigned maxExactBlockSize)
+{
+    // [0] for the AND decomposition of the output and [1] for the AND decomposition of the negated output (OR decomposition)
+    array<CirDecomp, 2> srcDecomps = {CirDecomp(m_AigParserSrc, false, maxExactBlockSize), CirDecomp(m_AigParserSrc, true, maxExactBlockSize)};
+    array<CirDecomp, 2> trgDecomps = {CirDecomp(m_AigParserTrg, false, maxExactBlockSize), CirDecomp(m_AigParserTrg, true, maxExactBlockSize)};
+
+    auto setBlocksStats = [&](const array<CirDecomp, 2>& decomps, size_t cirIndex)
+    {
+        const CirDecomp& decomp = decomps[0].GetNumOfBlocks() >= decomps[1].GetNumOfBlocks() ? decomps[0] : decomps[1];
+        m_NumOfDsdBlocks[cirIndex] = decomp.GetNumOfBlocks();
+        m_NumOfDsdExactBlocks[cirIndex] = decomp.GetNumOfExactBlocks();
+    };
+    setBlocksStats(srcDecomps, 0);
+    setBlocksStats(trgDecomps, 1);
+
+    // the pairs that are not in any valid match to the trg output with the given polarity
+    auto getForbiddenPairs = [&](bool isOutputNeg) -> set<pair<size_t, size_t>>
+    {
+        set<pair<size_t, size_t>> forbiddenPairs;
+        for (size_t p = 0; p < 2; p++)
+        {
+            // the src output is matched to the negated trg output, so their opposite decompositions are the same
+            const CirDecomp& trgDecomp = trgDecomps[isOutputNeg ? 1 - p : p];
+            for (const pair<size_t, size_t>& forbiddenPair : CirDecomp::GetForbiddenPairs(srcDecomps[p], trgDecomp))
+            {
+                forbiddenPairs.insert(forbiddenPair);
+            }
+        }
+        return forbiddenPairs;
+    };
+
+    set<pair<size_t, size_t>> forbiddenPairs = getForbiddenPairs(false);
+    if (m_AllowOutputNegMap)
+    {
+        // the matrices are shared by both output polarities
+        const set<pair<size_t, size_t>> negOutputForbiddenPairs = getForbiddenPairs(true);
+        erase_if(forbiddenPairs, [&](const pair<size_t, size_t>& forbiddenPair) { return negOutputForbiddenPairs.count(forbiddenPair) == 0; });
+    }
+
+    const size_t numOfProvenForbiddenPairs = m_ProvenForbiddenPairs.size();
+    for (const pair<size_t, size_t>& forbiddenPair : forbiddenPairs)
+    {
+        // the matrix indexes are 1-based
+        m_ProvenForbiddenPairs.insert({(int)forbiddenPair.first + 1, (int)forbiddenPair.second + 1});
+        if (m_AllowInputNegMap)
+        {
+            m_ProvenForbiddenPairs.insert({(int)forbiddenPair.first + 1, -((int)forbiddenPair.second + 1)});
+        }
+    }
+
+    m_NumOfDsdForbiddenPairs = m_ProvenForbiddenPairs.size() - numOfProvenForbiddenPairs;
+}
+
+void BoolMatchForbiddenPairs::AddInvariantPairs(const BoolMatchInputInvariants& srcInvariants, const BoolMatchInputInvariants& trgInvariants)
+{
+    MatrixIndexVecMatch forbiddenPairs = BoolMatchInputInvariants::GetForbiddenMatches(srcInvariants, trgInvariants, m_AllowInputNegMap, m_AllowOutputNegMap);
+
+    m_NumOfInvariantForbiddenPairs = forbiddenPairs.size();
+    m_ProvenForbiddenPairs.insert(forbiddenPairs.begin(), forbiddenPairs.end());
+}
+
+void BoolMatchForbiddenPairs::InitFeasibleMatches()
+{
+    if (m_FixedMatch.empty() && m_ForbiddenPairs.empty() && m_ProvenForbiddenPairs.empty())
+    {
+        return;
+    }
+
+    // for every src input its fixed match, and for every trg input if it is fixed
+    vector<MatrixIndex> srcFixedMatch(m_InputSize, 0);
+    vector<bool> isTrgFixed(m_InputSize, false);
+    for (const MatrixIndexMatch& match : m_FixedMatch)
+    {
+        if (!IsMatchPos(match) && !m_AllowInputNegMap)
+        {
+            throw runtime_error("Negated fixed match requires negated map to the inputs");
+        }
+
+        const size_t srcIndex = GetAbsRealIndex(match.first);
+        const size_t trgIndex = GetAbsRealIndex(match.second);
+        if (srcFixedMatch[srcIndex] != 0 || isTrgFixed[trgIndex])
+        {
+            throw runtime_error("Input is fixed more than once in " + m_FixedMapFile);
+        }
+        srcFixedMatch[srcIndex] = match.second;
+        isTrgFixed[trgIndex] = true;
+    }
+
+    set<MatrixIndexMatch> forbiddenPairs(m_ForbiddenPairs.begin(), m_ForbiddenPairs.end());
+
+    // a pair given as both fixed and forbidden is a mistake in the files, and not a match space without valid matches
+    for (const MatrixIndexMatch& match : m_FixedMatch)
+    {
+        if (forbiddenPairs.find(match) != forbiddenPairs.end())
+        {
+            throw runtime_error("The match {" + to_string(m_SrcInputs[GetAbsRealIndex(match.first)]) + " " + (IsMatchPos(match) ? "" : "!") +
+                to_string(m_TrgInputs[GetAbsRealIndex(match.second)]) + "} is both fixed in " + m_FixedMapFile + " and forbidden in " + m_ForbiddenPairsFile);
+        }
+    }
+
+    forbiddenPairs.insert(m_ProvenForbiddenPairs.begin(), m_ProvenForbiddenPairs.end());
+
+    for (size_t srcIndex = 0; srcIndex < m_InputSize; srcIndex++)
+    {
+        for (size_t trgIndex = 0; trgIndex < m_InputSize; trgIndex++)
+        {
+            for (int trgSign : {1, -1})
+            {
+                if (trgSign < 0 && !m_AllowInputNegMap)
+                {
+                    continue;
+                }
+
+                MatrixIndexMatch match = {(int)srcIndex + 1, trgSign * ((int)trgIndex + 1)};
+                const bool isFixedFeasible = srcFixedMatch[srcIndex] != 0 ? srcFixedMatch[srcIndex] == match.second : !isTrgFixed[trgIndex];
+                if (isFixedFeasible && forbiddenPairs.find(match) == forbiddenPairs.end())
+                {
+                    m_FeasibleMatches.push_back(match);
+                }
+            }
+        }
+    }
+
+    // a full match is a perfect matching of the src and trg inputs over the feasible matches, found by augmenting paths
+    vector<vector<size_t>> feasibleTrgOfSrc(m_InputSize);
+    for (const MatrixIndexMatch& match : m_FeasibleMatches)
+    {
+        feasibleTrgOfSrc[GetAbsRealIndex(match.first)].push_back(GetAbsRealIndex(match.second));
+    }
+
+    vector<int> srcOfTrg(m_InputSize, -1);
+    vector<bool> isTrgVisited;
+    function<bool(size_t)> tryAugment = [&](size_t srcIndex) -> bool
+    {
+        for (size_t trgIndex : feasibleTrgOfSrc[srcIndex])
+        {
+            if (isTrgVisited[trgIndex])
+            {
+                continue;
+            }
+            isTrgVisited[trgIndex] = true;
+
+            if (srcOfTrg[trgIndex] < 0 || tryAugment((size_t)srcOfTrg[trgIndex]))
+            {
+                srcOfTrg[trgIndex] = (int)srcIndex;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (size_t srcIndex = 0; srcIndex < m_InputSize && !m_IsMatchSpaceEmpty; srcIndex++)
+    {
+        isTrgVisited.assign(m_InputSize, false);
+        m_IsMatchSpaceEmpty = !tryAugment(srcIndex);
+    }
+}
+
+void BoolMatchForbiddenPairs::EliminateForbiddenPairs(BoolMatchMatrixBase* matchMatrix) const
+{
+    for (const MatrixIndexMatch& match : m_ForbiddenPairs)
+    {
+        // a negated match is never found when negated map is not allowed
+        if (IsMatchPos(match) || m_AllowInputNegMap)
+        {
+            matchMatrix->EliminateMatch({match}, true);
+        }
+    }
+
+    for (const MatrixIndexMatch& match : m_ProvenForbiddenPairs)
+    {
+        matchMatrix->EliminateMatch({match}, true);
+    }
+}
+
+string BoolMatchForbiddenPairs::GetUserPairsConfig() const
+{
+    return to_string(GetMatchesHash(m_FixedMatch)) + " " + to_string(GetMatchesHash(m_ForbiddenPairs));
+}
+
+MatrixIndexVecMatch BoolMatchForbiddenPairs::ReadMatchesFile(const string& fileName) const
+{
+    ifstream in(fileName);
+    if (!in)
+    {
+        throw runtime_error("Failed to open the matches file " + fileName);
+    }
+
+    // the position of every (positive) input lit
+    unordered_map<AIGLIT, size_t> srcLit2Pos;
+    unordered_map<AIGLIT, size_t> trgLit2Pos;
+    for (size_t i = 0; i < m_InputSize; i++)
+    {
+        srcLit2Pos[m_SrcInputs[i]] = i;
+        trgLit2Pos[m_TrgInputs[i]] = i;
+    }
+
+    MatrixIndexVecMatch matches;
+    string line;
+    size_t lineNum = 0;
+
+    // parse an AIG literal token, the error holds the file, the line and the token
+    auto parseLit = [&](const string& token) -> AIGLIT
+    {
+        size_t parsedSize = 0;
+        unsigned long lit = 0;
+        try
+        {
+            lit = stoul(token, &parsedSize);
+        }
+        catch (const exception&)
+        {
+            parsedSize = 0;
+        }
+
+        if (token.empty() || !isdigit((unsigned char)token[0]) || parsedSize != token.size() || lit > UINT_MAX)
+        {
+            throw runtime_error("Bad input literal \"" + token + "\" in " + fileName + " line " + to_string(lineNum));
+        }
+        return (AIGLIT)lit;
+    };
+
+    while (getline(in, line))
+    {
+        lineNum++;
+        line = line.substr(0, line.find('#'));
+        replace(line.begin(), line.end(), '{', ' ');
+        replace(line.begin(), line.end(), '}', ' ');
+
+        istringstream lineStream(line);
+        string srcToken;
+        string trgToken;
+        while (lineStream >> srcToken)
+        {
+            if (!(lineStream >> trgToken))
+            {
+                throw runtime_error("Missing trg input for src input " + srcToken + " in " + fileName + " line " + to_string(lineNum));
+            }
+
+            const bool isNeg = trgToken[0] == '!';
+            if (isNeg)
+            {
+                trgToken = trgToken.substr(1);
+            }
+
+            const AIGLIT srcLit = parseLit(srcToken);
+            const AIGLIT trgLit = parseLit(trgToken);
+            auto srcIt = srcLit2Pos.find(srcLit);
+            auto trgIt = trgLit2Pos.find(trgLit);
+            if (srcIt == srcLit2Pos.end() || trgIt == trgLit2Pos.end())
+            {
+                throw runtime_error("Unknown input in the match {" + srcToken + " " + trgToken + "} in " + fileName + " line " + to_string(lineNum));
+            }
+
+            // the matrix indexes are 1-based
+            const int srcIndex = (int)srcIt->second + 1;
+            const int trgIndex = (int)trgIt->second + 1;
+            matches.push_back({srcIndex, isNeg ? -trgIndex : trgIndex});
+        }
+    }
+
+    return matches;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Globals/BoolMatchGloblas.hpp"
+#include "Aiger/AigerParser.hpp"
+#include "BoolMatchMatrix/BoolMatchMatrixBase.hpp"
+#include "BoolMatchAlg/Invariants/BoolMatchInputInvariants.hpp"
+
+/*
+    the fixed and forbidden matches (matrix indexes) of the match space, asserted on the match matrices before the enumeration
+    the user gives the known (partial) match by "/alg/fixed_map" and the matches that are not allowed by "/alg/forbidden_pairs"
+    the proven forbidden pairs are in no valid match, by the disjoint-support decompositions ("/alg/use_dsd") and by the exact invariants ("/alg/use_exact_invariants")
+    the proven pairs are created only for the allowed polarities, and with negated map to the output only the pairs of both output polarities
+    the feasible matches left by all the pairs are given to the sparse matrix and used for counting the completions of a valid cube
+*/
+class BoolMatchForbiddenPairs
+{
+    public:
+
+        BoolMatchForbiddenPairs(const AigerParser& srcAig, const AigerParser& trgAig, bool allowInputNegMap, bool allowOutputNegMap);
+
+        // read the fixed map and the forbidden pairs from the files, an empty file name for none
+        // the files are of "<src input lit> <trg input lit>" lines, see ReadMatchesFile
+        void ReadUserPairs(const std::string& fixedMapFile, const std::string& forbiddenPairsFile);
+
+        // add the pairs that are not in any valid match by the disjoint-support decompositions of the src and trg outputs
+        // both the AND and the OR decompositions are used, where a block of up to maxExactBlockSize inputs is decomposed exactly by simulation
+        void AddDsdPairs(unsigned maxExactBlockSize);
+
+        // add the matches between inputs with different exact invariants
+        void AddInvariantPairs(const BoolMatchInputInvariants& srcInvariants, const BoolMatchInputInvariants& trgInvariants);
+
+        // set the feasible matches left by the fixed and forbidden matches and if any full match is left
+        // must be called after all the pairs are read and added
+        void InitFeasibleMatches();
+
+        // eliminate the forbidden pairs from the matrix, the fixed map is asserted when the matrix is created
+        void EliminateForbiddenPairs(BoolMatchMatrixBase* matchMatrix) const;
+
+        // the config of the user pairs for the checkpoint, a hash of the fixed map and of the forbidden pairs
+        // the same pairs in another order get the same config
+        std::string GetUserPairsConfig() const;
+
+        const MatrixIndexVecMatch& GetFixedMatch() const { return m_FixedMatch; };
+        const MatrixIndexVecMatch& GetUserForbiddenPairs() const { return m_ForbiddenPairs; };
+        // empty means all the matches are feasible
+        const MatrixIndexVecMatch& GetFeasibleMatches() const { return m_FeasibleMatches; };
+        // if the fixed and forbidden matches leave no full match, so there is nothing to enumerate
+        bool IsMatchSpaceEmpty() const { return m_IsMatchSpaceEmpty; };
+
+        // the number of blocks and exact blocks of the decomposition of the src (isSrc) or trg output, of the output polarity with more blocks
+        size_t GetNumOfDsdBlocks(bool isSrc) const { return m_NumOfDsdBlocks[isSrc ? 0 : 1]; };
+        size_t GetNumOfDsdExactBlocks(bool isSrc) const { return m_NumOfDsdExactBlocks[isSrc ? 0 : 1]; };
+        size_t GetNumOfDsdForbiddenPairs() const { return m_NumOfDsdForbiddenPairs; };
+        size_t GetNumOfInvariantForbiddenPairs() const { return m_NumOfInvariantForbiddenPairs; };
+
+    protected:
+
+        // read the matches from a file of "<src input lit> <trg input lit>" lines, where "!" before the trg lit is a negated match
+        // the lines are in the format of the printed matches, so the braces are optional and "#" start a comment
+        MatrixIndexVecMatch ReadMatchesFile(const std::string& fileName) const;
+
+        // *** Params ***
+
+        const AigerParser& m_AigParserSrc;
+        const AigerParser& m_AigParserTrg;
+        // hold the inputs
+        const std::vector<AIGLIT> m_SrcInputs;
+        const std::vector<AIGLIT> m_TrgInputs;
+        const size_t m_InputSize;
+        const bool m_AllowInputNegMap;
+        const bool m_AllowOutputNegMap;
+
+        // *** Variables ***
+
+        // the files of the user pairs, empty for none
+        std::string m_FixedMapFile;
+        std::string m_ForbiddenPairsFile;
+        // the known (partial) match asserted on the matrices
+        MatrixIndexVecMatch m_FixedMatch;
+        // the matches eliminated from the matrices, given by the user
+        MatrixIndexVecMatch m_ForbiddenPairs;
+        // the matches proven to be in no valid match
+        std::set<MatrixIndexMatch> m_ProvenForbiddenPairs;
+        // the feasible matches (x,y,polarity), empty means all the matches are feasible
+        MatrixIndexVecMatch m_FeasibleMatches;
+        bool m_IsMatchSpaceEmpty;
+
+        // *** Stats ***
+
+        std::array<size_t, 2> m_NumOfDsdBlocks;
+        std::array<size_t, 2> m_NumOfDsdExactBlocks;
+        // the number of matches forbidden by the decompositions and by the exact invariants, a match may be forbidden by both
+        size_t m_NumOfDsdForbiddenPairs;
+        size_t m_NumOfInvariantForbiddenPairs;
+};
@@ -1,6 +1,12 @@
 #include "BoolMatchAlg/GeneralizationEnumer/BoolMatchAlgGenEnumerBase.hpp"
 
-#include "BoolMatchMatrix/BoolMatchMatrixSingleVars/BoolMatchMatrixSingleVars.hpp"
+#include <climits>
+#include <map>
+#include <random>
+#include <tuple>
+
+#include "BoolMatchMatrix/BoolMatchMatrices.hpp"
+#include "BoolMatchAlg/Checkpoint/BoolMatchEcoFilter.hpp"
 
 using namespace std;
 
@@ -20,24 +26,100 @@ m_UseMaxValApprxStrat(inputParser.getBoolCmdOption("/alg/use_max_val_apprx_strat
 m_UseAdapForMaxValApprxStrat(inputParser.getBoolCmdOption("/alg/use_adap_for_max_val_apprx_strat", true)),
 m_MaxValApprxStratInitVal(min(inputParser.getUintCmdOption("/alg/max_val_apprx_strat_init_val", 1),(unsigned)1)),
 m_MaxValApprxStratBoostVal(inputParser.getUintCmdOption("/alg/max_val_apprx_strat_boost_val", 1)),
+// default is single vars
+m_MatrixType(ConvertToBoolMatchMatrixType(inputParser.getUintCmdOption("/alg/matrix_type", DEF_MATRIX_TYPE_UINT))),
+// default is false
+m_UseInputSimilarity(inputParser.getBoolCmdOption("/alg/use_input_similarity", false)),
+m_InputSimilarityBoostVal(inputParser.getUintCmdOption("/alg/input_similarity_boost_val", 1)),
+// default is false
+m_UseStructSig(inputParser.getBoolCmdOption("/alg/use_struct_sig", false)),
+// default is 4 rounds
+m_StructSigNumOfRounds(inputParser.getUintCmdOption("/alg/struct_sig/rounds", CirStructSig::DEF_NUM_OF_ROUNDS)),
+// default is false
+m_CompressSymMatches(inputParser.getBoolCmdOption("/alg/compress_sym_matches", false)),
+// default is false
+m_ExactCount(inputParser.getBoolCmdOption("/alg/exact_count", false)),
+// default is 0 i.e. no sampling
+m_NumOfSamples(inputParser.getUintCmdOption("/alg/sample", 0)),
+m_SampleSeed(inputParser.getUintCmdOption("/alg/sample_seed", 0)),
+// default is empty, i.e. no checkpoint and no resume
+m_CheckpointFile(inputParser.getCmdOptionWDef("/general/checkpoint", "")),
+m_ResumeFile(inputParser.getCmdOptionWDef("/general/resume", "")),
+// default is 60 seconds
+m_CheckpointInterval(inputParser.getUintCmdOption("/general/checkpoint_interval", 60)),
+// default is empty, i.e. no ECO
+m_EcoFile(inputParser.getCmdOptionWDef("/general/eco", "")),
+// default is empty, i.e. no fixed map and no forbidden pairs
+m_FixedMapFile(inputParser.getCmdOptionWDef("/alg/fixed_map", "")),
+m_ForbiddenPairsFile(inputParser.getCmdOptionWDef("/alg/forbidden_pairs", "")),
+// default is false
+m_UseDsd(inputParser.getBoolCmdOption("/alg/use_dsd", false)),
+// default is 10 inputs
+m_DsdMaxExactBlockSize(min(inputParser.getUintCmdOption("/alg/dsd/max_exact_block_size", CirDecomp::DEF_MAX_EXACT_BLOCK_SIZE), CirDecomp::MAX_EXACT_BLOCK_SIZE)),
+// default is false
+m_UseExactInvariants(inputParser.getBoolCmdOption("/alg/use_exact_invariants", false)),
+// default is 4 threads
+m_NumOfInvariantThreads(max(inputParser.getUintCmdOption("/alg/exact_invariants/threads", BoolMatchInputInvariants::DEF_NUM_OF_THREADS), (unsigned)1)),
 m_Solver(nullptr), 
 m_DualSolver(nullptr),
 m_InputMatchMatrix(nullptr),
+m_ForbiddenPairs(nullptr),
 m_SrcCirSimulation(nullptr),
-m_TrgCirSimulation(nullptr)
+m_TrgCirSimulation(nullptr),
+m_SrcInputSig(nullptr),
+m_TrgInputSig(nullptr),
+m_SrcInputInvariants(nullptr),
+m_TrgInputInvariants(nullptr),
+m_SrcStructSig(nullptr),
+m_TrgStructSig(nullptr),
+m_ValidCubes(nullptr),
+m_ParallelState(nullptr),
+m_WorkerId(0),
+m_WorkCubeId(0),
+m_NextSharedWitness(0),
+m_Checkpoint(nullptr),
+m_IsResumePending(false),
+m_IsOutputNegMatch(false),
+m_SrcOutputBitSim(nullptr),
+m_TrgOutputBitSim(nullptr),
+m_NumOfValidMatchesByOutput({0, 0}),
+m_NumOfPosOutputValidMatchCubes(0),
+m_NumOfSharedOutputWitnesses(0),
+m_NumOfEcoWitnesses(0),
+m_NumOfEcoKeptWitnesses(0),
+m_NumOfEcoValidMatches(0),
+m_NumOfEcoKeptValidMatches(0)
 {
-    // we can not use cir simulation or core generalization if negated map is not allowed
-    // this is because we can have a situation where the we have 00XX -> 11XX (was 0011 -> 1100) and we can not block it under the assumption that no negated map is allowed
-    if (!m_AllowInputNegMap && (m_UseCirSim || m_UseDualSolver))
-    {
-        throw runtime_error("Can not use circuit simulation or UnSAT core generalization if negated map is not allowed");
-    }
+    // NOTE: cir simulation and core generalization can be used also when negated map is not allowed
+    // the DC values of the generalized witness are blocked with BoolMatchMatrixBase::EliminateOrEnforceMatchesByInputsValWithDC
 
     // check m_UseMaxValApprxStrat is only use when we do not allow neg map
     if (m_UseMaxValApprxStrat && m_AllowInputNegMap)
     {
         throw runtime_error("Can not use max val approx strat when neg map is allowed");
     }
+
+    if (!m_EcoFile.empty() && !m_ResumeFile.empty())
+    {
+        throw runtime_error("Can not use ECO and resume together");
+    }
+
+    // the canonical match of a symmetry class may be excluded by the fixed or forbidden matches
+    if (m_CompressSymMatches && (!m_FixedMapFile.empty() || !m_ForbiddenPairsFile.empty()))
+    {
+        throw runtime_error("Can not compress symmetric matches with fixed map or forbidden pairs");
+    }
+
+    // the saved state does not hold the output polarity
+    if (m_AllowOutputNegMap && (!m_CheckpointFile.empty() || !m_ResumeFile.empty() || !m_EcoFile.empty()))
+    {
+        throw runtime_error("Can not use checkpoint, resume or ECO with negated map to the output");
+    }
+
+    if (m_AllowOutputNegMap && m_NumOfSamples > 0)
+    {
+        throw runtime_error("Can not sample valid matches with negated map to the output");
+    }
 }
 
 BoolMatchAlgGenEnumerBase::~BoolMatchAlgGenEnumerBase() 
@@ -47,8 +129,26 @@ BoolMatchAlgGenEnumerBase::~BoolMatchAlgGenEnumerBase()
 
     delete m_InputMatchMatrix;
 
+    delete m_ForbiddenPairs;
+
     delete m_SrcCirSimulation;
     delete m_TrgCirSimulation;
+
+    delete m_SrcInputSig;
+    delete m_TrgInputSig;
+
+    delete m_SrcInputInvariants;
+    delete m_TrgInputInvariants;
+
+    delete m_SrcStructSig;
+    delete m_TrgStructSig;
+
+    delete m_ValidCubes;
+
+    delete m_Checkpoint;
+
+    delete m_SrcOutputBitSim;
+    delete m_TrgOutputBitSim;
 }
 
 void BoolMatchAlgGenEnumerBase::PrintResult(bool wasInterrupted)
@@ -56,6 +156,29 @@ void BoolMatchAlgGenEnumerBase::PrintResult(bool wasInterrupted)
     BoolMatchAlgBase::PrintResult(wasInterrupted);
     
     m_InputMatchMatrix->PrintStats();
+
+    if (m_ExactCount)
+    {
+        cout << "c Number of disjoint valid match cubes: " << m_NumOfPosOutputValidMatchCubes + m_ValidCubes->GetNumOfCubes() << endl;
+        if (m_ValidCubes->GetNumOfNarrowedCubes() > 0)
+        {
+            cout << "c Number of valid match cubes narrowed to at most " << BoolMatchValidCubes::MAX_UNMATCHED_INPUTS_FOR_PERMANENT << " unmatched inputs for counting: " <<
+                m_ValidCubes->GetNumOfNarrowedCubes() << endl;
+        }
+    }
+
+    if (m_AllowOutputNegMap)
+    {
+        cout << "c Number of valid matches of the positive output: " << GetNumOfAllValidMatches(m_NumOfValidMatchesByOutput[0]) <<
+            ", of the negated output: " << GetNumOfAllValidMatches(m_NumOfValidMatchesByOutput[1]) << endl;
+        cout << "c Number of witnesses shared with the negated output: " << m_NumOfSharedOutputWitnesses << endl;
+    }
+
+    if (m_Checkpoint != nullptr && !m_CheckpointFile.empty())
+    {
+        SaveCheckpoint();
+        cout << "c Checkpoint saved to " << m_CheckpointFile << endl;
+    }
 }
 
 
@@ -68,6 +191,92 @@ void BoolMatchAlgGenEnumerBase::_InitializeFromAIGs()
         m_TrgCirSimulation = new CirSim(m_AigParserTrg, m_UseTopToBotSim ? SimStrat::TopToBot : SimStrat::BotToTop);
     }
 
+    if (m_AllowOutputNegMap)
+    {
+        m_SrcOutputBitSim = new CirBitSim(m_AigParserSrc);
+        m_TrgOutputBitSim = new CirBitSim(m_AigParserTrg);
+    }
+
+    if (m_UseInputSimilarity)
+    {
+        m_SrcInputSig = new CirInputSig(m_AigParserSrc);
+        m_TrgInputSig = new CirInputSig(m_AigParserTrg);
+    }
+
+    if (m_UseStructSig)
+    {
+        // a negated match negates the edges of the trg input, and a negated output the output edge
+        m_SrcStructSig = new CirStructSig(m_AigParserSrc, m_StructSigNumOfRounds, m_AllowInputNegMap, m_AllowOutputNegMap);
+        m_TrgStructSig = new CirStructSig(m_AigParserTrg, m_StructSigNumOfRounds, m_AllowInputNegMap, m_AllowOutputNegMap);
+    }
+
+    if (m_UseExactInvariants)
+    {
+        m_SrcInputInvariants = new BoolMatchInputInvariants(m_InputParser, m_AigParserSrc, m_NumOfInvariantThreads);
+        m_TrgInputInvariants = new BoolMatchInputInvariants(m_InputParser, m_AigParserTrg, m_NumOfInvariantThreads);
+    }
+
+    if (m_CompressSymMatches)
+    {
+        // the invariants already decided every swap
+        m_SrcSymClasses = m_UseExactInvariants ? m_SrcInputInvariants->GetSymClasses() : FindSymClasses(m_AigParserSrc, m_SrcInputs);
+        m_TrgSymClasses = m_UseExactInvariants ? m_TrgInputInvariants->GetSymClasses() : FindSymClasses(m_AigParserTrg, m_TrgInputs);
+
+        auto fillClassOfInput = [&](const vector<vector<int>>& symClasses, vector<int>& classOfInput)
+        {
+            classOfInput.assign(m_InputSize, -1);
+            for (size_t c = 0; c < symClasses.size(); c++)
+            {
+                for (int index : symClasses[c])
+                {
+                    classOfInput[GetAbsRealIndex(index)] = (int)c;
+                }
+            }
+        };
+
+        fillClassOfInput(m_SrcSymClasses, m_SrcSymClassOfInput);
+        fillClassOfInput(m_TrgSymClasses, m_TrgSymClassOfInput);
+    }
+
+    m_ForbiddenPairs = new BoolMatchForbiddenPairs(m_AigParserSrc, m_AigParserTrg, m_AllowInputNegMap, m_AllowOutputNegMap);
+    m_ForbiddenPairs->ReadUserPairs(m_FixedMapFile, m_ForbiddenPairsFile);
+    if (m_UseDsd)
+    {
+        m_ForbiddenPairs->AddDsdPairs(m_DsdMaxExactBlockSize);
+    }
+    if (m_UseExactInvariants)
+    {
+        m_ForbiddenPairs->AddInvariantPairs(*m_SrcInputInvariants, *m_TrgInputInvariants);
+    }
+    m_ForbiddenPairs->InitFeasibleMatches();
+
+    if (m_ExactCount)
+    {
+        m_ValidCubes = new BoolMatchValidCubes(m_InputSize, m_AllowInputNegMap, m_ForbiddenPairs->GetFeasibleMatches());
+    }
+
+    if (!m_CheckpointFile.empty() || !m_ResumeFile.empty() || !m_EcoFile.empty())
+    {
+        m_Checkpoint = CreateCheckpoint();
+        m_LastCheckpointTime = chrono::steady_clock::now();
+
+        if (!m_ResumeFile.empty())
+        {
+            m_Checkpoint->Load(m_ResumeFile);
+            m_IsResumePending = true;
+
+            m_NumberOfValidMatches = m_Checkpoint->GetNumOfValidMatches();
+            m_TotalNumberOfMatches = m_Checkpoint->GetTotalNumOfMatches();
+            if (m_ValidCubes != nullptr)
+            {
+                for (const MatrixIndexVecMatch& cube : m_Checkpoint->GetValidMatchCubes())
+                {
+                    m_ValidCubes->AddCube(cube);
+                }
+            }
+        }
+    }
+
     m_Solver->InitializeSolverFromAIG(m_AigParserSrc, m_AigParserTrg);
 
     if (m_UseDualSolver)
@@ -76,11 +285,28 @@ void BoolMatchAlgGenEnumerBase::_InitializeFromAIGs()
     }
 
     _InitMatchMatrix();
+
+    if (!m_EcoFile.empty())
+    {
+        LoadEcoCheckpoint();
+    }
 }
 
 
 void BoolMatchAlgGenEnumerBase::_FindAllMatches()
 {
+    if (m_ForbiddenPairs->IsMatchSpaceEmpty())
+    {
+        // the matrix has no model, so the solver can not be checked
+        // in a parallel run the cubes are still reported as done
+        size_t cubeId = 0;
+        while (m_ParallelState != nullptr && m_ParallelState->GetNextCube(m_WorkCube, cubeId))
+        {
+            m_ParallelState->CubeDone(cubeId, 0);
+        }
+        return;
+    }
+
     SOLVER_RET_STATUS res = m_Solver->Solve();
 
     if (res == TIMEOUT_RET_STATUS || m_IsTimeOut)
@@ -94,19 +320,212 @@ void BoolMatchAlgGenEnumerBase::_FindAllMatches()
 		throw runtime_error("Initial model is not satisfiable. Please verify the logic model of the cells are correct.");
 	}
 
-    // TODO handle here the output assumption for plain and dual solvers
     // assert mitter on the circuit outputs
-    m_Solver->AssertOutputDiff(false);
-    if (m_UseDualSolver) m_DualSolver->AssertOutputDiff(true);
+    AssertOutputMitter(m_Solver, false);
+    if (m_UseDualSolver) AssertOutputMitter(m_DualSolver, true);
+
+    if (m_ParallelState == nullptr)
+    {
+        if (m_AllowOutputNegMap)
+        {
+            FindAllMatchesForBothOutputPolarities();
+        }
+        else
+        {
+            FindAllMatchesUnderOutputAssert();
+        }
+        return;
+    }
+
+    // search the cubes one by one, the blocked and eliminated matches of the previous cubes are kept
+    while (m_ParallelState->GetNextCube(m_WorkCube, m_WorkCubeId))
+    {
+        unsigned long long numOfValidMatchesBefore = m_NumberOfValidMatches;
+
+        FindAllMatchesUnderOutputAssert();
+
+        bool isFirstValidMatchFound = m_StopAtFirstValidMatch && m_NumberOfValidMatches > numOfValidMatchesBefore;
+        // the search of the cube is incomplete if the run was stopped by another worker
+        if (isFirstValidMatchFound || !IsStopRequested())
+        {
+            m_ParallelState->CubeDone(m_WorkCubeId, GetNumOfAllValidMatches(m_NumberOfValidMatches - numOfValidMatchesBefore));
+        }
 
-    FindAllMatchesUnderOutputAssert();
+        if (isFirstValidMatchFound)
+        {
+            m_ParallelState->Stop();
+        }
+    }
 };
 
 
+void BoolMatchAlgGenEnumerBase::AssertOutputMitter(BoolMatchSolverBase* solver, bool isDual)
+{
+    if (!m_AllowOutputNegMap)
+    {
+        solver->AssertOutputDiff(isDual);
+        return;
+    }
+
+    // the outputs are equal iff they differ from the negated target output
+    solver->CreateOutputDiffForBothPolarities();
+    solver->SetOutputNegMatch(isDual != m_IsOutputNegMatch);
+    m_OutputMitterSolvers.push_back({solver, isDual});
+}
+
+
+void BoolMatchAlgGenEnumerBase::SetOutputNegMatch(bool isNegMatch)
+{
+    m_IsOutputNegMatch = isNegMatch;
+    for (const pair<BoolMatchSolverBase*, bool>& mitterSolver : m_OutputMitterSolvers)
+    {
+        mitterSolver.first->SetOutputNegMatch(mitterSolver.second != isNegMatch);
+    }
+}
+
+
+void BoolMatchAlgGenEnumerBase::FindAllMatchesForBothOutputPolarities()
+{
+    for (bool isNegMatch : {false, true})
+    {
+        if (isNegMatch)
+        {
+            if (m_StopAtFirstValidMatch && m_NumberOfValidMatches > 0)
+            {
+                return;
+            }
+
+            ResetMatchMatrices();
+            if (m_ValidCubes != nullptr)
+            {
+                m_NumOfPosOutputValidMatchCubes = m_ValidCubes->GetNumOfCubes();
+                m_ValidCubes->Clear();
+            }
+
+            ShareWitnessesWithNegOutput();
+            SetOutputNegMatch(true);
+        }
+
+        if (m_PrintMatches)
+        {
+            cout << "c Matches of the " << (isNegMatch ? "negated" : "positive") << " output" << endl;
+        }
+
+        const unsigned long long numOfValidMatchesBefore = m_NumberOfValidMatches;
+        FindAllMatchesUnderOutputAssert();
+        m_NumOfValidMatchesByOutput[isNegMatch ? 1 : 0] = m_NumberOfValidMatches - numOfValidMatchesBefore;
+    }
+}
+
+
+void BoolMatchAlgGenEnumerBase::ResetMatchMatrices()
+{
+    m_InputMatchMatrix->ResetEliminatedMatches();
+}
+
+
+bool BoolMatchAlgGenEnumerBase::GetWitnessOutputVal(const MULT_INDX_ASSIGNMENT& values, bool isSrc)
+{
+    vector<uint64_t> inputsVal(m_InputSize, 0);
+    for (const INDX_ASSIGNMENT& assign : values)
+    {
+        if (GetValFromAssg(assign) == TVal::True)
+        {
+            inputsVal[GetIndFromAssg(assign)] = ~0ULL;
+        }
+    }
+
+    CirBitSim* bitSim = isSrc ? m_SrcOutputBitSim : m_TrgOutputBitSim;
+    return (bitSim->SimulateOutput(inputsVal) & 1ULL) != 0;
+}
+
+
+void BoolMatchAlgGenEnumerBase::ShareWitnessesWithNegOutput()
+{
+    auto getNumOfBoolVals = [](const MULT_INDX_ASSIGNMENT& values)
+    {
+        return (size_t)count_if(values.begin(), values.end(), [](const INDX_ASSIGNMENT& assign) { return IsTValBoolVal(GetValFromAssg(assign)); });
+    };
+
+    // the position of the values with the fewest non-DC inputs
+    auto getMostGeneral = [&](const vector<MULT_INDX_ASSIGNMENT>& allValues)
+    {
+        size_t bestPos = 0;
+        for (size_t pos = 1; pos < allValues.size(); pos++)
+        {
+            if (getNumOfBoolVals(allValues[pos]) < getNumOfBoolVals(allValues[bestPos]))
+            {
+                bestPos = pos;
+            }
+        }
+        return bestPos;
+    };
+
+    // without negated map to the inputs, values without DC are mapped only to values with the same number of ones
+    auto addWitness = [&](const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues)
+    {
+        const size_t numOfSrcBoolVals = getNumOfBoolVals(srcValues);
+        const size_t numOfTrgBoolVals = getNumOfBoolVals(trgValues);
+        if (!m_AllowInputNegMap && numOfSrcBoolVals == m_InputSize && numOfTrgBoolVals == m_InputSize)
+        {
+            auto isTrue = [](const INDX_ASSIGNMENT& assign) { return GetValFromAssg(assign) == TVal::True; };
+            if (count_if(srcValues.begin(), srcValues.end(), isTrue) != count_if(trgValues.begin(), trgValues.end(), isTrue))
+            {
+                return;
+            }
+        }
+
+        m_NegOutputWitnesses.push_back({srcValues, trgValues});
+    };
+
+    for (size_t outVal : {0, 1})
+    {
+        const vector<MULT_INDX_ASSIGNMENT>& srcValues = m_SrcWitnessValsByOutput[outVal];
+        const vector<MULT_INDX_ASSIGNMENT>& trgValues = m_TrgWitnessValsByOutput[outVal];
+        if (srcValues.empty() || trgValues.empty())
+        {
+            continue;
+        }
+
+        const size_t bestSrcPos = getMostGeneral(srcValues);
+        const size_t bestTrgPos = getMostGeneral(trgValues);
+
+        for (const MULT_INDX_ASSIGNMENT& values : srcValues)
+        {
+            addWitness(values, trgValues[bestTrgPos]);
+        }
+        for (size_t pos = 0; pos < trgValues.size(); pos++)
+        {
+            // the pair of the most general values was already added
+            if (pos != bestTrgPos)
+            {
+                addWitness(srcValues[bestSrcPos], trgValues[pos]);
+            }
+        }
+    }
+
+    m_NumOfSharedOutputWitnesses = m_NegOutputWitnesses.size();
+
+    for (size_t outVal : {0, 1})
+    {
+        m_SrcWitnessValsByOutput[outVal].clear();
+        m_TrgWitnessValsByOutput[outVal].clear();
+    }
+}
+
+
+void BoolMatchAlgGenEnumerBase::SetParallelState(BoolMatchParallelState* parallelState, unsigned workerId)
+{
+    m_ParallelState = parallelState;
+    m_WorkerId = workerId;
+}
+
+
 void BoolMatchAlgGenEnumerBase::PrintInitialInformation()
 {
     BoolMatchAlgBase::PrintInitialInformation();
 
+    cout << "c Match matrix type: " << ConvertBoolMatchMatrixTypeToString(m_MatrixType) << endl;
     if (m_UseCirSim)
     {
         if (m_UseTopToBotSim)
@@ -130,6 +549,73 @@ void BoolMatchAlgGenEnumerBase::PrintInitialInformation()
             }
         }
     }
+    if (m_UseInputSimilarity)
+    {
+        cout << "c Use input similarity to guide the matches, with boost value of " << m_InputSimilarityBoostVal << endl;
+    }
+    if (m_UseStructSig)
+    {
+        cout << "c Use structural fingerprints with " << m_StructSigNumOfRounds << " rounds, src classes: " << m_SrcStructSig->GetNumOfClasses() <<
+            ", trg classes: " << m_TrgStructSig->GetNumOfClasses() << endl;
+    }
+    if (m_CompressSymMatches)
+    {
+        cout << "c Compress symmetric matches, number of src symmetry classes: " << m_SrcSymClasses.size() << ", number of trg symmetry classes: " << m_TrgSymClasses.size() << endl;
+        if (m_PrintMatches)
+        {
+            cout << "c Src symmetry classes: ";
+            PrintSymClasses(m_SrcSymClasses, m_SrcInputs);
+            cout << "c Trg symmetry classes: ";
+            PrintSymClasses(m_TrgSymClasses, m_TrgInputs);
+        }
+    }
+    if (m_ExactCount)
+    {
+        cout << "c Count exactly the valid matches of the partial valid matches" << endl;
+    }
+    if (m_NumOfSamples > 0)
+    {
+        cout << "c Sample " << m_NumOfSamples << " valid matches with seed " << m_SampleSeed << endl;
+    }
+    if (!m_CheckpointFile.empty())
+    {
+        cout << "c Save checkpoint to " << m_CheckpointFile << " every " << m_CheckpointInterval << " seconds" << endl;
+    }
+    if (!m_ResumeFile.empty())
+    {
+        cout << "c Resume from checkpoint " << m_ResumeFile << endl;
+    }
+    if (!m_ForbiddenPairs->GetFixedMatch().empty())
+    {
+        cout << "c Fixed map of " << m_ForbiddenPairs->GetFixedMatch().size() << " inputs from " << m_FixedMapFile << endl;
+    }
+    if (!m_ForbiddenPairs->GetUserForbiddenPairs().empty())
+    {
+        cout << "c Forbidden " << m_ForbiddenPairs->GetUserForbiddenPairs().size() << " pairs from " << m_ForbiddenPairsFile << endl;
+    }
+    if (m_ForbiddenPairs->IsMatchSpaceEmpty())
+    {
+        cout << "c No full match is left by the fixed and forbidden matches" << endl;
+    }
+    if (m_UseDsd)
+    {
+        cout << "c Use disjoint-support decomposition, src blocks: " << m_ForbiddenPairs->GetNumOfDsdBlocks(true) << " (" << m_ForbiddenPairs->GetNumOfDsdExactBlocks(true) <<
+            " exact), trg blocks: " << m_ForbiddenPairs->GetNumOfDsdBlocks(false) << " (" << m_ForbiddenPairs->GetNumOfDsdExactBlocks(false) << " exact), forbidden " <<
+            m_ForbiddenPairs->GetNumOfDsdForbiddenPairs() << " pairs" << endl;
+    }
+    if (m_UseExactInvariants)
+    {
+        cout << "c Use exact input invariants with " << m_NumOfInvariantThreads << " threads, forbidden " << m_ForbiddenPairs->GetNumOfInvariantForbiddenPairs() << " pairs" << endl;
+        cout << "c Src inputs in support: " << m_SrcInputInvariants->GetNumOfSupportInputs() << ", unate: " << m_SrcInputInvariants->GetNumOfUnateInputs() <<
+            ", symmetric pairs: " << m_SrcInputInvariants->GetNumOfSymPairs() << ", SAT calls: " << m_SrcInputInvariants->GetNumOfSATCalls() << endl;
+        cout << "c Trg inputs in support: " << m_TrgInputInvariants->GetNumOfSupportInputs() << ", unate: " << m_TrgInputInvariants->GetNumOfUnateInputs() <<
+            ", symmetric pairs: " << m_TrgInputInvariants->GetNumOfSymPairs() << ", SAT calls: " << m_TrgInputInvariants->GetNumOfSATCalls() << endl;
+    }
+    if (!m_EcoFile.empty())
+    {
+        cout << "c ECO from checkpoint " << m_EcoFile << ", kept " << m_NumOfEcoKeptWitnesses << " of " << m_NumOfEcoWitnesses << " witnesses and " <<
+            m_NumOfEcoKeptValidMatches << " of " << m_NumOfEcoValidMatches << " valid matches" << endl;
+    }
     if (m_UseMaxValApprxStrat)
     {
         cout << "c Use max val approx strat with init value of " << m_MaxValApprxStratInitVal << endl;
@@ -150,17 +636,23 @@ INPUT_ASSIGNMENT BoolMatchAlgGenEnumerBase::GeneralizeWithCirSimulation(const IN
 }
 
 pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> BoolMatchAlgGenEnumerBase::GeneralizeModel(const INPUT_ASSIGNMENT& srcAssg, const INPUT_ASSIGNMENT& trgAssg)
+{ 
+    return GeneralizeModel(srcAssg, trgAssg, m_SrcCirSimulation, m_TrgCirSimulation, m_DualSolver);
+}
+
+pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> BoolMatchAlgGenEnumerBase::GeneralizeModel(const INPUT_ASSIGNMENT& srcAssg, const INPUT_ASSIGNMENT& trgAssg,
+    CirSim* srcCirSim, CirSim* trgCirSim, BoolMatchSolverBase* dualSolver)
 { 
     INPUT_ASSIGNMENT generalizeSrcModel = srcAssg;
     INPUT_ASSIGNMENT generalizeTrgModel = trgAssg;
     if (m_UseCirSim)
     {
-        generalizeSrcModel = GeneralizeWithCirSimulation(generalizeSrcModel, m_SrcCirSimulation);
-        generalizeTrgModel = GeneralizeWithCirSimulation(generalizeTrgModel, m_TrgCirSimulation);
+        generalizeSrcModel = GeneralizeWithCirSimulation(generalizeSrcModel, srcCirSim);
+        generalizeTrgModel = GeneralizeWithCirSimulation(generalizeTrgModel, trgCirSim);
     }
     if (m_UseDualSolver)
     {
-        pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> generalizedModels = m_DualSolver->GetUnSATCore(generalizeSrcModel, generalizeTrgModel, m_UseLitDrop, m_LitDropConflictLimit);
+        pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> generalizedModels = dualSolver->GetUnSATCore(generalizeSrcModel, generalizeTrgModel, m_UseLitDrop, m_LitDropConflictLimit);
         generalizeSrcModel = generalizedModels.first;
         generalizeTrgModel = generalizedModels.second;
     }
@@ -185,6 +677,434 @@ vector<SATLIT> BoolMatchAlgGenEnumerBase::GetInputMatchAssump(BoolMatchSolverBas
     return assump;
 };
 
+void BoolMatchAlgGenEnumerBase::ApplyInputSimilarity(BoolMatchMatrixBase* matchMatrix)
+{
+    assert(m_SrcInputSig != nullptr || m_SrcStructSig != nullptr);
+
+    // the similarity of the enabled signatures, the structural fingerprints are the same for both polarities
+    auto getSimilarity = [&](size_t x, size_t y, bool isPos) -> double
+    {
+        double similarity = 1.0;
+        if (m_SrcInputSig != nullptr)
+        {
+            similarity *= CirInputSig::GetSimilarity(*m_SrcInputSig, x, *m_TrgInputSig, y, isPos);
+        }
+        if (m_SrcStructSig != nullptr && m_UseStructSig)
+        {
+            similarity *= CirStructSig::GetSimilarity(*m_SrcStructSig, x, *m_TrgStructSig, y);
+        }
+        return similarity;
+    };
+
+    // hold the similarity of each match
+    vector<pair<double, MatrixIndexMatch>> matchesSimilarity;
+    matchesSimilarity.reserve(m_InputSize * m_InputSize * (m_AllowInputNegMap ? 2 : 1));
+
+    for (size_t x = 0; x < m_InputSize; x++)
+    {
+        for (size_t y = 0; y < m_InputSize; y++)
+        {
+            matchesSimilarity.push_back({getSimilarity(x, y, true), {PosToIndex(x), PosToIndex(y)}});
+            if (m_AllowInputNegMap)
+            {
+                matchesSimilarity.push_back({getSimilarity(x, y, false), {PosToIndex(x), -PosToIndex(y)}});
+            }
+        }
+    }
+
+    // prefer from the least similar to the most similar, so shared lits are decided by the most similar match
+    sort(matchesSimilarity.begin(), matchesSimilarity.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& [similarity, match] : matchesSimilarity)
+    {
+        matchMatrix->PreferMatch(match, similarity * m_InputSimilarityBoostVal);
+    }
+}
+
+vector<vector<int>> BoolMatchAlgGenEnumerBase::FindSymClasses(const AigerParser& aigParser, const vector<AIGLIT>& inputs)
+{
+    // the number of random 64 bit words to filter the swaps
+    const unsigned numOfSimWords = 4;
+
+    CirBitSim bitSim(aigParser);
+    mt19937_64 randGen(0);
+
+    vector<vector<uint64_t>> simInputsVal(numOfSimWords, vector<uint64_t>(inputs.size()));
+    vector<uint64_t> simOutVal(numOfSimWords);
+    for (unsigned w = 0; w < numOfSimWords; w++)
+    {
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            simInputsVal[w][i] = randGen();
+        }
+        simOutVal[w] = bitSim.SimulateOutput(simInputsVal[w]);
+    }
+
+    // the circuit against itself, an input is matched to itself unless swapped
+    BoolMatchSolverTopor symSolver(m_InputParser, CirEncoding::TSEITIN_ENC, false);
+    symSolver.InitializeSolverFromAIG(aigParser, aigParser);
+    symSolver.AssertOutputDiff(false);
+
+    auto isSwapSym = [&](size_t i, size_t j) -> bool
+    {
+        for (unsigned w = 0; w < numOfSimWords; w++)
+        {
+            vector<uint64_t> swappedVal = simInputsVal[w];
+            swap(swappedVal[i], swappedVal[j]);
+            if (bitSim.SimulateOutput(swappedVal) != simOutVal[w])
+            {
+                return false;
+            }
+        }
+
+        vector<SATLIT> assump;
+        for (size_t k = 0; k < inputs.size(); k++)
+        {
+            size_t swappedK = k == i ? j : (k == j ? i : k);
+            assump.push_back(symSolver.GetInputEqAssmp(inputs[k], inputs[swappedK], true));
+        }
+
+        return CheckSolverUnderAssump(&symSolver, assump);
+    };
+
+    // swap symmetry is an equivalence relation, so it is enough to check against the first input of each class
+    vector<vector<int>> symClasses;
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        bool foundClass = false;
+        for (vector<int>& symClass : symClasses)
+        {
+            if (isSwapSym(GetAbsRealIndex(symClass[0]), i))
+            {
+                symClass.push_back(PosToIndex(i));
+                foundClass = true;
+                break;
+            }
+        }
+
+        if (!foundClass)
+        {
+            symClasses.push_back({PosToIndex(i)});
+        }
+    }
+
+    symClasses.erase(remove_if(symClasses.begin(), symClasses.end(), [](const vector<int>& symClass) { return symClass.size() < 2; }), symClasses.end());
+
+    return symClasses;
+}
+
+unsigned long long BoolMatchAlgGenEnumerBase::GetNumOfSymMatches(const MatrixIndexVecMatch& match) const
+{
+    if (!m_CompressSymMatches)
+    {
+        return 1;
+    }
+
+    auto factorial = [](size_t n) -> double
+    {
+        double res = 1;
+        for (size_t i = 2; i <= n; i++)
+        {
+            res *= (double)i;
+        }
+        return res;
+    };
+
+    // the match represent all the matches of permuting the src and trg classes
+    double numOfSymMatches = 1;
+    for (const vector<int>& symClass : m_SrcSymClasses)
+    {
+        numOfSymMatches *= factorial(symClass.size());
+    }
+    for (const vector<int>& symClass : m_TrgSymClasses)
+    {
+        numOfSymMatches *= factorial(symClass.size());
+    }
+
+    // permuting together the inputs mapped from the same src class to the same trg class (with the same polarity) keeps the match
+    map<tuple<int, int, bool>, size_t> sameClassesSize;
+    for (const MatrixIndexMatch& singleMatch : match)
+    {
+        int srcClass = m_SrcSymClassOfInput[GetAbsRealIndex(singleMatch.first)];
+        int trgClass = m_TrgSymClassOfInput[GetAbsRealIndex(singleMatch.second)];
+        if (srcClass >= 0 && trgClass >= 0)
+        {
+            sameClassesSize[{srcClass, trgClass, IsMatchPos(singleMatch)}]++;
+        }
+    }
+    for (const auto& [classes, size] : sameClassesSize)
+    {
+        numOfSymMatches /= factorial(size);
+    }
+
+    return numOfSymMatches >= (double)ULLONG_MAX ? ULLONG_MAX : (unsigned long long)(numOfSymMatches + 0.5);
+}
+
+void BoolMatchAlgGenEnumerBase::PrintSymClasses(const vector<vector<int>>& symClasses, const vector<AIGLIT>& inputs) const
+{
+    for (const vector<int>& symClass : symClasses)
+    {
+        cout << "{";
+        for (size_t i = 0; i < symClass.size(); i++)
+        {
+            cout << inputs[GetAbsRealIndex(symClass[i])] << (i != symClass.size() - 1 ? " " : "");
+        }
+        cout << "} ";
+    }
+    cout << endl;
+}
+
+void BoolMatchAlgGenEnumerBase::BlockWitness(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues, BoolMatchMatrixBase* otherMatchData)
+{
+    m_InputMatchMatrix->BlockMatchesByInputsVal(srcValues, trgValues, otherMatchData);
+
+    if (m_ParallelState != nullptr)
+    {
+        m_ParallelState->AddWitness(m_WorkerId, srcValues, trgValues);
+    }
+
+    if (m_Checkpoint != nullptr)
+    {
+        m_Checkpoint->AddWitness(srcValues, trgValues);
+    }
+
+    // keep the witnesses of the positive output to share with the negated output
+    if (m_AllowOutputNegMap && !m_IsOutputNegMatch)
+    {
+        m_SrcWitnessValsByOutput[GetWitnessOutputVal(srcValues, true) ? 1 : 0].push_back(srcValues);
+        m_TrgWitnessValsByOutput[GetWitnessOutputVal(trgValues, false) ? 1 : 0].push_back(trgValues);
+    }
+}
+
+void BoolMatchAlgGenEnumerBase::BlockSharedWitnesses(BoolMatchMatrixBase* otherMatchData)
+{
+    if (m_IsResumePending)
+    {
+        for (const pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>& witness : m_Checkpoint->GetWitnesses())
+        {
+            m_InputMatchMatrix->BlockMatchesByInputsVal(witness.first, witness.second, otherMatchData);
+        }
+
+        // the valid matches are enumerated from otherMatchData if given
+        BoolMatchMatrixBase* validMatchMatrix = otherMatchData != nullptr ? otherMatchData : m_InputMatchMatrix;
+        for (const MatrixIndexVecMatch& match : m_Checkpoint->GetValidMatches())
+        {
+            validMatchMatrix->EliminateMatch(match);
+        }
+
+        cout << "c Resumed " << m_Checkpoint->GetWitnesses().size() << " witnesses and " << m_Checkpoint->GetNumOfValidMatchRecords() << " valid matches from " << (m_ResumeFile.empty() ? m_EcoFile : m_ResumeFile) << endl;
+        m_IsResumePending = false;
+    }
+
+    for (const pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>& witness : m_NegOutputWitnesses)
+    {
+        m_InputMatchMatrix->BlockMatchesByInputsVal(witness.first, witness.second, otherMatchData);
+    }
+    m_NegOutputWitnesses.clear();
+
+    SaveCheckpointPeriodically();
+
+    if (m_ParallelState == nullptr)
+    {
+        return;
+    }
+
+    for (const pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>& witness : m_ParallelState->GetNewWitnesses(m_WorkerId, m_NextSharedWitness))
+    {
+        m_InputMatchMatrix->BlockMatchesByInputsVal(witness.first, witness.second, otherMatchData);
+    }
+}
+
+void BoolMatchAlgGenEnumerBase::EliminateValidMatch(BoolMatchMatrixBase* matchMatrix, const MatrixIndexVecMatch& match,
+    unsigned long long numOfValidMatches, bool isDisjointCube)
+{
+    matchMatrix->EliminateMatch(match);
+
+    if (m_Checkpoint != nullptr)
+    {
+        m_Checkpoint->AddValidMatch(match, numOfValidMatches, isDisjointCube);
+    }
+
+    m_NumberOfValidMatches += numOfValidMatches;
+}
+
+void BoolMatchAlgGenEnumerBase::HandleValidMatch(MatrixIndexVecMatch currMatch, BoolMatchSolverBase* ucoreSolver, BoolMatchMatrixBase* matchMatrix)
+{
+    unsigned long long numOfSymMatches = GetNumOfSymMatches(currMatch);
+    // in exact count the partial valid match is counted by its completions
+    unsigned long long numOfValidMatches = numOfSymMatches;
+
+    if (ucoreSolver != nullptr)
+    {
+        // will hold the partial map of the inputs suffice for valid mapping, meaning no matter how we complete the rest of the mapping
+        MatrixIndexVecMatch currPartialValidMatch;
+        // NOTE: at this point we know the only assumption used are the matches assumptions, this is important for the UCore extraction
+        // go over the match assumptions and try to remove
+        for (size_t matchIndex = 0; matchIndex < currMatch.size(); matchIndex++)
+        {
+            if (ucoreSolver->IsAssumptionRequired(matchIndex))
+            {
+                currPartialValidMatch.push_back(currMatch[matchIndex]);
+            }
+        }
+
+        //TODO add param
+        // now do minimal unsat core with drop lit
+        // iterating from back to begin to support remove and iteration of vector
+        for (int matchIndex = currPartialValidMatch.size() - 1; matchIndex >= 0; --matchIndex) 
+        {
+            // Temporary store the current match
+            MatrixIndexMatch tempMatch = currPartialValidMatch[matchIndex];
+
+            // Remove the current lit from the, copy the last element
+            currPartialValidMatch[matchIndex] = currPartialValidMatch.back();
+            currPartialValidMatch.pop_back();
+
+            vector<SATLIT> currAssump = GetInputMatchAssump(ucoreSolver, currPartialValidMatch);
+            if (CheckSolverUnderAssump(ucoreSolver, currAssump)) 
+            {
+                // this mean we manage to remove the match from the core
+                // TODO add here recurisve unsat core extraction?			
+            } 
+            else 
+            {
+                // we can not remove the match from the core
+                // restore the lit to the vector, where the position is changed (should not be a problem)
+                currPartialValidMatch.push_back(tempMatch);
+            }
+        }
+
+        if (m_ExactCount)
+        {
+            // count the completions of the partial valid match which were not counted before
+            currPartialValidMatch = m_ValidCubes->AddDisjointCube(currPartialValidMatch, currMatch, m_WorkCube);
+            numOfValidMatches = m_ValidCubes->GetNumOfCompletions(currPartialValidMatch);
+        }
+
+        currMatch = currPartialValidMatch;
+
+        // check if we manage to generalize the match to tautology
+        if (currMatch.size() == 0)
+        {
+            // we have a tautology
+            cout << "c Found tautology when using UnSAT core for valid matches" << endl;
+        }
+    }
+
+    PrintValidMatch(currMatch, numOfSymMatches);
+
+    EliminateValidMatch(matchMatrix, currMatch, numOfValidMatches, m_ExactCount && ucoreSolver != nullptr);
+}
+
+BoolMatchCheckpoint* BoolMatchAlgGenEnumerBase::CreateCheckpoint() const
+{
+    // the witnesses and matches are kept by matrix indexes, so only the parameters that change the counted matches are checked
+    // the fixed and forbidden pairs are checked by a hash, so the same pairs in another order are accepted
+    string paramsConfig = to_string(m_InputSize) + " " + to_string(m_AllowInputNegMap) + " " + to_string(m_CompressSymMatches) + " " + to_string(m_ExactCount) + " " +
+        m_ForbiddenPairs->GetUserPairsConfig();
+    string circuitsConfig = to_string(m_AigParserSrc.GetMaxIndex()) + " " + to_string(m_AigParserTrg.GetMaxIndex());
+
+    return new BoolMatchCheckpoint(paramsConfig, circuitsConfig);
+}
+
+void BoolMatchAlgGenEnumerBase::LoadEcoCheckpoint()
+{
+    BoolMatchCheckpoint* prevCheckpoint = CreateCheckpoint();
+    prevCheckpoint->Load(m_EcoFile, false);
+
+    BoolMatchEcoFilter ecoFilter(m_InputParser, m_AigParserSrc, m_AigParserTrg);
+
+    for (const pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>& witness : prevCheckpoint->GetWitnesses())
+    {
+        m_NumOfEcoWitnesses++;
+        if (ecoFilter.IsWitnessKept(witness.first, witness.second))
+        {
+            m_NumOfEcoKeptWitnesses++;
+            m_Checkpoint->AddWitness(witness.first, witness.second);
+        }
+    }
+
+    // in exact count the valid matches are the disjoint cubes, and they are counted by their completions
+    for (const MatrixIndexVecMatch& match : m_ExactCount ? prevCheckpoint->GetValidMatchCubes() : prevCheckpoint->GetValidMatches())
+    {
+        m_NumOfEcoValidMatches++;
+        if (!ecoFilter.IsValidMatchKept(match))
+        {
+            continue;
+        }
+
+        m_NumOfEcoKeptValidMatches++;
+        const unsigned long long numOfValidMatches = m_ExactCount ? m_ValidCubes->GetNumOfCompletions(match) : GetNumOfSymMatches(match);
+        m_Checkpoint->AddValidMatch(match, numOfValidMatches, m_ExactCount);
+        if (m_ExactCount)
+        {
+            m_ValidCubes->AddCube(match);
+        }
+        m_NumberOfValidMatches += numOfValidMatches;
+    }
+
+    delete prevCheckpoint;
+
+    // the kept witnesses and matches are applied like in resume
+    m_IsResumePending = true;
+}
+
+void BoolMatchAlgGenEnumerBase::SaveCheckpoint()
+{
+    m_Checkpoint->Save(m_CheckpointFile, m_TotalNumberOfMatches);
+    m_LastCheckpointTime = chrono::steady_clock::now();
+}
+
+void BoolMatchAlgGenEnumerBase::SaveCheckpointPeriodically()
+{
+    if (m_Checkpoint != nullptr && !m_CheckpointFile.empty() &&
+        chrono::steady_clock::now() - m_LastCheckpointTime >= chrono::seconds(m_CheckpointInterval))
+    {
+        SaveCheckpoint();
+    }
+}
+
+vector<SATLIT> BoolMatchAlgGenEnumerBase::GetWorkCubeAssump(const BoolMatchMatrixBase* matchMatrix) const
+{
+    if (m_ParallelState == nullptr)
+    {
+        return {};
+    }
+
+    return matchMatrix->GetMatchAssump(m_WorkCube);
+}
+
+bool BoolMatchAlgGenEnumerBase::IsStopRequested() const
+{
+    return BoolMatchAlgBase::IsStopRequested() || (m_ParallelState != nullptr && m_ParallelState->IsStopped());
+}
+
+void BoolMatchAlgGenEnumerBase::PrintValidMatch(const MatrixIndexVecMatch& match, unsigned long long numOfSymMatches)
+{
+    if (!m_PrintMatches)
+    {
+        return;
+    }
+
+    // the lock is taken only in a parallel run
+    unique_lock<mutex> printLock;
+    if (m_ParallelState != nullptr)
+    {
+        printLock = unique_lock<mutex>(m_ParallelState->GetPrintMutex());
+    }
+
+    // in a sharded run the coordinator print the matches of a cube only when it is done, so every line is tagged with the cube
+    const string cubeTag = (m_ParallelState != nullptr && m_ParallelState->IsReportingDoneCubes()) ?
+        "c Shard cube " + to_string(m_WorkCubeId) + " match: " : "";
+
+    cout << cubeTag;
+    PrintMatrixIndexMatchAsAIG(match);
+    if (m_CompressSymMatches)
+    {
+        cout << cubeTag << "c Symmetric matches of the base mapping: " << numOfSymMatches << endl;
+    }
+}
+
 bool BoolMatchAlgGenEnumerBase::CheckSolverUnderAssump(BoolMatchSolverBase* solver, std::vector<SATLIT>& assump,
     bool forcePolToVal, unsigned value, double boostScore)
 {
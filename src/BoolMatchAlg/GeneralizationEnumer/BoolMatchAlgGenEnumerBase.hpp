@@ -1,9 +1,21 @@
 #pragma once
 
 #include "BoolMatchAlg/BoolMatchAlgBase.hpp"
+#include "BoolMatchAlg/Parallel/BoolMatchParallelState.hpp"
+#include "BoolMatchAlg/Checkpoint/BoolMatchCheckpoint.hpp"
 #include "BoolMatchSolver/Solvers.hpp"
 #include "BoolMatchMatrix/BoolMatchMatrixBase.hpp"
 #include "CirSimulation/CirSim.hpp"
+#include "CirSimulation/CirInputSig.hpp"
+#include "CirSimulation/CirBitSim.hpp"
+#include "CirSimulation/CirDecomp.hpp"
+#include "CirSimulation/CirStructSig.hpp"
+#include "BoolMatchAlg/Invariants/BoolMatchInputInvariants.hpp"
+#include "BoolMatchAlg/ForbiddenPairs/BoolMatchForbiddenPairs.hpp"
+#include "BoolMatchAlg/ExactCount/BoolMatchValidCubes.hpp"
+
+#include <array>
+#include <chrono>
 
 /*
     Base solver class for any algorithm that will use enumeration on the possible matrix matches
@@ -19,6 +31,10 @@ class BoolMatchAlgGenEnumerBase : public BoolMatchAlgBase
 
         void PrintResult(bool wasInterrupted = false);
 
+        // run as a worker of a parallel run, where the matches are searched only in the cubes taken from parallelState
+        // must be called before FindAllMatches
+        void SetParallelState(BoolMatchParallelState* parallelState, unsigned workerId);
+
     protected:
 
         // print initial information, timeout etc..
@@ -32,6 +48,9 @@ class BoolMatchAlgGenEnumerBase : public BoolMatchAlgBase
         // find all the boolean matches for the given AIGs
         virtual void _FindAllMatches();
 
+        // the samples are not all the valid matches
+        virtual bool IsCountingAllMatches() const { return BoolMatchAlgBase::IsCountingAllMatches() && m_NumOfSamples == 0; };
+
         // find all the boolean matches for the given AIGs
         // after we assert that the output diff
         virtual void FindAllMatchesUnderOutputAssert() = 0;
@@ -42,6 +61,11 @@ class BoolMatchAlgGenEnumerBase : public BoolMatchAlgBase
         // return the generalized assignment for the src and trg in the form of <src, trg>
         std::pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> GeneralizeModel(const INPUT_ASSIGNMENT& srcAssg, const INPUT_ASSIGNMENT& trgAssg);
 
+        // generalize model of src and trg with the given simulations and dual solver instead of the members
+        // used by generalization threads, where each thread hold its own simulations and dual solver
+        std::pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> GeneralizeModel(const INPUT_ASSIGNMENT& srcAssg, const INPUT_ASSIGNMENT& trgAssg,
+            CirSim* srcCirSim, CirSim* trgCirSim, BoolMatchSolverBase* dualSolver);
+
         // help util function to get the assumption for the current input match under specific solver
         std::vector<SATLIT> GetInputMatchAssump(BoolMatchSolverBase* solver, const MatrixIndexVecMatch& fmatch);
 
@@ -53,6 +77,87 @@ class BoolMatchAlgGenEnumerBase : public BoolMatchAlgBase
         // boostScore is the score to boost the literals
         bool CheckSolverUnderAssump(BoolMatchSolverBase* solver, std::vector<SATLIT>& assump, 
             bool forcePolToVal = false, unsigned value = 0, double boostScore = 1.0);
+
+        // prefer the matches of the given matrix by the similarity of the src and trg inputs signatures and/or structural fingerprints
+        // the most similar matches get the highest score, so the solver will try them first
+        // NOTE: the solver of the matrix can not be ipasir
+        void ApplyInputSimilarity(BoolMatchMatrixBase* matchMatrix);
+
+        // find the classes of inputs (matrix indexes) where swapping any two inputs of the class keeps the output, only classes with more than one input are returned
+        // swaps are filtered by bit-parallel simulation and then checked with a SAT call on the circuit against itself
+        std::vector<std::vector<int>> FindSymClasses(const AigerParser& aigParser, const std::vector<AIGLIT>& inputs);
+
+        // get the number of matches represented by the given (canonical) match under the src and trg symmetry classes
+        // return 1 if symmetric matches are not compressed
+        unsigned long long GetNumOfSymMatches(const MatrixIndexVecMatch& match) const;
+
+        // print the symmetry classes as AIG lits
+        void PrintSymClasses(const std::vector<std::vector<int>>& symClasses, const std::vector<AIGLIT>& inputs) const;
+
+        // block the matches by the (generalized) inputs values of a non-valid match witness
+        // in a parallel run the witness is also shared with the other workers
+        void BlockWitness(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues, BoolMatchMatrixBase* otherMatchData = nullptr);
+
+        // block the matches by the new witnesses shared by the other workers, if any
+        // on the first call after resume, also block the witnesses and eliminate the valid matches of the checkpoint (from otherMatchData if given)
+        // called every step, so also save the checkpoint periodically
+        void BlockSharedWitnesses(BoolMatchMatrixBase* otherMatchData = nullptr);
+
+        // eliminate the (partial) valid match from the matrix, keep it in the checkpoint and count its numOfValidMatches valid matches
+        // the match is counted only after it is kept, so a checkpoint saved by an interrupt never count a match it does not hold
+        // isDisjointCube - if the match is a disjoint valid cube of the exact count
+        void EliminateValidMatch(BoolMatchMatrixBase* matchMatrix, const MatrixIndexVecMatch& match, unsigned long long numOfValidMatches, bool isDisjointCube);
+
+        // count, strengthen and print the valid match, then eliminate it from matchMatrix
+        // ucoreSolver - if not nullptr, its last call was unsatisfiable under the match assumptions of currMatch
+        // and the match is strengthened to a partial valid match by the UnSAT core and dropping the matches one by one
+        void HandleValidMatch(MatrixIndexVecMatch currMatch, BoolMatchSolverBase* ucoreSolver, BoolMatchMatrixBase* matchMatrix);
+
+        // save the current state into m_CheckpointFile
+        void SaveCheckpoint();
+
+        // save the checkpoint if m_CheckpointInterval passed since the last save
+        void SaveCheckpointPeriodically();
+
+        // create an empty checkpoint with the config of the current circuits and parameters
+        BoolMatchCheckpoint* CreateCheckpoint() const;
+
+        // load the checkpoint of a previous run on slightly different circuits (ECO)
+        // every witness and valid match is checked on the current circuits by BoolMatchEcoFilter, and only the ones that still hold are kept
+        void LoadEcoCheckpoint();
+
+        // assert the mitter on the outputs of the solver, where a dual solver assert that the outputs are equal
+        // with negated map to the output the mitters of both polarities are created, and the one of the current output polarity is used
+        void AssertOutputMitter(BoolMatchSolverBase* solver, bool isDual);
+
+        // use the mitters of the given output polarity in all the solvers
+        void SetOutputNegMatch(bool isNegMatch);
+
+        // find the matches of the positive and then of the negated target output in a single run (negated map to the output)
+        // the solvers, the simulations and the witnesses of the positive output are shared with the negated output
+        void FindAllMatchesForBothOutputPolarities();
+
+        // reset the matches blocked and eliminated in the matrices, the fixed and forbidden matches are kept
+        // called before the search of the negated output, since the witnesses and valid matches of the positive output do not hold for it
+        virtual void ResetMatchMatrices();
+
+        // get the output value of the circuit under the (generalized) inputs values of a witness
+        // the output of a witness is the same for every value of its DC inputs, so they are simulated as 0
+        bool GetWitnessOutputVal(const MULT_INDX_ASSIGNMENT& values, bool isSrc);
+
+        // make witnesses of the negated output from the witnesses of the positive output, to block on the next call to BlockSharedWitnesses
+        // the src and trg values of any two witnesses are a witness of the negated output if their outputs are equal
+        // so each src (trg) values are paired with the trg (src) values of the same output that have the fewest non-DC inputs
+        void ShareWitnessesWithNegOutput();
+
+        // get the assumption that restrict the matches of the given matrix to the current work cube, empty if not a parallel run
+        std::vector<SATLIT> GetWorkCubeAssump(const BoolMatchMatrixBase* matchMatrix) const;
+
+        // return true if a stop was requested, or a parallel run was stopped, i.e. another worker found the first valid match
+        bool IsStopRequested() const override;
+
+        // print a valid match (if m_PrintMatches), in a parallel run the print is done under the shared lock
+        void PrintValidMatch(const MatrixIndexVecMatch& match, unsigned long long numOfSymMatches);
         
         // *** Params ***
 
@@ -78,6 +183,51 @@ class BoolMatchAlgGenEnumerBase : public BoolMatchAlgBase
         const unsigned m_MaxValApprxStratInitVal;
         // hold the boost value for each input in max val approx strat
         const unsigned m_MaxValApprxStratBoostVal;
+        // the encoding of the match matrix variables
+        const BoolMatchMatrixType m_MatrixType;
+        // if to guide the match enumeration by the similarity of the inputs signatures (structural and simulation)
+        // NOTE: used only where the enumerated matches are checked one by one (iterative algorithm)
+        const bool m_UseInputSimilarity;
+        // the boost value for the most similar match, other matches are boosted relative to their similarity
+        const unsigned m_InputSimilarityBoostVal;
+        // if to guide the match enumeration also by the structural fingerprints of the inputs fanout cones (as the input similarity)
+        const bool m_UseStructSig;
+        // the number of refinement rounds of the structural fingerprints
+        const unsigned m_StructSigNumOfRounds;
+        // if to enumerate only a single (canonical) match for each class of matches that are equal under the inputs symmetries
+        // every valid match is counted as the number of matches it represents
+        const bool m_CompressSymMatches;
+        // if to count exactly the valid matches represented by the partial valid matches (UnSAT core for valid match)
+        // each partial valid match is made disjoint from the previous ones and counted by its number of completions
+        const bool m_ExactCount;
+
+        // if > 0 return this number of near-uniformly random valid matches instead of enumerating all of them
+        // NOTE: supported only by the iterative algorithm
+        const unsigned m_NumOfSamples;
+        // the seed of the random XOR constraints used for sampling
+        const unsigned m_SampleSeed;
+
+        // the file to save the enumeration state into, empty for no checkpoint
+        const std::string m_CheckpointFile;
+        // the file to load the enumeration state from, empty for no resume
+        const std::string m_ResumeFile;
+        // the interval in seconds between saves of the checkpoint
+        const unsigned m_CheckpointInterval;
+        // the checkpoint of a previous run on slightly different circuits, empty for no ECO
+        const std::string m_EcoFile;
+        // the file of the known (partial) match to assert, empty for none
+        const std::string m_FixedMapFile;
+        // the file of the matches that are not allowed, empty for none
+        const std::string m_ForbiddenPairsFile;
+        // if to eliminate the matches between the blocks of the disjoint-support decompositions of the outputs
+        const bool m_UseDsd;
+        // the max number of inputs of a block that is decomposed exactly by simulation
+        const unsigned m_DsdMaxExactBlockSize;
+        // if to eliminate the matches between inputs with different exact invariants, decided by SAT calls
+        // the symmetry classes for compressing symmetric matches are then also taken from the invariants
+        const bool m_UseExactInvariants;
+        // the number of threads that decide the invariants of each circuit
+        const unsigned m_NumOfInvariantThreads;
   
 		
         // *** Variables ***
@@ -90,11 +240,79 @@ class BoolMatchAlgGenEnumerBase : public BoolMatchAlgBase
         // the match matrix for the src-trg inputs
         BoolMatchMatrixBase* m_InputMatchMatrix;
 
+        // the fixed and forbidden matches asserted on the matrices, and the feasible matches they leave
+        BoolMatchForbiddenPairs* m_ForbiddenPairs;
+
         // cir simulation component for the src and trg circuits
         CirSim* m_SrcCirSimulation;
         CirSim* m_TrgCirSimulation;
 
+        // inputs signatures for the src and trg circuits, used for the input similarity
+        CirInputSig* m_SrcInputSig;
+        CirInputSig* m_TrgInputSig;
+
+        // exact inputs invariants for the src and trg circuits, used with "/alg/use_exact_invariants"
+        BoolMatchInputInvariants* m_SrcInputInvariants;
+        BoolMatchInputInvariants* m_TrgInputInvariants;
+
+        // structural fingerprints for the src and trg circuits, used with "/alg/use_struct_sig"
+        CirStructSig* m_SrcStructSig;
+        CirStructSig* m_TrgStructSig;
+
+        // symmetry classes (matrix indexes) for the src and trg circuits, used for compressing symmetric matches
+        std::vector<std::vector<int>> m_SrcSymClasses;
+        std::vector<std::vector<int>> m_TrgSymClasses;
+        // the position of the symmetry class of each src and trg input, -1 if the input is not in any class
+        std::vector<int> m_SrcSymClassOfInput;
+        std::vector<int> m_TrgSymClassOfInput;
+
+        // the disjoint cubes of valid matches counted so far, used for the exact count
+        BoolMatchValidCubes* m_ValidCubes;
+
+        // the shared state of a parallel run, nullptr if the run is not parallel
+        BoolMatchParallelState* m_ParallelState;
+        // the id of the worker in a parallel run
+        unsigned m_WorkerId;
+        // the current cube (partial match) of the match space the worker search in
+        MatrixIndexVecMatch m_WorkCube;
+        size_t m_WorkCubeId;
+        // the position of the next shared witness to block
+        size_t m_NextSharedWitness;
+
+        // the enumeration state for checkpoint and resume, nullptr if none of them is used
+        BoolMatchCheckpoint* m_Checkpoint;
+        // if the loaded state still need to be applied to the matrices
+        bool m_IsResumePending;
+        // the time of the last checkpoint save
+        std::chrono::steady_clock::time_point m_LastCheckpointTime;
+
+
+        // if the current matches are of the negated target output, used with negated map to the output
+        bool m_IsOutputNegMatch;
+        // the solvers with a mitter on the outputs, and if each of them is dual
+        std::vector<std::pair<BoolMatchSolverBase*, bool>> m_OutputMitterSolvers;
+        // bit-parallel simulation of the src and trg circuits for the output value of the witnesses, used with negated map to the output
+        CirBitSim* m_SrcOutputBitSim;
+        CirBitSim* m_TrgOutputBitSim;
+        // the src and trg values of the witnesses of the positive output, by their output value
+        std::array<std::vector<MULT_INDX_ASSIGNMENT>, 2> m_SrcWitnessValsByOutput;
+        std::array<std::vector<MULT_INDX_ASSIGNMENT>, 2> m_TrgWitnessValsByOutput;
+        // the witnesses of the negated output made from the witnesses of the positive output, not blocked yet
+        std::vector<std::pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>> m_NegOutputWitnesses;
+
 
 		// *** Stats ***
 
+        // the number of valid matches of the positive [0] and the negated [1] target output
+        std::array<unsigned long long, 2> m_NumOfValidMatchesByOutput;
+        // the number of disjoint valid cubes of the positive output, since the cubes are counted again for the negated output
+        size_t m_NumOfPosOutputValidMatchCubes;
+        // the number of witnesses of the negated output made from the witnesses of the positive output
+        unsigned long long m_NumOfSharedOutputWitnesses;
+
+        // the number of witnesses and valid matches in the ECO checkpoint, and the number of them kept
+        unsigned long long m_NumOfEcoWitnesses;
+        unsigned long long m_NumOfEcoKeptWitnesses;
+        unsigned long long m_NumOfEcoValidMatches;
+        unsigned long long m_NumOfEcoKeptValidMatches;
 };
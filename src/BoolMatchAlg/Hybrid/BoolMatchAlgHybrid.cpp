@@ -0,0 +1,168 @@
+#include "BoolMatchAlg/Hybrid/BoolMatchAlgHybrid.hpp"
+
+#include <chrono>
+
+using namespace std;
+
+BoolMatchAlgHybrid::BoolMatchAlgHybrid(const InputParser& inputParser):
+BoolMatchAlgBlockTseitinEnc(inputParser),
+// default is 32 steps
+m_HybridWindow(max(inputParser.getUintCmdOption("/alg/hybrid/window", 32), (unsigned)1)),
+m_NumOfIterSteps(0),
+m_NumOfBlockSteps(0),
+m_NumOfSwitches(0)
+{
+    if (m_NumOfGenThreads > 0)
+    {
+        throw runtime_error("Generalization threads are not supported by the hybrid algorithm");
+    }
+}
+
+void BoolMatchAlgHybrid::PrintInitialInformation()
+{
+    BoolMatchAlgBlockTseitinEnc::PrintInitialInformation();
+
+    cout << "c Use hybrid of iterative and blocking steps, window of " << m_HybridWindow << " steps" << endl;
+}
+
+void BoolMatchAlgHybrid::PrintResult(bool wasInterrupted)
+{
+    BoolMatchAlgBlockTseitinEnc::PrintResult(wasInterrupted);
+
+    cout << "c Hybrid iterative steps: " << m_NumOfIterSteps << ", blocking steps: " << m_NumOfBlockSteps << ", switches: " << m_NumOfSwitches << endl;
+}
+
+void BoolMatchAlgHybrid::FindAllMatchesUnderOutputAssert()
+{
+    // if we use match selector we need to add it to the assumption
+    vector<SATLIT> assump = {m_InputMatchMatrix->GetMatchSelector()};
+    // restrict the matches to the work cube in a parallel run
+    vector<SATLIT> workCubeAssump = GetWorkCubeAssump(m_InputMatchMatrix);
+    assump.insert(assump.end(), workCubeAssump.begin(), workCubeAssump.end());
+
+    const vector<SATLIT> validWorkCubeAssump = GetWorkCubeAssump(m_OnlyValidMatchMatrix);
+
+    unsigned numOfNonValidMatch = 0;
+
+    unsigned lastMaxVal = m_MaxValApprxStratInitVal;
+
+    // start with blocking steps, the iterative steps are tried after the first window
+    bool useIterStep = false;
+    // the time of a single step in the last window of iterative steps, 0 if not measured yet
+    double lastIterStepTime = 0;
+
+    unsigned windowSteps = 0;
+    unsigned windowValid = 0;
+    auto windowStart = chrono::steady_clock::now();
+
+    BlockSharedWitnesses(m_OnlyValidMatchMatrix);
+
+    while (!IsStopRequested())
+    {
+        if (useIterStep)
+        {
+            // take a candidate that is not known to be non-valid
+            SOLVER_RET_STATUS nextCandStatus = m_OnlyValidMatchMatrix->FindNextMatch(validWorkCubeAssump);
+            if (nextCandStatus == TIMEOUT_RET_STATUS)
+            {
+                m_IsTimeOut = true;
+                throw runtime_error("Timeout reached");
+            }
+            if (nextCandStatus != SAT_RET_STATUS)
+            {
+                // all the matches were checked
+                break;
+            }
+
+            m_TotalNumberOfMatches++;
+            m_NumOfIterSteps++;
+
+            MatrixIndexVecMatch candMatch = m_OnlyValidMatchMatrix->GetCurrMatch();
+            vector<SATLIT> candAssump = assump;
+            vector<SATLIT> candMatchAssump = m_InputMatchMatrix->GetMatchAssump(candMatch);
+            candAssump.insert(candAssump.end(), candMatchAssump.begin(), candMatchAssump.end());
+
+            if (CheckSolverUnderAssump(m_Solver, candAssump, m_UseMaxValApprxStrat, lastMaxVal, m_MaxValApprxStratBoostVal))
+            {
+                windowValid++;
+                HandleValidMatch(candMatch);
+
+                if (m_StopAtFirstValidMatch)
+                {
+                    return;
+                }
+            }
+            else
+            {
+                numOfNonValidMatch++;
+                BlockCurrNonValidWitness();
+            }
+        }
+        else
+        {
+            if (CheckSolverUnderAssump(m_Solver, assump, m_UseMaxValApprxStrat, lastMaxVal, m_MaxValApprxStratBoostVal))
+            {
+                // no non-valid match is left
+                break;
+            }
+
+            m_TotalNumberOfMatches++;
+            m_NumOfBlockSteps++;
+            numOfNonValidMatch++;
+            BlockCurrNonValidWitness();
+        }
+
+        if (m_UseMaxValApprxStrat && m_UseAdapForMaxValApprxStrat)
+        {
+            // try to switch between 0 and 1
+            lastMaxVal = m_InputMatchMatrix->GetLastMaxVal() > 0 ? 0 : 1;
+        }
+
+        BlockSharedWitnesses(m_OnlyValidMatchMatrix);
+
+        if (++windowSteps < m_HybridWindow)
+        {
+            continue;
+        }
+
+        auto windowEnd = chrono::steady_clock::now();
+        const double stepTime = chrono::duration<double>(windowEnd - windowStart).count() / windowSteps;
+
+        bool toSwitch = false;
+        if (useIterStep)
+        {
+            lastIterStepTime = stepTime;
+            // most of the candidates are non-valid, so the blocking steps are better
+            toSwitch = (double)windowValid / windowSteps < HYBRID_MIN_VALID_RATIO;
+        }
+        else
+        {
+            // try the iterative steps once, and again whenever they were cheaper than the blocking steps
+            toSwitch = lastIterStepTime == 0 || lastIterStepTime < stepTime;
+        }
+
+        if (toSwitch)
+        {
+            useIterStep = !useIterStep;
+            m_NumOfSwitches++;
+        }
+
+        windowSteps = 0;
+        windowValid = 0;
+        windowStart = windowEnd;
+    }
+
+    // in a parallel run the workers report the results at the end
+    if (m_ParallelState == nullptr)
+    {
+        cout << "c Finished blocking " << numOfNonValidMatch << " non-valid matches" << endl;
+    }
+
+    if (m_StopAfterBlockingAllNonValidMatches)
+    {
+        return;
+    }
+
+    // the valid matches found by the iterative steps were eliminated, so only the rest are enumerated
+    EnumerateValidMatches();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "BoolMatchAlg/Blocking/TseitinEnc/BoolMatchAlgBlockTseitinEnc.hpp"
+
+/*
+    boolean matching that switch at runtime between iterative (EBatP) and blocking (EBatC) steps
+    an iterative step take a candidate from the matrix of the matches that are not known to be non-valid and check it
+    a blocking step ask the solver for any non-valid match
+    both steps use the same solver and matrices, so the blocked witnesses and the valid matches found are kept when switching
+    the steps are switched every window by the valid to non-valid ratio of the candidates and the time of every step
+*/
+class BoolMatchAlgHybrid : public BoolMatchAlgBlockTseitinEnc
+{
+    public:
+
+        BoolMatchAlgHybrid(const InputParser& inputParser);
+
+        void PrintResult(bool wasInterrupted = false) override;
+
+    protected:
+
+        // print initial information, timeout etc..
+        void PrintInitialInformation() override;
+
+        void FindAllMatchesUnderOutputAssert() override;
+
+        // *** Params ***
+
+        // the number of steps before checking if to switch
+        const unsigned m_HybridWindow;
+
+        // below this ratio of valid candidates the iterative steps are stopped, since the blocking steps find the non-valid matches directly
+        static constexpr double HYBRID_MIN_VALID_RATIO = 0.5;
+
+		// *** Stats ***
+
+        unsigned long m_NumOfIterSteps;
+        unsigned long m_NumOfBlockSteps;
+        unsigned long m_NumOfSwitches;
+};
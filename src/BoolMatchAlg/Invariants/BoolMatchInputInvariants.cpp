@@ -0,0 +1,411 @@
+#include "BoolMatchAlg/Invariants/BoolMatchInputInvariants.hpp"
+
+#include <random>
+#include <thread>
+
+#include "BoolMatchSolver/Solvers.hpp"
+#include "CirSimulation/CirBitSim.hpp"
+
+using namespace std;
+
+// get the number of E -or- NE symmetric pairs of every input, -1 if any pair of the input is unknown
+static vector<int> GetSymDegrees(const vector<vector<TVal>>& isSym)
+{
+    vector<int> symDegrees(isSym.size(), 0);
+    for (size_t i = 0; i < isSym.size(); i++)
+    {
+        for (size_t j = 0; j < isSym.size() && symDegrees[i] >= 0; j++)
+        {
+            if (i == j)
+            {
+                continue;
+            }
+
+            if (isSym[i][j] == TVal::UnKown)
+            {
+                symDegrees[i] = -1;
+            }
+            else if (isSym[i][j] == TVal::True)
+            {
+                symDegrees[i]++;
+            }
+        }
+    }
+
+    return symDegrees;
+}
+
+// return true if both values are known and differ
+static bool IsKnownDiff(TVal val1, TVal val2)
+{
+    return IsTValBoolVal(val1) && IsTValBoolVal(val2) && val1 != val2;
+}
+
+
+BoolMatchInputInvariants::BoolMatchInputInvariants(const InputParser& inputParser, const AigerParser& aigParser, unsigned numOfThreads, bool isSupportOnly):
+m_InputParser(inputParser),
+m_AigParser(aigParser),
+m_Inputs(aigParser.GetInputs()),
+m_IsSupportOnly(isSupportOnly),
+m_NextQuery(0),
+m_NumOfSATCalls(0)
+{
+    const size_t inputSize = m_Inputs.size();
+
+    m_IsInSupport.assign(inputSize, TVal::UnKown);
+    m_IsPosUnate.assign(inputSize, TVal::UnKown);
+    m_IsNegUnate.assign(inputSize, TVal::UnKown);
+    m_IsSym.assign(inputSize, vector<TVal>(inputSize, TVal::UnKown));
+    m_IsNegSym.assign(inputSize, vector<TVal>(inputSize, TVal::UnKown));
+
+    // an input out of the output cone is not in the support without a SAT call
+    vector<bool> isIndexInCone((size_t)aigParser.GetMaxIndex() + 1, false);
+    for (const AIGLIT outLit : aigParser.GetOutputs())
+    {
+        isIndexInCone[AIGLitToAIGIndex(outLit)] = true;
+    }
+    // we assume the gates are in order from bottom-up
+    const vector<AigAndGate>& andGates = aigParser.GetAndGated();
+    for (auto gateRevIt = andGates.rbegin(); gateRevIt != andGates.rend(); ++gateRevIt)
+    {
+        if (isIndexInCone[AIGLitToAIGIndex(gateRevIt->GetL())])
+        {
+            isIndexInCone[AIGLitToAIGIndex(gateRevIt->GetR0())] = true;
+            isIndexInCone[AIGLitToAIGIndex(gateRevIt->GetR1())] = true;
+        }
+    }
+    for (size_t i = 0; i < inputSize; i++)
+    {
+        if (!isIndexInCone[AIGLitToAIGIndex(m_Inputs[i])])
+        {
+            m_IsInSupport[i] = TVal::False;
+            m_IsPosUnate[i] = TVal::True;
+            m_IsNegUnate[i] = TVal::True;
+        }
+    }
+
+    for (size_t i = 0; i < inputSize && !m_IsSupportOnly; i++)
+    {
+        for (size_t j = i + 1; j < inputSize; j++)
+        {
+            m_Pairs.push_back({i, j});
+        }
+    }
+
+    vector<thread> workers;
+    for (unsigned t = 0; t < max(numOfThreads, (unsigned)1); t++)
+    {
+        workers.emplace_back(&BoolMatchInputInvariants::RunWorker, this);
+    }
+
+    for (thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void BoolMatchInputInvariants::RunWorker()
+{
+    const size_t inputSize = m_Inputs.size();
+
+    // the circuit against itself, where the outputs differ
+    BoolMatchSolverTopor solver(m_InputParser, CirEncoding::TSEITIN_ENC, false);
+    solver.InitializeSolverFromAIG(m_AigParser, m_AigParser);
+    solver.AssertOutputDiff(false);
+
+    const vector<SATLIT> srcInputLits = solver.GetLitsFromAIGInputs(m_Inputs, true);
+    const vector<SATLIT> trgInputLits = solver.GetLitsFromAIGInputs(m_Inputs, false);
+    const SATLIT srcOutputLit = solver.GetLitsFromAIGInputs(m_AigParser.GetOutputs(), true)[0];
+
+    // the same patterns in every worker
+    CirBitSim bitSim(m_AigParser);
+    mt19937_64 randGen(0);
+
+    vector<vector<uint64_t>> simInputsVal(NUM_OF_SIM_WORDS, vector<uint64_t>(inputSize));
+    vector<uint64_t> simOutVal(NUM_OF_SIM_WORDS);
+    for (unsigned w = 0; w < NUM_OF_SIM_WORDS; w++)
+    {
+        for (size_t i = 0; i < inputSize; i++)
+        {
+            simInputsVal[w][i] = randGen();
+        }
+        simOutVal[w] = bitSim.SimulateOutput(simInputsVal[w]);
+    }
+
+    // UNSAT means the outputs can not differ, i.e. the property holds
+    auto isAlwaysEqual = [&](vector<SATLIT>& assump) -> TVal
+    {
+        m_NumOfSATCalls++;
+
+        SOLVER_RET_STATUS res = solver.SolveUnderAssump(assump);
+        if (res == UNSAT_RET_STATUS)
+        {
+            return TVal::True;
+        }
+        else if (res == SAT_RET_STATUS)
+        {
+            return TVal::False;
+        }
+
+        // a timeout etc.. leave the query unknown
+        return TVal::UnKown;
+    };
+
+    // the inputs of both copies are equal, except for inputs i and j
+    auto getEqAssump = [&](size_t i, size_t j) -> vector<SATLIT>
+    {
+        vector<SATLIT> assump;
+        for (size_t k = 0; k < inputSize; k++)
+        {
+            if (k != i && k != j)
+            {
+                assump.push_back(solver.GetInputEqAssmp(m_Inputs[k], m_Inputs[k], true));
+            }
+        }
+        return assump;
+    };
+
+    for (size_t query = m_NextQuery++; query < inputSize + m_Pairs.size(); query = m_NextQuery++)
+    {
+        if (query < inputSize)
+        {
+            const size_t x = query;
+            if (m_IsInSupport[x] == TVal::False)
+            {
+                continue;
+            }
+
+            // a pattern where the output falls (rises) when the input rises is a witness that the input is not positive (negative) unate
+            uint64_t posUnateWitness = 0;
+            uint64_t negUnateWitness = 0;
+            for (unsigned w = 0; w < NUM_OF_SIM_WORDS; w++)
+            {
+                vector<uint64_t> inputsVal = simInputsVal[w];
+                inputsVal[x] = 0;
+                const uint64_t outValWhenFalse = bitSim.SimulateOutput(inputsVal);
+                inputsVal[x] = ~0ULL;
+                const uint64_t outValWhenTrue = bitSim.SimulateOutput(inputsVal);
+
+                posUnateWitness |= outValWhenFalse & ~outValWhenTrue;
+                negUnateWitness |= ~outValWhenFalse & outValWhenTrue;
+            }
+
+            if (posUnateWitness != 0)
+            {
+                m_IsPosUnate[x] = TVal::False;
+            }
+            if (negUnateWitness != 0)
+            {
+                m_IsNegUnate[x] = TVal::False;
+            }
+            if (posUnateWitness != 0 || negUnateWitness != 0)
+            {
+                m_IsInSupport[x] = TVal::True;
+            }
+
+            // the input rises from the src copy to the trg copy
+            vector<SATLIT> assump = getEqAssump(x, x);
+            assump.push_back(NegateSATLit(srcInputLits[x]));
+            assump.push_back(trgInputLits[x]);
+
+            if (m_IsInSupport[x] == TVal::UnKown)
+            {
+                const TVal isNotInSupport = isAlwaysEqual(assump);
+                if (isNotInSupport == TVal::True)
+                {
+                    // the output does not depend on the input, so it is both positive and negative unate
+                    m_IsInSupport[x] = TVal::False;
+                    m_IsPosUnate[x] = TVal::True;
+                    m_IsNegUnate[x] = TVal::True;
+                    continue;
+                }
+                else if (isNotInSupport == TVal::UnKown)
+                {
+                    continue;
+                }
+                m_IsInSupport[x] = TVal::True;
+            }
+
+            if (m_IsSupportOnly)
+            {
+                continue;
+            }
+
+            if (m_IsPosUnate[x] == TVal::UnKown)
+            {
+                assump.push_back(srcOutputLit);
+                m_IsPosUnate[x] = isAlwaysEqual(assump);
+                assump.pop_back();
+            }
+            if (m_IsNegUnate[x] == TVal::UnKown)
+            {
+                assump.push_back(NegateSATLit(srcOutputLit));
+                m_IsNegUnate[x] = isAlwaysEqual(assump);
+                assump.pop_back();
+            }
+        }
+        else
+        {
+            const size_t x = m_Pairs[query - inputSize].first;
+            const size_t y = m_Pairs[query - inputSize].second;
+
+            for (bool isNegSym : {false, true})
+            {
+                bool isSimSym = true;
+                for (unsigned w = 0; w < NUM_OF_SIM_WORDS && isSimSym; w++)
+                {
+                    vector<uint64_t> swappedVal = simInputsVal[w];
+                    swappedVal[x] = isNegSym ? ~simInputsVal[w][y] : simInputsVal[w][y];
+                    swappedVal[y] = isNegSym ? ~simInputsVal[w][x] : simInputsVal[w][x];
+                    isSimSym = bitSim.SimulateOutput(swappedVal) == simOutVal[w];
+                }
+
+                TVal isSym = TVal::False;
+                if (isSimSym)
+                {
+                    vector<SATLIT> assump = getEqAssump(x, y);
+                    assump.push_back(solver.GetInputEqAssmp(m_Inputs[x], m_Inputs[y], !isNegSym));
+                    assump.push_back(solver.GetInputEqAssmp(m_Inputs[y], m_Inputs[x], !isNegSym));
+                    isSym = isAlwaysEqual(assump);
+                }
+
+                vector<vector<TVal>>& isSymOfPair = isNegSym ? m_IsNegSym : m_IsSym;
+                isSymOfPair[x][y] = isSym;
+                isSymOfPair[y][x] = isSym;
+            }
+        }
+    }
+}
+
+MatrixIndexVecMatch BoolMatchInputInvariants::GetForbiddenMatches(const BoolMatchInputInvariants& srcInvariants, const BoolMatchInputInvariants& trgInvariants,
+    bool allowInputNegMap, bool allowOutputNegMap)
+{
+    const size_t inputSize = srcInvariants.m_Inputs.size();
+
+    const vector<int> srcSymDegrees = GetSymDegrees(srcInvariants.m_IsSym);
+    const vector<int> srcNegSymDegrees = GetSymDegrees(srcInvariants.m_IsNegSym);
+    const vector<int> trgSymDegrees = GetSymDegrees(trgInvariants.m_IsSym);
+    const vector<int> trgNegSymDegrees = GetSymDegrees(trgInvariants.m_IsNegSym);
+
+    // a negated match swaps the unateness of the trg input
+    auto isUnateDiff = [&](size_t x, size_t y, bool isPos) -> bool
+    {
+        const TVal trgPosUnate = isPos ? trgInvariants.m_IsPosUnate[y] : trgInvariants.m_IsNegUnate[y];
+        const TVal trgNegUnate = isPos ? trgInvariants.m_IsNegUnate[y] : trgInvariants.m_IsPosUnate[y];
+        return IsKnownDiff(srcInvariants.m_IsPosUnate[x], trgPosUnate) || IsKnownDiff(srcInvariants.m_IsNegUnate[x], trgNegUnate);
+    };
+
+    auto isSymDiff = [&](size_t x, size_t y) -> bool
+    {
+        if (srcSymDegrees[x] < 0 || srcNegSymDegrees[x] < 0 || trgSymDegrees[y] < 0 || trgNegSymDegrees[y] < 0)
+        {
+            return false;
+        }
+
+        // with negated matches an E symmetric pair may be matched to a NE symmetric pair
+        if (allowInputNegMap)
+        {
+            return srcSymDegrees[x] + srcNegSymDegrees[x] != trgSymDegrees[y] + trgNegSymDegrees[y];
+        }
+        return srcSymDegrees[x] != trgSymDegrees[y] || srcNegSymDegrees[x] != trgNegSymDegrees[y];
+    };
+
+    MatrixIndexVecMatch forbiddenMatches;
+    for (size_t x = 0; x < inputSize; x++)
+    {
+        for (size_t y = 0; y < inputSize; y++)
+        {
+            // the support and the symmetries do not change with the polarity of the match or the output
+            const bool isForbidden = IsKnownDiff(srcInvariants.m_IsInSupport[x], trgInvariants.m_IsInSupport[y]) || isSymDiff(x, y);
+
+            for (bool isPos : {true, false})
+            {
+                if (!isPos && !allowInputNegMap)
+                {
+                    continue;
+                }
+
+                // a negated output swaps the unateness of the trg output, as a negated match does
+                const bool isUnateForbidden = isUnateDiff(x, y, isPos) && (!allowOutputNegMap || isUnateDiff(x, y, !isPos));
+
+                if (isForbidden || isUnateForbidden)
+                {
+                    // the matrix indexes are 1-based
+                    forbiddenMatches.push_back({PosToIndex(x), isPos ? PosToIndex(y) : -PosToIndex(y)});
+                }
+            }
+        }
+    }
+
+    return forbiddenMatches;
+}
+
+vector<bool> BoolMatchInputInvariants::GetIrrelevantInputs() const
+{
+    vector<bool> isIrrelevant(m_Inputs.size(), false);
+    for (size_t i = 0; i < m_Inputs.size(); i++)
+    {
+        isIrrelevant[i] = m_IsInSupport[i] == TVal::False;
+    }
+
+    return isIrrelevant;
+}
+
+vector<vector<int>> BoolMatchInputInvariants::GetSymClasses() const
+{
+    // swap symmetry is an equivalence relation, so it is enough to check against the first input of each class
+    vector<vector<int>> symClasses;
+    for (size_t i = 0; i < m_Inputs.size(); i++)
+    {
+        bool foundClass = false;
+        for (vector<int>& symClass : symClasses)
+        {
+            if (m_IsSym[GetAbsRealIndex(symClass[0])][i] == TVal::True)
+            {
+                symClass.push_back(PosToIndex(i));
+                foundClass = true;
+                break;
+            }
+        }
+
+        if (!foundClass)
+        {
+            symClasses.push_back({PosToIndex(i)});
+        }
+    }
+
+    symClasses.erase(remove_if(symClasses.begin(), symClasses.end(), [](const vector<int>& symClass) { return symClass.size() < 2; }), symClasses.end());
+
+    return symClasses;
+}
+
+size_t BoolMatchInputInvariants::GetNumOfSupportInputs() const
+{
+    return count(m_IsInSupport.begin(), m_IsInSupport.end(), TVal::True);
+}
+
+size_t BoolMatchInputInvariants::GetNumOfUnateInputs() const
+{
+    size_t numOfUnateInputs = 0;
+    for (size_t i = 0; i < m_Inputs.size(); i++)
+    {
+        if (m_IsInSupport[i] == TVal::True && (m_IsPosUnate[i] == TVal::True || m_IsNegUnate[i] == TVal::True))
+        {
+            numOfUnateInputs++;
+        }
+    }
+    return numOfUnateInputs;
+}
+
+size_t BoolMatchInputInvariants::GetNumOfSymPairs() const
+{
+    size_t numOfSymPairs = 0;
+    for (const pair<size_t, size_t>& inputsPair : m_Pairs)
+    {
+        if (m_IsSym[inputsPair.first][inputsPair.second] == TVal::True || m_IsNegSym[inputsPair.first][inputsPair.second] == TVal::True)
+        {
+            numOfSymPairs++;
+        }
+    }
+    return numOfSymPairs;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "Globals/BoolMatchGloblas.hpp"
+#include "Globals/TernaryVal.hpp"
+#include "Aiger/AigerParser.hpp"
+#include "Utilities/InputParser.hpp"
+
+/*
+    exact invariants of the circuit inputs, decided by incremental SAT calls on the circuit against itself (a mitter on the outputs)
+    for every input if it is in the functional support and if it is positive or negative unate, and for every pair of inputs if it is symmetric (E) or negated symmetric (NE)
+    random simulation decides most of the non-unate inputs and non-symmetric pairs, only the rest are checked by SAT
+    the queries are split between worker threads, each with its own solver and simulation
+    unlike the signatures of CirInputSig the invariants are exact, so a match between inputs with different invariants is never valid
+    a query that is not decided (timeout) is left unknown and does not forbid any match
+*/
+class BoolMatchInputInvariants
+{
+public:
+    // isSupportOnly - if to decide only the functional support of the inputs, without the unateness and the symmetries
+    BoolMatchInputInvariants(const InputParser& inputParser, const AigerParser& aigParser, unsigned numOfThreads = DEF_NUM_OF_THREADS, bool isSupportOnly = false);
+
+    // get the matches (matrix indexes) between src and trg inputs with different invariants
+    // allowInputNegMap - if negated matches are allowed, in this case the unateness of the trg input is swapped and the symmetries are counted together
+    // allowOutputNegMap - if the output may be negated, in this case a match is forbidden only if it is forbidden for both output polarities
+    static MatrixIndexVecMatch GetForbiddenMatches(const BoolMatchInputInvariants& srcInvariants, const BoolMatchInputInvariants& trgInvariants,
+        bool allowInputNegMap, bool allowOutputNegMap);
+
+    // get the classes of inputs (matrix indexes) where swapping any two inputs of the class keeps the output, only classes with more than one input are returned
+    std::vector<std::vector<int>> GetSymClasses() const;
+
+    // get for every input (by position) if it is proven that the output does not depend on it
+    std::vector<bool> GetIrrelevantInputs() const;
+
+    size_t GetNumOfSupportInputs() const;
+
+    size_t GetNumOfUnateInputs() const;
+
+    // the number of E and NE symmetric pairs
+    size_t GetNumOfSymPairs() const;
+
+    unsigned long long GetNumOfSATCalls() const { return m_NumOfSATCalls; };
+
+    static const unsigned DEF_NUM_OF_THREADS = 4;
+    // the number of 64 bit random patterns words to filter the queries
+    static const unsigned NUM_OF_SIM_WORDS = 4;
+
+protected:
+
+    // run the queries taken from m_NextQuery until none is left
+    void RunWorker();
+
+    // *** Params ***
+
+    const InputParser& m_InputParser;
+    const AigerParser& m_AigParser;
+    // hold the inputs
+    const std::vector<AIGLIT> m_Inputs;
+    const bool m_IsSupportOnly;
+
+    // *** Variables ***
+
+    // the next query to take, the first queries are of the inputs and the rest are of the pairs
+    std::atomic<size_t> m_NextQuery;
+    // the pairs (i<j) of the queries
+    std::vector<std::pair<size_t, size_t>> m_Pairs;
+
+    // *** Invariants ***
+
+    // for every input if it is in the functional support, if it is positive unate and if it is negative unate
+    std::vector<TVal> m_IsInSupport;
+    std::vector<TVal> m_IsPosUnate;
+    std::vector<TVal> m_IsNegUnate;
+    // for every two inputs if swapping them (E) -or- swapping and negating them (NE) keeps the output
+    std::vector<std::vector<TVal>> m_IsSym;
+    std::vector<std::vector<TVal>> m_IsNegSym;
+
+    // *** Stats ***
+
+    std::atomic<unsigned long long> m_NumOfSATCalls;
+};
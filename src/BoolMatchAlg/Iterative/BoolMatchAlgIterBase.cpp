@@ -1,6 +1,6 @@
 #include "BoolMatchAlg/Iterative/BoolMatchAlgIterBase.hpp"
 
-#include "BoolMatchMatrix/BoolMatchMatrixSingleVars/BoolMatchMatrixSingleVars.hpp"
+#include "BoolMatchMatrix/BoolMatchMatrices.hpp"
 
 using namespace std;
 
@@ -22,8 +22,18 @@ BoolMatchAlgIterBase::~BoolMatchAlgIterBase()
 
 void BoolMatchAlgIterBase::_InitMatchMatrix()
 {
-    MatrixIndexVecMatch initMatch = {};
-    m_InputMatchMatrix = new BoolMatchMatrixSingleVars(m_InputMatchSolver, m_InputSize, m_BlockMatchTypeWithInputsVal, m_AllowInputNegMap, initMatch, false);
+    m_InputMatchMatrix = CreateBoolMatchMatrix(m_MatrixType, m_InputMatchSolver, m_InputSize, m_BlockMatchTypeWithInputsVal, m_AllowInputNegMap, m_ForbiddenPairs->GetFixedMatch(), m_AllowOutputNegMap, m_ForbiddenPairs->GetFeasibleMatches());
+    m_ForbiddenPairs->EliminateForbiddenPairs(m_InputMatchMatrix);
+
+    if (m_CompressSymMatches)
+    {
+        m_InputMatchMatrix->BreakInputSymmetries(m_SrcSymClasses, m_TrgSymClasses);
+    }
+
+    if (m_UseInputSimilarity || m_UseStructSig)
+    {
+        ApplyInputSimilarity(m_InputMatchMatrix);
+    }
 
     if (m_EagerInitInputEqAssump)
     {
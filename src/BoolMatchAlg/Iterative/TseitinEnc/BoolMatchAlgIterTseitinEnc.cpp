@@ -1,5 +1,7 @@
 #include "BoolMatchAlg/Iterative/TseitinEnc/BoolMatchAlgIterTseitinEnc.hpp"
 
+#include <random>
+
 using namespace std;
 
 BoolMatchAlgIterTseitinEnc::BoolMatchAlgIterTseitinEnc(const InputParser& inputParser):
@@ -8,6 +10,12 @@ m_UseIpaisrAsPrimary(inputParser.getBoolCmdOption("/alg/iter/use_ipasir_for_plai
 m_UseIpaisrAsDual(inputParser.getBoolCmdOption("/alg/iter/use_ipasir_for_dual", true)),
 m_UseUcoreForValidMatch(inputParser.getBoolCmdOption("/alg/iter/tseitin/use_ucore_for_valid_match", false))
 {
+    // a partial valid match does not represent a known number of symmetric matches
+    if (m_UseUcoreForValidMatch && m_CompressSymMatches)
+    {
+        throw runtime_error("Can not use UnSAT core for valid match when compressing symmetric matches");
+    }
+
     if (m_UseIpaisrAsPrimary)
     {
         m_Solver = new BoolMatchSolverIpasir(inputParser, CirEncoding::TSEITIN_ENC, false);
@@ -49,13 +57,24 @@ void BoolMatchAlgIterTseitinEnc::PrintInitialInformation()
 
 void BoolMatchAlgIterTseitinEnc::FindAllMatchesUnderOutputAssert()
 {
+    if (m_NumOfSamples > 0)
+    {
+        SampleValidMatches();
+        return;
+    }
+
     // this is to use locally, we also have the global one (m_TotalNumberOfMatches)
     unsigned numOfMatch = 0;
 
     unsigned lastMaxVal = m_MaxValApprxStratInitVal;
 
-    SOLVER_RET_STATUS nextMatch = m_InputMatchMatrix->FindNextMatch();
-    while (nextMatch == SAT_RET_STATUS)
+    // restrict the matches to the work cube in a parallel run
+    const vector<SATLIT> workCubeAssump = GetWorkCubeAssump(m_InputMatchMatrix);
+
+    BlockSharedWitnesses();
+
+    SOLVER_RET_STATUS nextMatch = m_InputMatchMatrix->FindNextMatch(workCubeAssump);
+    while (nextMatch == SAT_RET_STATUS && !IsStopRequested())
     {
         numOfMatch++;
         m_TotalNumberOfMatches++;
@@ -66,98 +85,16 @@ void BoolMatchAlgIterTseitinEnc::FindAllMatchesUnderOutputAssert()
         vector<SATLIT> assump = GetInputMatchAssump(m_Solver, currMatch);
         if (CheckSolverUnderAssump(m_Solver, assump, m_UseMaxValApprxStrat, lastMaxVal, m_MaxValApprxStratBoostVal))
 		{
-            m_NumberOfValidMatches++;
-
-            if (m_UseUcoreForValidMatch)
-            {
-                // will hold the partial map of the inputs suffice for valid mapping, meaning no matter how we complete the rest of the mapping
-                MatrixIndexVecMatch currPartialValidMatch;
-                // NOTE: at this point we know the only assumption used are the matches assumptions, this is important for the UCore extraction
-                // go over the match assumptions and try to remove
-                for (size_t matchIndex = 0; matchIndex < currMatch.size(); matchIndex++)
-                {
-                    if (m_Solver->IsAssumptionRequired(matchIndex))
-                    {
-                        currPartialValidMatch.push_back(currMatch[matchIndex]);
-                    }
-                }
-
-                //TODO add param
-                // now do minimal unsat core with drop lit
-                // iterating from back to begin to support remove and iteration of vector
-                for (int matchIndex = currPartialValidMatch.size() - 1; matchIndex >= 0; --matchIndex) 
-                {
-                    // Temporary store the current match
-                    MatrixIndexMatch tempMatch = currPartialValidMatch[matchIndex];
-
-                    // Remove the current lit from the, copy the last element
-                    currPartialValidMatch[matchIndex] = currPartialValidMatch.back();
-                    currPartialValidMatch.pop_back();
-
-                    vector<SATLIT> currAssump = GetInputMatchAssump(m_Solver, currPartialValidMatch);
-                    if (CheckSolverUnderAssump(m_Solver, currAssump)) 
-                    {
-                        // this mean we manage to remove the match from the core
-                        // TODO add here recurisve unsat core extraction?			
-                    } 
-                    else 
-                    {
-                        // we can not remove the match from the core
-                        // restore the lit to the vector, where the position is changed (should not be a problem)
-                        currPartialValidMatch.push_back(tempMatch);
-                    }
-                }
-
-                // NOTE: some debug print
-                // if (currMatch.size() > currPartialValidMatch.size())
-                // {
-                //     cout << "Managed to generalize to partial valid match with UCore from: " << to_string(currMatch.size()) << "->" << to_string(currPartialValidMatch.size()) << endl;
-                // }
-                // NOTE: should we iterate and create the full matches form the partial?
-                currMatch = currPartialValidMatch;
-
-                // check if we manage to generalize the match to tautology
-                if (currMatch.size() == 0)
-                {
-                    // we have a tautology
-                    cout << "c Found tautology when using UnSAT core for valid matches" << endl;
-                }
-            }
-            
-            if (m_PrintMatches)
-            {
-                PrintMatrixIndexMatchAsAIG(currMatch);
-            }
+            HandleValidMatch(currMatch, m_UseUcoreForValidMatch ? m_Solver : nullptr, m_InputMatchMatrix);
 
             if (m_StopAtFirstValidMatch)
             {
                 return;
             }
-
-            m_InputMatchMatrix->EliminateMatch(currMatch);
         }
         else
         {
-            // print the counter example
-            //cout << "c Match is invalid" << endl;
-            INPUT_ASSIGNMENT srcAssg = m_Solver->GetAssignmentForAIGLits(m_SrcInputs, true);
-            INPUT_ASSIGNMENT trgAssg = m_Solver->GetAssignmentForAIGLits(m_TrgInputs, false);
-            
-            // PrintModel(srcAssg);
-            // PrintModel(trgAssg);
-
-            clock_t beforeGen = clock();
-            pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> srcAndTrgGen = GeneralizeModel(srcAssg, trgAssg);
-            unsigned long genCpuTimeTaken =  clock() - beforeGen;
-            double genTime = (double)(genCpuTimeTaken)/(double)(CLOCKS_PER_SEC);
-
-            m_TimeOnGeneralization += genTime;
-
-            // cout << "c After generalization" << endl;
-            // PrintModel(srcGenAssignment);
-            // PrintModel(trgGenAssignment);
-
-            m_InputMatchMatrix->BlockMatchesByInputsVal(InputAssg2Indx(srcAndTrgGen.first, true), InputAssg2Indx(srcAndTrgGen.second, false));
+            BlockCurrNonValidMatch();
         }
 
         if (m_UseMaxValApprxStrat && m_UseAdapForMaxValApprxStrat)
@@ -167,7 +104,9 @@ void BoolMatchAlgIterTseitinEnc::FindAllMatchesUnderOutputAssert()
             // lastMaxVal = m_InputMatchMatrix->GetLastMaxVal();
         }
 
-        nextMatch = m_InputMatchMatrix->FindNextMatch();
+        BlockSharedWitnesses();
+
+        nextMatch = m_InputMatchMatrix->FindNextMatch(workCubeAssump);
     }
 
     // check for timeout
@@ -176,4 +115,169 @@ void BoolMatchAlgIterTseitinEnc::FindAllMatchesUnderOutputAssert()
         m_IsTimeOut = true;
 		throw runtime_error("Timeout reached");
     }
-}
\ No newline at end of file
+}
+
+void BoolMatchAlgIterTseitinEnc::BlockCurrNonValidMatch()
+{
+    // print the counter example
+    //cout << "c Match is invalid" << endl;
+    INPUT_ASSIGNMENT srcAssg = m_Solver->GetAssignmentForAIGLits(m_SrcInputs, true);
+    INPUT_ASSIGNMENT trgAssg = m_Solver->GetAssignmentForAIGLits(m_TrgInputs, false);
+    
+    // PrintModel(srcAssg);
+    // PrintModel(trgAssg);
+
+    clock_t beforeGen = ThreadClock();
+    pair<INPUT_ASSIGNMENT, INPUT_ASSIGNMENT> srcAndTrgGen = GeneralizeModel(srcAssg, trgAssg);
+    unsigned long genCpuTimeTaken =  ThreadClock() - beforeGen;
+    double genTime = (double)(genCpuTimeTaken)/(double)(CLOCKS_PER_SEC);
+
+    m_TimeOnGeneralization += genTime;
+
+    // cout << "c After generalization" << endl;
+    // PrintModel(srcGenAssignment);
+    // PrintModel(trgGenAssignment);
+
+    BlockWitness(InputAssg2Indx(srcAndTrgGen.first, true), InputAssg2Indx(srcAndTrgGen.second, false));
+}
+
+vector<MatrixIndexVecMatch> BoolMatchAlgIterTseitinEnc::FindCellValidMatches(const vector<SATLIT>& xorLits)
+{
+    // the valid matches of the cell are eliminated only under this lit
+    vector<SATLIT> cellAssump = xorLits;
+    SATLIT cellElimLit = m_InputMatchSolver->GetNewVar();
+    cellAssump.push_back(cellElimLit);
+
+    vector<MatrixIndexVecMatch> cellValidMatches;
+    SOLVER_RET_STATUS nextMatch = m_InputMatchMatrix->FindNextMatch(cellAssump);
+    while (nextMatch == SAT_RET_STATUS)
+    {
+        m_TotalNumberOfMatches++;
+
+        MatrixIndexVecMatch currMatch = m_InputMatchMatrix->GetCurrMatch();
+
+        vector<SATLIT> assump = GetInputMatchAssump(m_Solver, currMatch);
+        if (CheckSolverUnderAssump(m_Solver, assump))
+        {
+            cellValidMatches.push_back(currMatch);
+            if (cellValidMatches.size() > SAMPLE_CELL_MAX_SIZE)
+            {
+                break;
+            }
+            m_InputMatchMatrix->EliminateMatchUnderAssump(currMatch, cellElimLit);
+        }
+        else
+        {
+            BlockCurrNonValidMatch();
+        }
+
+        nextMatch = m_InputMatchMatrix->FindNextMatch(cellAssump);
+    }
+
+    if (nextMatch == TIMEOUT_RET_STATUS)
+    {
+        m_IsTimeOut = true;
+        throw runtime_error("Timeout reached");
+    }
+
+    m_InputMatchSolver->AddClause(NegateSATLit(cellElimLit));
+
+    return cellValidMatches;
+}
+
+void BoolMatchAlgIterTseitinEnc::SampleValidMatches()
+{
+    mt19937_64 randGen(m_SampleSeed);
+
+    // the number of XOR constraints of the last cell, the search of the next sample starts from it
+    unsigned numOfXors = 0;
+    unsigned numOfSamples = 0;
+    bool isNoValidMatchLeft = false;
+
+    while (numOfSamples < m_NumOfSamples && !isNoValidMatchLeft)
+    {
+        // new constraints for every sample, created only when a cell needs them
+        vector<SATLIT> xorLits;
+        vector<MatrixIndexVecMatch> cellValidMatches;
+        auto findCell = [&](unsigned k)
+        {
+            while (xorLits.size() < k)
+            {
+                xorLits.push_back(m_InputMatchMatrix->AddRandomXorConstraint(randGen));
+            }
+            cellValidMatches = FindCellValidMatches(vector<SATLIT>(xorLits.begin(), xorLits.begin() + k));
+        };
+        auto isCellTooLarge = [&]() { return cellValidMatches.size() > SAMPLE_CELL_MAX_SIZE; };
+
+        // a cell with more XORs is smaller, so the search keeps a too large bound (lo) and an empty bound (hi), -1 if not found yet
+        int lo = -1;
+        int hi = -1;
+        findCell(numOfXors);
+        for (unsigned step = 1; !cellValidMatches.empty() && isCellTooLarge(); step *= 2)
+        {
+            lo = (int)numOfXors;
+            numOfXors += step;
+            findCell(numOfXors);
+        }
+        for (unsigned step = 1; cellValidMatches.empty(); step *= 2)
+        {
+            hi = (int)numOfXors;
+            if (numOfXors == 0 || lo >= 0)
+            {
+                break;
+            }
+            numOfXors = numOfXors > step ? numOfXors - step : 0;
+            findCell(numOfXors);
+            if (isCellTooLarge())
+            {
+                lo = (int)numOfXors;
+                break;
+            }
+        }
+        while (lo >= 0 && hi >= 0 && hi - lo > 1)
+        {
+            numOfXors = (unsigned)((lo + hi) / 2);
+            findCell(numOfXors);
+            if (isCellTooLarge())
+            {
+                lo = (int)numOfXors;
+            }
+            else if (cellValidMatches.empty())
+            {
+                hi = (int)numOfXors;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        // remove the constraints of the sample
+        for (SATLIT lit : xorLits)
+        {
+            m_InputMatchSolver->AddClause(NegateSATLit(lit));
+        }
+
+        if (cellValidMatches.empty() && numOfXors == 0)
+        {
+            isNoValidMatchLeft = true;
+            continue;
+        }
+        if (cellValidMatches.empty() || isCellTooLarge())
+        {
+            // one more XOR emptied a too large cell, try again with new constraints
+            continue;
+        }
+
+        // pick a random valid match of the cell, and do not sample it again
+        MatrixIndexVecMatch sampledMatch = cellValidMatches[randGen() % cellValidMatches.size()];
+        numOfSamples++;
+        m_NumberOfValidMatches++;
+
+        PrintMatrixIndexMatchAsAIG(sampledMatch);
+
+        m_InputMatchMatrix->EliminateMatch(sampledMatch);
+    }
+
+    cout << "c Sampled " << numOfSamples << " valid matches, number of XOR constraints in the last cell: " << numOfXors << endl;
+}
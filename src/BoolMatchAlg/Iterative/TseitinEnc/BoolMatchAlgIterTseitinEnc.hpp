@@ -19,6 +19,18 @@ class BoolMatchAlgIterTseitinEnc : public BoolMatchAlgIterBase
         virtual void PrintInitialInformation();
 
         virtual void FindAllMatchesUnderOutputAssert();
+
+        // generalize the counter-example of the current (non-valid) match and block the matches with its values
+        void BlockCurrNonValidMatch();
+
+        // sample m_NumOfSamples valid matches by hashing the matches into cells with random XOR constraints
+        // the number of constraints is searched until a cell hold between 1 and SAMPLE_CELL_MAX_SIZE valid matches, then a random match of the cell is picked
+        // the cells of a sample are nested (the cell of k constraints use the first k of them), so the search grows the step by doubling and then bisects
+        void SampleValidMatches();
+
+        // find the valid matches of the cell of the given XOR constraints, up to SAMPLE_CELL_MAX_SIZE + 1
+        // the valid matches are eliminated only for this call, non-valid matches are blocked for all the cells
+        std::vector<MatrixIndexVecMatch> FindCellValidMatches(const std::vector<SATLIT>& xorLits);
         
         // *** Params ***
 
@@ -29,6 +41,9 @@ class BoolMatchAlgIterTseitinEnc : public BoolMatchAlgIterBase
         // NOTE: valid match means we have UnSAT
         const bool m_UseUcoreForValidMatch;
 
+        // the max number of valid matches in a cell to sample from
+        static const size_t SAMPLE_CELL_MAX_SIZE = 16;
+
         // *** Variables ***
 
 
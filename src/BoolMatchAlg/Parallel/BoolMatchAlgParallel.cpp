@@ -0,0 +1,311 @@
+#include "BoolMatchAlg/Parallel/BoolMatchAlgParallel.hpp"
+
+#include <chrono>
+#include <exception>
+#include <thread>
+
+#include "BoolMatchAlg/Iterative/TseitinEnc/BoolMatchAlgIterTseitinEnc.hpp"
+#include "BoolMatchAlg/Blocking/TseitinEnc/BoolMatchAlgBlockTseitinEnc.hpp"
+#include "BoolMatchAlg/Hybrid/BoolMatchAlgHybrid.hpp"
+
+using namespace std;
+
+
+BoolMatchAlgParallel::BoolMatchAlgParallel(const InputParser& inputParser):
+BoolMatchAlgBase(inputParser),
+// default is a single thread
+m_NumOfThreads(max(inputParser.getUintCmdOption("/general/threads", 1), (unsigned)1)),
+m_AlgName(inputParser.getCmdOptionWDef("/alg", "iter")),
+m_IsSharded(inputParser.cmdOptionExists("/general/shard")),
+m_ShardIndex(0),
+m_NumOfShards(1),
+m_ParallelState(nullptr),
+m_WallTime(0)
+{
+    if (m_AlgName != "iter" && m_AlgName != "block" && m_AlgName != "hybrid")
+    {
+        throw runtime_error("unkown algorithm type provided");
+    }
+
+    if (m_IsSharded)
+    {
+        ParseShard(inputParser.getCmdOption("/general/shard"));
+        ParseShardCubeIds(inputParser.getCmdOption("/general/shard_cubes"));
+    }
+
+    if (inputParser.getUintCmdOption("/alg/sample", 0) > 0)
+    {
+        throw runtime_error("Sampling valid matches is not supported with more than a single thread");
+    }
+
+    if (inputParser.cmdOptionExists("/general/checkpoint") || inputParser.cmdOptionExists("/general/resume") || inputParser.cmdOptionExists("/general/eco"))
+    {
+        throw runtime_error("Checkpoint, resume and ECO are not supported with more than a single thread");
+    }
+
+    if (inputParser.getBoolCmdOption("/alg/allow_output_neg_map", false))
+    {
+        throw runtime_error("Negated map to the output is not supported with more than a single thread");
+    }
+}
+
+BoolMatchAlgParallel::~BoolMatchAlgParallel()
+{
+    for (BoolMatchAlgGenEnumerBase* worker : m_Workers)
+    {
+        delete worker;
+    }
+
+    delete m_ParallelState;
+}
+
+
+BoolMatchAlgGenEnumerBase* BoolMatchAlgParallel::CreateWorker() const
+{
+    if (m_AlgName == "iter")
+    {
+        return new BoolMatchAlgIterTseitinEnc(m_InputParser);
+    }
+    else if (m_AlgName == "block")
+    {
+        return new BoolMatchAlgBlockTseitinEnc(m_InputParser);
+    }
+    else
+    {
+        return new BoolMatchAlgHybrid(m_InputParser);
+    }
+}
+
+
+void BoolMatchAlgParallel::ParseShard(const string& shard)
+{
+    size_t sepPos = shard.find('/');
+    if (sepPos == string::npos)
+    {
+        throw runtime_error("Cant parse value for option: /general/shard, expected i/N");
+    }
+
+    m_ShardIndex = stoul(shard.substr(0, sepPos));
+    m_NumOfShards = stoul(shard.substr(sepPos + 1));
+    if (m_NumOfShards == 0 || m_ShardIndex >= m_NumOfShards)
+    {
+        throw runtime_error("Invalid shard " + shard + ", expected i/N where i < N");
+    }
+}
+
+
+void BoolMatchAlgParallel::ParseShardCubeIds(const string& shardCubes)
+{
+    size_t startPos = 0;
+    while (startPos < shardCubes.size())
+    {
+        size_t sepPos = shardCubes.find(',', startPos);
+        if (sepPos == string::npos)
+        {
+            sepPos = shardCubes.size();
+        }
+
+        size_t cubeId = stoul(shardCubes.substr(startPos, sepPos - startPos));
+        if (cubeId % m_NumOfShards != m_ShardIndex)
+        {
+            throw runtime_error("Shard cube " + to_string(cubeId) + " is not in the shard");
+        }
+        m_ShardCubeIds.push_back(cubeId);
+
+        startPos = sepPos + 1;
+    }
+}
+
+
+vector<MatrixIndexVecMatch> BoolMatchAlgParallel::CreateWorkCubes(size_t minNumOfCubes) const
+{
+    vector<MatrixIndexVecMatch> cubes = {{}};
+
+    for (int srcIndex = 1; srcIndex <= (int)m_InputSize && cubes.size() < minNumOfCubes; srcIndex++)
+    {
+        vector<MatrixIndexVecMatch> nextCubes;
+        for (const MatrixIndexVecMatch& cube : cubes)
+        {
+            vector<bool> isTrgMatched(m_InputSize + 1, false);
+            for (const MatrixIndexMatch& singleMatch : cube)
+            {
+                isTrgMatched[abs(singleMatch.second)] = true;
+            }
+
+            for (int trgIndex = 1; trgIndex <= (int)m_InputSize; trgIndex++)
+            {
+                if (isTrgMatched[trgIndex])
+                {
+                    continue;
+                }
+
+                MatrixIndexVecMatch nextCube = cube;
+                nextCube.push_back({srcIndex, trgIndex});
+                nextCubes.push_back(nextCube);
+
+                if (m_AllowInputNegMap)
+                {
+                    nextCube.back().second = -trgIndex;
+                    nextCubes.push_back(nextCube);
+                }
+            }
+        }
+        cubes = nextCubes;
+    }
+
+    return cubes;
+}
+
+
+void BoolMatchAlgParallel::_InitializeFromAIGs()
+{
+    // the cubes of a sharded run do not depend on the number of threads
+    vector<MatrixIndexVecMatch> allCubes = CreateWorkCubes(m_IsSharded ? MIN_CUBES_FOR_SHARDS : CUBES_PER_THREAD * m_NumOfThreads);
+
+    vector<size_t> cubeIds = m_ShardCubeIds;
+    if (cubeIds.empty())
+    {
+        for (size_t cubeId = m_ShardIndex; cubeId < allCubes.size(); cubeId += m_NumOfShards)
+        {
+            cubeIds.push_back(cubeId);
+        }
+    }
+
+    vector<MatrixIndexVecMatch> cubes;
+    for (size_t cubeId : cubeIds)
+    {
+        if (cubeId >= allCubes.size())
+        {
+            throw runtime_error("Shard cube " + to_string(cubeId) + " is out of range, the number of cubes is " + to_string(allCubes.size()));
+        }
+        cubes.push_back(allCubes[cubeId]);
+    }
+
+    m_ParallelState = new BoolMatchParallelState(cubes, cubeIds, m_IsSharded);
+
+    for (unsigned workerId = 0; workerId < m_NumOfThreads; workerId++)
+    {
+        BoolMatchAlgGenEnumerBase* worker = CreateWorker();
+        m_Workers.push_back(worker);
+
+        worker->SetParallelState(m_ParallelState, workerId);
+        worker->InitializeFromAlg(*this);
+    }
+}
+
+
+void BoolMatchAlgParallel::_FindAllMatches()
+{
+    auto beforeSearch = chrono::steady_clock::now();
+
+    // the first error of the workers, rethrown after all of them finished
+    exception_ptr workerError = nullptr;
+    mutex workerErrorMutex;
+
+    auto runWorker = [&](BoolMatchAlgGenEnumerBase* worker)
+    {
+        BlockStopSignals();
+
+        try
+        {
+            worker->FindAllMatches(false);
+        }
+        catch (...)
+        {
+            lock_guard<mutex> lock(workerErrorMutex);
+            if (workerError == nullptr)
+            {
+                workerError = current_exception();
+            }
+            m_ParallelState->Stop();
+        }
+
+        // there is no reason to continue after a timeout
+        if (worker->IsTimeOut())
+        {
+            m_ParallelState->Stop();
+        }
+    };
+
+    vector<thread> threads;
+    for (BoolMatchAlgGenEnumerBase* worker : m_Workers)
+    {
+        threads.emplace_back(runWorker, worker);
+    }
+
+    for (thread& workerThread : threads)
+    {
+        workerThread.join();
+    }
+
+    m_WallTime = chrono::duration<double>(chrono::steady_clock::now() - beforeSearch).count();
+
+    if (workerError != nullptr)
+    {
+        rethrow_exception(workerError);
+    }
+
+    for (const BoolMatchAlgGenEnumerBase* worker : m_Workers)
+    {
+        if (worker->IsTimeOut())
+        {
+            m_IsTimeOut = true;
+            throw runtime_error("Timeout reached");
+        }
+    }
+}
+
+
+void BoolMatchAlgParallel::PrintInitialInformation()
+{
+    // the information of all the workers is the same
+    // NOTE: the function is public only in the base class
+    BoolMatchAlgBase* firstWorker = m_Workers[0];
+    firstWorker->PrintInitialInformation();
+
+    cout << "c Use " << m_NumOfThreads << " threads, the match space is split into " << m_ParallelState->GetNumOfCubes() << " cubes" << endl;
+
+    if (m_IsSharded)
+    {
+        // the coordinator use the cube ids of the shard to track the remaining cubes
+        cout << "c Shard " << m_ShardIndex << "/" << m_NumOfShards << " cubes:";
+        for (size_t cubeId : m_ParallelState->GetCubeIds())
+        {
+            cout << " " << cubeId;
+        }
+        cout << endl;
+    }
+}
+
+
+void BoolMatchAlgParallel::RequestStop()
+{
+    BoolMatchAlgBase::RequestStop();
+    if (m_ParallelState != nullptr)
+    {
+        m_ParallelState->Stop();
+    }
+}
+
+void BoolMatchAlgParallel::PrintResult(bool wasInterrupted)
+{
+    m_NumberOfValidMatches = 0;
+    m_TotalNumberOfMatches = 0;
+    m_TimeOnGeneralization = 0;
+    for (const BoolMatchAlgGenEnumerBase* worker : m_Workers)
+    {
+        m_NumberOfValidMatches += worker->GetNumberOfValidMatches();
+        m_TotalNumberOfMatches += worker->GetTotalNumberOfMatches();
+        m_TimeOnGeneralization += worker->GetTimeOnGeneralization();
+        m_IsTimeOut = m_IsTimeOut || worker->IsTimeOut();
+    }
+
+    BoolMatchAlgBase::PrintResult(wasInterrupted);
+
+    for (size_t workerId = 0; workerId < m_Workers.size(); workerId++)
+    {
+        cout << "c Worker " << workerId << ": valid matches " << GetNumOfAllValidMatches(m_Workers[workerId]->GetNumberOfValidMatches())
+            << ", matches iterated " << m_Workers[workerId]->GetTotalNumberOfMatches() << endl;
+    }
+    cout << "c wall time : " << m_WallTime << " sec" << endl;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "BoolMatchAlg/BoolMatchAlgBase.hpp"
+#include "BoolMatchAlg/GeneralizationEnumer/BoolMatchAlgGenEnumerBase.hpp"
+#include "BoolMatchAlg/Parallel/BoolMatchParallelState.hpp"
+
+/*
+    run several workers of the chosen algorithm ("/alg") in parallel threads
+    the match space is split into disjoint cubes by fixing the matches of the first src inputs
+    each worker hold its own solvers and match matrix, take cubes until none is left and share the witnesses of non-valid matches
+    in a sharded run ("/general/shard i/N") only the cubes of the shard are searched, where every searched cube is reported for the coordinator
+*/
+class BoolMatchAlgParallel : public BoolMatchAlgBase
+{
+    public:
+
+        BoolMatchAlgParallel(const InputParser& inputParser);
+
+        virtual ~BoolMatchAlgParallel();
+
+        void PrintResult(bool wasInterrupted = false) override;
+
+        // stop all the workers, they finish their current solver call and return
+        void RequestStop() override;
+
+        // print initial information, timeout etc..
+        void PrintInitialInformation() override;
+
+    protected:
+
+        void _InitializeFromAIGs() override;
+
+        void _FindAllMatches() override;
+
+        // create a single worker of the algorithm given by "/alg"
+        BoolMatchAlgGenEnumerBase* CreateWorker() const;
+
+        // split the match space into disjoint cubes, where each cube fix the matches of the first src inputs
+        // the number of fixed inputs is the minimal one that give at least minNumOfCubes cubes
+        std::vector<MatrixIndexVecMatch> CreateWorkCubes(size_t minNumOfCubes) const;
+
+        // parse the shard "i/N" given by "/general/shard" into m_ShardIndex and m_NumOfShards
+        void ParseShard(const std::string& shard);
+
+        // parse the comma separated cube ids given by "/general/shard_cubes" into m_ShardCubeIds
+        void ParseShardCubeIds(const std::string& shardCubes);
+
+        // *** Params ***
+
+        // the number of threads (workers)
+        const unsigned m_NumOfThreads;
+        // the algorithm of the workers
+        const std::string m_AlgName;
+        // if the run search only a single shard of the match space
+        const bool m_IsSharded;
+
+        // the wanted number of cubes for every thread, more cubes allow better balancing between the workers
+        static const size_t CUBES_PER_THREAD = 4;
+        // the wanted number of cubes of a sharded run, the same for all the shards so the cube ids are the same
+        static const size_t MIN_CUBES_FOR_SHARDS = 256;
+
+        // *** Variables ***
+
+        // the shard i of N, where the shard hold the cubes with id i modulo N
+        unsigned m_ShardIndex;
+        unsigned m_NumOfShards;
+        // if not empty, only these cubes ids are searched (must be in the shard), used by the coordinator to reassign cubes
+        std::vector<size_t> m_ShardCubeIds;
+
+        BoolMatchParallelState* m_ParallelState;
+
+        std::vector<BoolMatchAlgGenEnumerBase*> m_Workers;
+
+		// *** Stats ***
+
+        // the wall time of the search
+        double m_WallTime;
+};
@@ -0,0 +1,79 @@
+#include "BoolMatchAlg/Parallel/BoolMatchParallelState.hpp"
+
+#include <iostream>
+
+using namespace std;
+
+
+BoolMatchParallelState::BoolMatchParallelState(const vector<MatrixIndexVecMatch>& cubes, const vector<size_t>& cubeIds, bool reportDoneCubes):
+m_Cubes(cubes),
+m_CubeIds(cubeIds),
+m_ReportDoneCubes(reportDoneCubes),
+m_NextCube(0),
+m_IsStopped(false),
+m_NumOfWitnesses(0)
+{
+}
+
+bool BoolMatchParallelState::GetNextCube(MatrixIndexVecMatch& cube, size_t& cubeId)
+{
+    if (m_IsStopped)
+    {
+        return false;
+    }
+
+    size_t cubeIndex = m_NextCube++;
+    if (cubeIndex >= m_Cubes.size())
+    {
+        return false;
+    }
+
+    cube = m_Cubes[cubeIndex];
+    cubeId = m_CubeIds[cubeIndex];
+    return true;
+}
+
+void BoolMatchParallelState::CubeDone(size_t cubeId, unsigned long long numOfValidMatches)
+{
+    if (!m_ReportDoneCubes)
+    {
+        return;
+    }
+
+    // the matches of the cube were printed before, flush so the coordinator get the cube at once
+    lock_guard<mutex> lock(m_PrintMutex);
+    cout << "c Shard cube " << cubeId << " done, valid matches " << numOfValidMatches << endl;
+}
+
+void BoolMatchParallelState::AddWitness(unsigned workerId, const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues)
+{
+    lock_guard<mutex> lock(m_WitnessesMutex);
+
+    m_Witnesses.emplace_back(workerId, srcValues, trgValues);
+    m_NumOfWitnesses = m_Witnesses.size();
+}
+
+vector<pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>> BoolMatchParallelState::GetNewWitnesses(unsigned workerId, size_t& nextWitness)
+{
+    vector<pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>> newWitnesses;
+
+    // nothing new, avoid the lock
+    if (nextWitness >= m_NumOfWitnesses)
+    {
+        return newWitnesses;
+    }
+
+    lock_guard<mutex> lock(m_WitnessesMutex);
+
+    for (; nextWitness < m_Witnesses.size(); nextWitness++)
+    {
+        const auto& [witnessWorkerId, srcValues, trgValues] = m_Witnesses[nextWitness];
+        // the witnesses of the worker are already blocked by it
+        if (witnessWorkerId != workerId)
+        {
+            newWitnesses.push_back({srcValues, trgValues});
+        }
+    }
+
+    return newWitnesses;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <tuple>
+
+#include "Globals/BoolMatchGloblas.hpp"
+#include "Globals/BoolMatchSolverGloblas.hpp"
+
+/*
+    the state shared by the workers of a parallel run
+    hold the work cubes (disjoint parts of the match space), the witnesses of non-valid matches and the output lock
+*/
+class BoolMatchParallelState
+{
+    public:
+
+        // cubes - the disjoint partial matches to search, where cubeIds hold the id of each cube
+        // reportDoneCubes - if to print every cube that was searched completely with its number of valid matches (used by sharded runs)
+        BoolMatchParallelState(const std::vector<MatrixIndexVecMatch>& cubes, const std::vector<size_t>& cubeIds, bool reportDoneCubes);
+
+        // get the next cube that was not taken by any worker and its id
+        // return false if all the cubes were taken or the run was stopped
+        bool GetNextCube(MatrixIndexVecMatch& cube, size_t& cubeId);
+
+        // mark that the cube was searched completely, where numOfValidMatches valid matches were found in it
+        void CubeDone(size_t cubeId, unsigned long long numOfValidMatches);
+
+        // stop the run, the workers will not get any more cubes
+        void Stop() {m_IsStopped = true;};
+
+        bool IsStopped() const {return m_IsStopped;};
+
+        size_t GetNumOfCubes() const {return m_Cubes.size();};
+
+        const std::vector<size_t>& GetCubeIds() const {return m_CubeIds;};
+
+        // if the cubes are reported when done, then every printed match is tagged with the id of its cube
+        bool IsReportingDoneCubes() const {return m_ReportDoneCubes;};
+
+        // add the (generalized) inputs values of a non-valid match witness found by the given worker
+        // the witness is valid for all the match space, so all the other workers can use it for blocking
+        void AddWitness(unsigned workerId, const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues);
+
+        // get the witnesses of the other workers starting from position nextWitness, and advance nextWitness to the end
+        std::vector<std::pair<MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>> GetNewWitnesses(unsigned workerId, size_t& nextWitness);
+
+        // the lock used by the workers to print
+        std::mutex& GetPrintMutex() {return m_PrintMutex;};
+
+    protected:
+
+        // *** Variables ***
+
+        const std::vector<MatrixIndexVecMatch> m_Cubes;
+        const std::vector<size_t> m_CubeIds;
+        const bool m_ReportDoneCubes;
+        // the position of the next cube to take
+        std::atomic<size_t> m_NextCube;
+
+        std::atomic<bool> m_IsStopped;
+
+        // all the shared witnesses in the form of <worker id, src values, trg values>
+        std::vector<std::tuple<unsigned, MULT_INDX_ASSIGNMENT, MULT_INDX_ASSIGNMENT>> m_Witnesses;
+        // the size of m_Witnesses, used to check for new witnesses without locking
+        std::atomic<size_t> m_NumOfWitnesses;
+        std::mutex m_WitnessesMutex;
+
+        std::mutex m_PrintMutex;
+};
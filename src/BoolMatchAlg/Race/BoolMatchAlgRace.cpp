@@ -0,0 +1,277 @@
+#include "BoolMatchAlg/Race/BoolMatchAlgRace.hpp"
+
+#include <iostream>
+#include <chrono>
+#include <cerrno>
+
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#include "Globals/BoolMatchAlgGlobals.hpp"
+#include "BoolMatchAlg/Iterative/TseitinEnc/BoolMatchAlgIterTseitinEnc.hpp"
+#include "BoolMatchAlg/Blocking/TseitinEnc/BoolMatchAlgBlockTseitinEnc.hpp"
+#include "BoolMatchAlg/Hybrid/BoolMatchAlgHybrid.hpp"
+#include "BoolMatchAlg/BranchBound/BoolMatchAlgBranchBound.hpp"
+#include "BoolMatchAlg/Parallel/BoolMatchAlgParallel.hpp"
+
+using namespace std;
+
+
+BoolMatchAlgRace::BoolMatchAlgRace(const InputParser& inputParser):
+BoolMatchAlgBase(inputParser),
+m_WinnerIndex(-1),
+m_WallTime(0)
+{
+    const string raceModes = inputParser.getCmdOption("/mode").substr(RACE_MODE_PREFIX.size());
+
+    size_t startPos = 0;
+    while (startPos < raceModes.size())
+    {
+        size_t sepPos = raceModes.find(',', startPos);
+        if (sepPos == string::npos)
+        {
+            sepPos = raceModes.size();
+        }
+
+        string mode = raceModes.substr(startPos, sepPos - startPos);
+        if (MODE_PARAMS.find(mode) == MODE_PARAMS.end())
+        {
+            throw runtime_error("Unkown mode in race: " + mode);
+        }
+        m_RaceModes.push_back(mode);
+
+        startPos = sepPos + 1;
+    }
+
+    if (m_RaceModes.empty())
+    {
+        throw runtime_error("No modes were given to race, expected race:<mode>,<mode>,..");
+    }
+
+    // all the racers would write the same checkpoint
+    if (inputParser.cmdOptionExists("/general/checkpoint"))
+    {
+        throw runtime_error("Checkpoint is not supported in a race");
+    }
+}
+
+BoolMatchAlgRace::~BoolMatchAlgRace()
+{
+    KillRacers();
+
+    for (FILE* outFile : m_RacerOutFiles)
+    {
+        fclose(outFile);
+    }
+}
+
+
+void BoolMatchAlgRace::_InitializeFromAIGs()
+{
+    for (size_t racerIndex = 0; racerIndex < m_RaceModes.size(); racerIndex++)
+    {
+        FILE* outFile = tmpfile();
+        if (outFile == nullptr)
+        {
+            throw runtime_error("Failed to create the output file of a racer");
+        }
+        m_RacerOutFiles.push_back(outFile);
+    }
+}
+
+
+int BoolMatchAlgRace::RunRacer(const string& mode, FILE* outFile)
+{
+    dup2(fileno(outFile), STDOUT_FILENO);
+
+    InputParser racerInputParser = m_InputParser;
+    racerInputParser.AppendParams(MODE_PARAMS.at(mode));
+
+    BoolMatchAlgBase* racer = nullptr;
+    int exitCode = 0;
+    try
+    {
+        if (racerInputParser.getUintCmdOption("/general/threads", 1) > 1)
+        {
+            racer = new BoolMatchAlgParallel(racerInputParser);
+        }
+        else if (racerInputParser.getCmdOptionWDef("/alg", "iter") == "iter")
+        {
+            racer = new BoolMatchAlgIterTseitinEnc(racerInputParser);
+        }
+        else if (racerInputParser.getCmdOptionWDef("/alg", "iter") == "block")
+        {
+            racer = new BoolMatchAlgBlockTseitinEnc(racerInputParser);
+        }
+        else if (racerInputParser.getCmdOptionWDef("/alg", "iter") == "hybrid")
+        {
+            racer = new BoolMatchAlgHybrid(racerInputParser);
+        }
+        else
+        {
+            racer = new BoolMatchAlgBranchBound(racerInputParser);
+        }
+
+        racer->InitializeFromAlg(*this);
+        racer->FindAllMatches();
+        racer->PrintResult();
+
+        exitCode = racer->IsTimeOut() ? RACER_TIMEOUT_EXIT_CODE : 0;
+    }
+    catch (exception& ex)
+    {
+        cout << "Error acord: " << ex.what() << endl;
+        exitCode = 1;
+    }
+
+    cout.flush();
+    fflush(stdout);
+    delete racer;
+
+    return exitCode;
+}
+
+
+void BoolMatchAlgRace::_FindAllMatches()
+{
+    auto beforeRace = chrono::steady_clock::now();
+
+    // the buffered output must not be printed again by the racers
+    cout.flush();
+    fflush(stdout);
+
+    for (size_t racerIndex = 0; racerIndex < m_RaceModes.size(); racerIndex++)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            KillRacers();
+            throw runtime_error("Failed to fork a racer process");
+        }
+
+        if (pid == 0)
+        {
+            // the racer is stopped by the parent
+            signal(SIGINT, SIG_DFL);
+            signal(SIGTERM, SIG_DFL);
+            signal(SIGUSR1, SIG_DFL);
+            _exit(RunRacer(m_RaceModes[racerIndex], m_RacerOutFiles[racerIndex]));
+        }
+
+        m_RacerPids.push_back(pid);
+    }
+
+    // the first racer that timed out, used if no racer finished
+    int firstTimeOutIndex = -1;
+    size_t numOfRunning = m_RacerPids.size();
+    while (numOfRunning > 0 && m_WinnerIndex < 0)
+    {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            // a signal that did not stop the race
+            if (errno == EINTR && !IsStopRequested())
+            {
+                continue;
+            }
+            break;
+        }
+
+        for (size_t racerIndex = 0; racerIndex < m_RacerPids.size(); racerIndex++)
+        {
+            if (m_RacerPids[racerIndex] != pid)
+            {
+                continue;
+            }
+
+            m_RacerPids[racerIndex] = -1;
+            numOfRunning--;
+
+            const int exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+            if (exitCode == 0)
+            {
+                m_WinnerIndex = (int)racerIndex;
+            }
+            else if (exitCode == RACER_TIMEOUT_EXIT_CODE && firstTimeOutIndex < 0)
+            {
+                firstTimeOutIndex = (int)racerIndex;
+            }
+        }
+    }
+
+    KillRacers();
+
+    m_WallTime = chrono::duration<double>(chrono::steady_clock::now() - beforeRace).count();
+
+    if (m_WinnerIndex < 0)
+    {
+        // the race was stopped before any racer finished
+        if (IsStopRequested())
+        {
+            return;
+        }
+
+        if (firstTimeOutIndex < 0)
+        {
+            throw runtime_error("All the racers failed");
+        }
+
+        m_WinnerIndex = firstTimeOutIndex;
+        m_IsTimeOut = true;
+    }
+}
+
+
+void BoolMatchAlgRace::KillRacers()
+{
+    for (pid_t& pid : m_RacerPids)
+    {
+        if (pid > 0)
+        {
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+            pid = -1;
+        }
+    }
+}
+
+
+void BoolMatchAlgRace::PrintInitialInformation()
+{
+    BoolMatchAlgBase::PrintInitialInformation();
+
+    cout << "c Race of " << m_RaceModes.size() << " modes:";
+    for (const string& mode : m_RaceModes)
+    {
+        cout << " " << mode;
+    }
+    cout << endl;
+}
+
+
+void BoolMatchAlgRace::PrintResult(bool wasInterrupted)
+{
+    KillRacers();
+
+    if (m_WinnerIndex < 0)
+    {
+        BoolMatchAlgBase::PrintResult(wasInterrupted);
+        return;
+    }
+
+    cout << "c Race winner: " << m_RaceModes[m_WinnerIndex] << (m_IsTimeOut ? " (timeout)" : "") << endl;
+
+    // the winner output hold its matches and results
+    FILE* outFile = m_RacerOutFiles[m_WinnerIndex];
+    rewind(outFile);
+    char buffer[4096];
+    size_t readSize = 0;
+    while ((readSize = fread(buffer, 1, sizeof(buffer), outFile)) > 0)
+    {
+        cout.write(buffer, readSize);
+    }
+
+    cout << "c Race wall time : " << m_WallTime << " sec" << endl;
+}
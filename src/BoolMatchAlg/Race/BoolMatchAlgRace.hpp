@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+#include <string>
+
+#include <sys/types.h>
+
+#include "BoolMatchAlg/BoolMatchAlgBase.hpp"
+
+/*
+    race several pre-configured modes ("/mode race:<mode>,<mode>,..") on the same circuits
+    every mode runs in its own process, the first one that finish without timeout wins and the rest are killed
+    processes are used (and not threads) so a mode can be stopped inside a long solver call
+    the output of every mode is kept aside, and only the output of the winner is printed
+*/
+class BoolMatchAlgRace : public BoolMatchAlgBase
+{
+    public:
+
+        BoolMatchAlgRace(const InputParser& inputParser);
+
+        virtual ~BoolMatchAlgRace();
+
+        // print the output of the winner
+        void PrintResult(bool wasInterrupted = false) override;
+
+        // print initial information, timeout etc..
+        void PrintInitialInformation() override;
+
+    protected:
+
+        void _InitializeFromAIGs() override;
+
+        void _FindAllMatches() override;
+
+        // run the mode in the current (child) process, its output is written to outFile
+        // return the exit code of the process
+        int RunRacer(const std::string& mode, FILE* outFile);
+
+        // kill all the racers that are still running
+        void KillRacers();
+
+        // *** Params ***
+
+        // the modes to race
+        std::vector<std::string> m_RaceModes;
+
+        // the exit code of a racer that reached the timeout
+        static const int RACER_TIMEOUT_EXIT_CODE = 2;
+
+        // *** Variables ***
+
+        // for every racer its process (-1 when the process ended) and its output file
+        std::vector<pid_t> m_RacerPids;
+        std::vector<FILE*> m_RacerOutFiles;
+
+        // the index of the winner, -1 if there is none
+        int m_WinnerIndex;
+
+		// *** Stats ***
+
+        // the wall time of the race
+        double m_WallTime;
+};
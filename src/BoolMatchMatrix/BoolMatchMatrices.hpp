@@ -0,0 +1,49 @@
+#pragma once
+
+#include "BoolMatchMatrix/BoolMatchMatrixSingleVars/BoolMatchMatrixSingleVars.hpp"
+
+#include "BoolMatchMatrix/BoolMatchMatrixCombVars/BoolMatchMatrixCombVars.hpp"
+
+#include "BoolMatchMatrix/BoolMatchMatrixLogEnc/BoolMatchMatrixLogEnc.hpp"
+
+#include "BoolMatchMatrix/BoolMatchMatrixSparse/BoolMatchMatrixSparse.hpp"
+
+// create a new match matrix of the given type with the given input size
+// feasibleMatches - used only by the sparse matrix, if empty all the matches are feasible
+inline BoolMatchMatrixBase* CreateBoolMatchMatrix(BoolMatchMatrixType matrixType, BoolMatchSolverBase* solver, unsigned inputSize, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+    bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector, 
+    const MatrixIndexVecMatch& feasibleMatches = {})
+{
+    switch (matrixType) {
+        case BoolMatchMatrixType::SINGLE_VARS:
+            return new BoolMatchMatrixSingleVars(solver, inputSize, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector);
+        case BoolMatchMatrixType::COMB_VARS:
+            return new BoolMatchMatrixCombVars(solver, inputSize, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector);
+        case BoolMatchMatrixType::LOG_ENC:
+            return new BoolMatchMatrixLogEnc(solver, inputSize, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector);
+        case BoolMatchMatrixType::SPARSE:
+            return new BoolMatchMatrixSparse(solver, inputSize, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector, feasibleMatches);
+        default:
+            throw std::invalid_argument("Invalid value for BoolMatchMatrixType");
+    }
+}
+
+// create a new match matrix of the given type connected to the given src and trg inputs
+// feasibleMatches - used only by the sparse matrix, if empty all the matches are feasible
+inline BoolMatchMatrixBase* CreateBoolMatchMatrix(BoolMatchMatrixType matrixType, BoolMatchSolverBase* solver, std::vector<SATLIT> srcInputs, std::vector<SATLIT> trgInputs, 
+    const BoolMatchBlockType& blockMatchTypeWithInputsVal, bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector, 
+    const MatrixIndexVecMatch& feasibleMatches = {})
+{
+    switch (matrixType) {
+        case BoolMatchMatrixType::SINGLE_VARS:
+            return new BoolMatchMatrixSingleVars(solver, srcInputs, trgInputs, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector);
+        case BoolMatchMatrixType::COMB_VARS:
+            return new BoolMatchMatrixCombVars(solver, srcInputs, trgInputs, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector);
+        case BoolMatchMatrixType::LOG_ENC:
+            return new BoolMatchMatrixLogEnc(solver, srcInputs, trgInputs, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector);
+        case BoolMatchMatrixType::SPARSE:
+            return new BoolMatchMatrixSparse(solver, srcInputs, trgInputs, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector, feasibleMatches);
+        default:
+            throw std::invalid_argument("Invalid value for BoolMatchMatrixType");
+    }
+}
@@ -14,17 +14,20 @@ m_InputSize(inputSize),
 m_DataMatchMatrix(nullptr),
 m_MatchSelector(CONST_LIT_TRUE),
 m_NumOfBlockedClsMatches(0),
+m_NumOfMatrixVars(0),
+m_DynBlockNumOfUses({0, 0}),
+m_DynBlockNumOfLits({0, 0}),
+m_DynBlockTimeOnAdd({0, 0}),
+m_DynBlockTimeToNext({0, 0}),
+m_LastDynBlockScheme(-1),
+m_LastDynBlockEndClk(0),
 m_LastMaxVal(0),
 m_TimeOnNextMatch(0),
 m_TimeOnEliminateMatch(0),
 m_TimeOnEnforceMatch(0),
 m_TimeOnBlockMatchesByInputsVal(0)
 {
-    m_DataMatchMatrix = new MatrixIndexVars[GerMatrixSize()];
-    for (unsigned i = 0; i < GerMatrixSize(); ++i)
-    {
-        m_DataMatchMatrix[i] = {m_Solver->GetNewVar(), m_Solver->GetNewVar()};
-    }
+	// NOTE: the matrix variables are created by the derived classes, since each derived class use a different encoding
 
 	// NOTE: if match selector is not intilize then we will use the const true
     if (m_UseMatchSelector)
@@ -40,8 +43,16 @@ m_UseMatchSelector(useMatchSelector),
 m_NegMapIsAllowed(allowNegMap),
 m_Solver(solver),
 m_InputSize(srcInputs.size()),
+m_DataMatchMatrix(nullptr),
 m_MatchSelector(CONST_LIT_TRUE),
 m_NumOfBlockedClsMatches(0),
+m_NumOfMatrixVars(0),
+m_DynBlockNumOfUses({0, 0}),
+m_DynBlockNumOfLits({0, 0}),
+m_DynBlockTimeOnAdd({0, 0}),
+m_DynBlockTimeToNext({0, 0}),
+m_LastDynBlockScheme(-1),
+m_LastDynBlockEndClk(0),
 m_LastMaxVal(0),
 m_TimeOnNextMatch(0),
 m_TimeOnEliminateMatch(0),
@@ -52,9 +63,7 @@ m_TimeOnBlockMatchesByInputsVal(0)
 	assert(!srcInputs.empty() && !trgInputs.empty());
 	assert(srcInputs.size() == trgInputs.size());
 
-	// create a new matrix but do not initialize it since we will use the given inputs
-	// the derived classes will initialize the matrix
-	m_DataMatchMatrix = new MatrixIndexVars[GerMatrixSize()];
+	// the derived classes will create the matrix and connect it to the given inputs
 
 	if (m_UseMatchSelector)
     {
@@ -67,27 +76,51 @@ BoolMatchMatrixBase::~BoolMatchMatrixBase()
     delete[] m_DataMatchMatrix;
 }
 
-SOLVER_RET_STATUS BoolMatchMatrixBase::FindNextMatch()
+SOLVER_RET_STATUS BoolMatchMatrixBase::FindNextMatch(const vector<SATLIT>& assump)
 {
-	clock_t beforeCall = clock();
+	clock_t beforeCall = ThreadClock();
 	SOLVER_RET_STATUS res = ERR_RET_STATUS;
 
-	res = m_UseMatchSelector ? m_Solver->SolveUnderAssump({m_MatchSelector}) : m_Solver->Solve();
+	if (assump.empty())
+	{
+		res = m_UseMatchSelector ? m_Solver->SolveUnderAssump({m_MatchSelector}) : m_Solver->Solve();
+	}
+	else
+	{
+		vector<SATLIT> allAssump = assump;
+		if (m_UseMatchSelector)
+		{
+			allAssump.push_back(m_MatchSelector);
+		}
+		res = m_Solver->SolveUnderAssump(allAssump);
+	}
 
-	unsigned long genCpuTimeTaken =  clock() - beforeCall;
+	unsigned long genCpuTimeTaken =  ThreadClock() - beforeCall;
 	double nextMatchTime = (double)(genCpuTimeTaken)/(double)(CLOCKS_PER_SEC);
 	m_TimeOnNextMatch += nextMatchTime;
 
 	return res;
 }
 
+vector<SATLIT> BoolMatchMatrixBase::GetMatchAssump(const MatrixIndexVecMatch& match) const
+{
+	vector<SATLIT> assump;
+	for (const MatrixIndexMatch& singleMatch : match)
+	{
+		vector<SATLIT> matchCube = GetMatchCube(singleMatch);
+		assump.insert(assump.end(), matchCube.begin(), matchCube.end());
+	}
+
+	return assump;
+}
+
 void BoolMatchMatrixBase::EliminateMatch(const MatrixIndexVecMatch& matchToElim, const bool ignoreSelector)
 {
-	clock_t beforeCall = clock();
+	clock_t beforeCall = ThreadClock();
 
 	_EliminateMatch(matchToElim, ignoreSelector);
 
-	unsigned long genCpuTimeTaken =  clock() - beforeCall;
+	unsigned long genCpuTimeTaken =  ThreadClock() - beforeCall;
 	double callTime = (double)(genCpuTimeTaken)/(double)(CLOCKS_PER_SEC);
 	m_TimeOnEliminateMatch += callTime;
 }
@@ -100,13 +133,101 @@ void BoolMatchMatrixBase::EliminateMatches(const vector<MatrixIndexVecMatch>& ma
 	}
 }
 
+void BoolMatchMatrixBase::EliminateMatchUnderAssump(const MatrixIndexVecMatch& matchToElim, SATLIT assumpLit)
+{
+	clock_t beforeCall = ThreadClock();
+
+	// the match is the conjunction of all the lits of its cubes, so a single clause negate it
+	vector<SATLIT> cls = {NegateSATLit(assumpLit)};
+	for (const MatrixIndexMatch& singleMatch : matchToElim)
+	{
+		for (SATLIT lit : GetMatchCube(singleMatch))
+		{
+			cls.push_back(NegateSATLit(lit));
+		}
+	}
+
+	AddClauseWithConst(cls);
+
+	m_NumOfBlockedClsMatches += 1;
+
+	m_TimeOnEliminateMatch += (double)(ThreadClock() - beforeCall)/(double)(CLOCKS_PER_SEC);
+}
+
+SATLIT BoolMatchMatrixBase::AddRandomXorConstraint(mt19937_64& randGen)
+{
+	// collect the match variables once, in a fixed order
+	if (m_XorVars.empty())
+	{
+		vector<bool> isVarUsed;
+		for (int x = 1; x <= (int)m_InputSize; x++)
+		{
+			for (int y = 1; y <= (int)m_InputSize; y++)
+			{
+				for (int polY : {y, -y})
+				{
+					for (SATLIT lit : GetMatchCube({x, polY}))
+					{
+						SATLIT var = AbsSATLit(lit);
+						if (var == CONST_LIT_TRUE)
+						{
+							continue;
+						}
+						if ((size_t)var >= isVarUsed.size())
+						{
+							isVarUsed.resize((size_t)var + 1, false);
+						}
+						if (!isVarUsed[var])
+						{
+							isVarUsed[var] = true;
+							m_XorVars.push_back(var);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// every clause of the chain is guarded by the lit, so asserting its negation satisfies all of them and the solver can drop them
+	SATLIT activeLit = m_Solver->GetNewVar();
+
+	// the xor of the chosen variables, CONST_LIT_FALSE for an empty xor
+	SATLIT xorLit = CONST_LIT_FALSE;
+	for (SATLIT var : m_XorVars)
+	{
+		if ((randGen() & 1) == 0)
+		{
+			continue;
+		}
+
+		if (xorLit == CONST_LIT_FALSE)
+		{
+			xorLit = var;
+			continue;
+		}
+
+		// xorOut <-> (xorLit ^ var)
+		SATLIT xorOut = m_Solver->GetNewVar();
+		m_Solver->AddClause({NegateSATLit(activeLit), NegateSATLit(xorOut), xorLit, var});
+		m_Solver->AddClause({NegateSATLit(activeLit), NegateSATLit(xorOut), NegateSATLit(xorLit), NegateSATLit(var)});
+		m_Solver->AddClause({NegateSATLit(activeLit), xorOut, NegateSATLit(xorLit), var});
+		m_Solver->AddClause({NegateSATLit(activeLit), xorOut, xorLit, NegateSATLit(var)});
+		xorLit = xorOut;
+	}
+
+	const bool parity = (randGen() & 1) == 1;
+	AddClauseWithConst({NegateSATLit(activeLit), parity ? xorLit : NegateSATLit(xorLit)});
+
+	return activeLit;
+}
+
 void BoolMatchMatrixBase::EnforceMatch(const MatrixIndexVecMatch& matchToEnforce)
 {
-	clock_t beforeCall = clock();
+	clock_t beforeCall = ThreadClock();
 
 	_EnforceMatch(matchToEnforce);
 
-	unsigned long genCpuTimeTaken =  clock() - beforeCall;
+	unsigned long genCpuTimeTaken =  ThreadClock() - beforeCall;
 	double callTime = (double)(genCpuTimeTaken)/(double)(CLOCKS_PER_SEC);
 	m_TimeOnEnforceMatch += callTime;
 }
@@ -123,10 +244,151 @@ void BoolMatchMatrixBase::AssertNoMatch()
 	}
 }
 
+void BoolMatchMatrixBase::PreferMatch(const MatrixIndexMatch& match, double boostScore)
+{
+	vector<SATLIT> matchCube = GetMatchCube(match);
+	// the match can not be used
+	if (find(matchCube.begin(), matchCube.end(), CONST_LIT_FALSE) != matchCube.end())
+	{
+		return;
+	}
+
+	for (SATLIT lit : matchCube)
+	{
+		m_Solver->FixLitPolarity(lit);
+		m_Solver->BoostLitScore(lit, boostScore);
+	}
+}
+
+void BoolMatchMatrixBase::BreakInputSymmetries(const vector<vector<int>>& srcSymClasses, const vector<vector<int>>& trgSymClasses)
+{
+	vector<bool> polarities = {true};
+	if (m_NegMapIsAllowed)
+	{
+		polarities.push_back(false);
+	}
+
+	// the inputs are ordered such that the inputs of every class are consecutive (the other inputs follow by index)
+	// the order of the other side must keep the classes consecutive, otherwise the canonical match is not unique
+	auto getRankPerIndex = [&](const vector<vector<int>>& symClasses) -> vector<size_t>
+	{
+		vector<size_t> rankPerIndex(m_InputSize + 1, 0);
+		vector<bool> isInClass(m_InputSize + 1, false);
+		size_t currRank = 0;
+		for (const vector<int>& symClass : symClasses)
+		{
+			for (int index : symClass)
+			{
+				rankPerIndex[index] = currRank++;
+				isInClass[index] = true;
+			}
+		}
+		for (size_t index = 1; index <= m_InputSize; index++)
+		{
+			if (!isInClass[index])
+			{
+				rankPerIndex[index] = currRank++;
+			}
+		}
+		return rankPerIndex;
+	};
+
+	const vector<size_t> srcRankPerIndex = getRankPerIndex(srcSymClasses);
+	const vector<size_t> trgRankPerIndex = getRankPerIndex(trgSymClasses);
+
+	// src class: the image of an input is after the image of the previous input in the class
+	for (const vector<int>& symClass : srcSymClasses)
+	{
+		for (size_t k = 0; k + 1 < symClass.size(); k++)
+		{
+			for (int y = 1; y <= (int)m_InputSize; y++)
+			{
+				for (int prevY = 1; prevY <= (int)m_InputSize; prevY++)
+				{
+					if (trgRankPerIndex[prevY] >= trgRankPerIndex[y])
+					{
+						continue;
+					}
+
+					for (bool isPos : polarities)
+					{
+						for (bool isPrevPos : polarities)
+						{
+							EliminateMatch({{symClass[k], isPos ? y : -y}, {symClass[k + 1], isPrevPos ? prevY : -prevY}}, true);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// trg class: the pre-image of an input is after the pre-image of the previous input in the class
+	for (const vector<int>& symClass : trgSymClasses)
+	{
+		for (size_t k = 0; k + 1 < symClass.size(); k++)
+		{
+			for (int x = 1; x <= (int)m_InputSize; x++)
+			{
+				for (int prevX = 1; prevX <= (int)m_InputSize; prevX++)
+				{
+					if (srcRankPerIndex[prevX] >= srcRankPerIndex[x])
+					{
+						continue;
+					}
+
+					for (bool isPos : polarities)
+					{
+						for (bool isPrevPos : polarities)
+						{
+							EliminateMatch({{x, isPos ? symClass[k] : -symClass[k]}, {prevX, isPrevPos ? symClass[k + 1] : -symClass[k + 1]}}, true);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (!m_NegMapIsAllowed)
+	{
+		return;
+	}
+
+	// src and trg classes: a negative match is not followed by a positive match
+	for (const vector<int>& srcSymClass : srcSymClasses)
+	{
+		for (const vector<int>& trgSymClass : trgSymClasses)
+		{
+			for (size_t i = 0; i < srcSymClass.size(); i++)
+			{
+				for (size_t nextI = i + 1; nextI < srcSymClass.size(); nextI++)
+				{
+					for (size_t j = 0; j < trgSymClass.size(); j++)
+					{
+						for (size_t nextJ = j + 1; nextJ < trgSymClass.size(); nextJ++)
+						{
+							EliminateMatch({{srcSymClass[i], -trgSymClass[j]}, {srcSymClass[nextI], trgSymClass[nextJ]}}, true);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
 void BoolMatchMatrixBase::BlockMatchesByInputsVal(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues, 
     BoolMatchMatrixBase* otherMatchData)
 {
-	clock_t beforeCall = clock();
+	clock_t beforeCall = ThreadClock();
+
+	// the time since the last dynamic block is the time it took to find the current witness
+	if (m_LastDynBlockScheme >= 0)
+	{
+		double timeToNext = (double)(beforeCall - m_LastDynBlockEndClk)/(double)(CLOCKS_PER_SEC);
+		double& avgTimeToNext = m_DynBlockTimeToNext[m_LastDynBlockScheme];
+		avgTimeToNext = m_DynBlockNumOfUses[m_LastDynBlockScheme] == 1 ? timeToNext : 
+			(1 - DYNAMIC_BLOCK_TIME_DECAY) * avgTimeToNext + DYNAMIC_BLOCK_TIME_DECAY * timeToNext;
+		m_LastDynBlockScheme = -1;
+	}
 
 	if (!m_NegMapIsAllowed)
 	{
@@ -135,20 +397,34 @@ void BoolMatchMatrixBase::BlockMatchesByInputsVal(const MULT_INDX_ASSIGNMENT& sr
 	else
 	{
 		
-		// currently dynamic block scheme for negated map is just using the enforce match
-		bool useEnforce = m_BlockMatchTypeWithInputsVal == BoolMatchBlockType::ENFORCE_MATCH || m_BlockMatchTypeWithInputsVal == BoolMatchBlockType::DYNAMIC_BLOCK;
+		bool useEnforce = m_BlockMatchTypeWithInputsVal == BoolMatchBlockType::ENFORCE_MATCH;
 
+		const bool isDynamicBlock = m_BlockMatchTypeWithInputsVal == BoolMatchBlockType::DYNAMIC_BLOCK;
+		pair<double, double> blockLits = {0, 0};
+		if (isDynamicBlock)
+		{
+			// the group to block is the non-DC src indexes
+			size_t groupSize = count_if(srcValues.begin(), srcValues.end(), [](const INDX_ASSIGNMENT& assg) { return IsTValBoolVal(GetValFromAssg(assg)); });
+			blockLits = GetNumOfBlockLitsForNeg(srcValues, trgValues);
+			useEnforce = IsDynamicBlockEnforce(groupSize, blockLits.first, blockLits.second);
+		}
+
+		clock_t beforeAdd = ThreadClock();
 		if (useEnforce)
 		{
 			EnforceMatchesByInputsValForNeg(srcValues, trgValues, otherMatchData);
 		}
 		else
 		{
-			// NOTE: the usage of EliminateMatchesByInputsValForNeg is restrected to some Generalization techniques
 			EliminateMatchesByInputsValForNeg(srcValues, trgValues, otherMatchData);
 		}
+
+		if (isDynamicBlock)
+		{
+			UpdateDynamicBlockStats(useEnforce ? 1 : 0, useEnforce ? blockLits.second : blockLits.first, (double)(ThreadClock() - beforeAdd)/(double)(CLOCKS_PER_SEC));
+		}
 	}
-	unsigned long genCpuTimeTaken =  clock() - beforeCall;
+	unsigned long genCpuTimeTaken =  ThreadClock() - beforeCall;
 	double callTime = (double)(genCpuTimeTaken)/(double)(CLOCKS_PER_SEC);
 	m_TimeOnBlockMatchesByInputsVal += callTime;
 }
@@ -156,10 +432,20 @@ void BoolMatchMatrixBase::BlockMatchesByInputsVal(const MULT_INDX_ASSIGNMENT& sr
 void BoolMatchMatrixBase::EliminateOrEnforceMatchesByInputsVal(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues, 
     BoolMatchMatrixBase* otherMatchData)
 {	
+	// generalized witnesses can contain DC values (or miss indexes), block them with the DC-aware scheme
+	auto hasDC = [&](const MULT_INDX_ASSIGNMENT& values) -> bool
+	{
+		return values.size() != m_InputSize || any_of(values.begin(), values.end(), [](const INDX_ASSIGNMENT& assg) { return !IsTValBoolVal(GetValFromAssg(assg)); });
+	};
+
+	if (hasDC(srcValues) || hasDC(trgValues))
+	{
+		EliminateOrEnforceMatchesByInputsValWithDC(srcValues, trgValues, otherMatchData);
+		return;
+	}
+
 	// check for the same size of inputs
 	assert(srcValues.size() == trgValues.size());
-	// remove this assertion? - only if we ensure that the DC are removed from the same value
-	// we can instead just flip values will give the same effect
 	assert(srcValues.size() == m_InputSize);
 	assert(!m_NegMapIsAllowed);
 	if (otherMatchData != nullptr)
@@ -193,7 +479,7 @@ void BoolMatchMatrixBase::EliminateOrEnforceMatchesByInputsVal(const MULT_INDX_A
 			}
 			else
 			{
-				// currently we do not allow DC values if we do not allow negated map since it can hinder the blocking logic
+				// DC values are handled by EliminateOrEnforceMatchesByInputsValWithDC
 				throw runtime_error("DC value is not allowed in EliminateOrEnforceMatchesByInputsVal");
 			}
 		}
@@ -239,22 +525,25 @@ void BoolMatchMatrixBase::EliminateOrEnforceMatchesByInputsVal(const MULT_INDX_A
 
 	bool useEnforce = m_BlockMatchTypeWithInputsVal == BoolMatchBlockType::ENFORCE_MATCH;
 
-	// in dynamic block we will choose the ELIMINATE_MATCH method if the number of actuall indexes is less then some small const
-	// this is because that in elimnate the number of clauses is around n! where n is size_of_inputs - size_of_max_index
+	// in dynamic block we choose the method by a cost model, see IsDynamicBlockEnforce
+	// in elimnate the number of clauses is around n! where n is size_of_inputs - size_of_max_index
 	// so the max group size we need to block
 	// in enforce match the size of the block is around n^2 (actually n*(size_of_inputs - size_of_max_index))
-	if (m_BlockMatchTypeWithInputsVal == BoolMatchBlockType::DYNAMIC_BLOCK)
+	const bool isDynamicBlock = m_BlockMatchTypeWithInputsVal == BoolMatchBlockType::DYNAMIC_BLOCK;
+	const size_t groupSize = (size_t)m_InputSize - sizeOfMaxIndexes;
+	if (isDynamicBlock)
 	{
-		if ((size_t)m_InputSize - sizeOfMaxIndexes <= DYNAMIC_BLOCK_MIN_GROUP_SIZE)
+		// the number of literals for eliminate is groupSize! * groupSize, stop when it is too large anyway
+		double elimLits = (double)groupSize;
+		for (size_t i = 2; i <= groupSize && elimLits <= DYNAMIC_BLOCK_MAX_ELIM_LITS; i++)
 		{
-			useEnforce = false;
-		}
-		else
-		{
-			useEnforce = true;
+			elimLits *= (double)i;
 		}
+		useEnforce = IsDynamicBlockEnforce(groupSize, elimLits, (double)(groupSize * sizeOfMaxIndexes));
 	}
 
+	clock_t beforeAdd = ThreadClock();
+
 	if (useEnforce)
 	{
 		MatrixIndexVecMatch forcedMatchIndVec;
@@ -293,6 +582,11 @@ void BoolMatchMatrixBase::EliminateOrEnforceMatchesByInputsVal(const MULT_INDX_A
 		{
 			otherMatchData->EnforceMatch(forcedMatchIndVec);
 		}
+
+		if (isDynamicBlock)
+		{
+			UpdateDynamicBlockStats(1, (double)forcedMatchIndVec.size(), (double)(ThreadClock() - beforeAdd)/(double)(CLOCKS_PER_SEC));
+		}
 	}
 	else
 	{
@@ -317,13 +611,345 @@ void BoolMatchMatrixBase::EliminateOrEnforceMatchesByInputsVal(const MULT_INDX_A
 		{
 			otherMatchData->EliminateMatches(uniqueCombinations);
 		}
+
+		if (isDynamicBlock)
+		{
+			UpdateDynamicBlockStats(0, (double)(uniqueCombinations.size() * groupSize), (double)(ThreadClock() - beforeAdd)/(double)(CLOCKS_PER_SEC));
+		}
 	}
 }
 
+void BoolMatchMatrixBase::EliminateOrEnforceMatchesByInputsValWithDC(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues, 
+    BoolMatchMatrixBase* otherMatchData)
+{
+	assert(!m_NegMapIsAllowed);
+	if (otherMatchData != nullptr)
+	{
+		assert(otherMatchData->m_InputSize == m_InputSize);
+		assert(otherMatchData->m_NegMapIsAllowed == m_NegMapIsAllowed);
+	}
+
+	// the indexes of each value 0 or 1, an index without a value is DC
+	// use +1 for matrix indexes (start from 1)
+	array<vector<unsigned>, 2> srcIndexPerValue = {vector<unsigned>(), vector<unsigned>()};
+	array<vector<unsigned>, 2> trgIndexPerValue = {vector<unsigned>(), vector<unsigned>()};
+	// the value of each trg index
+	vector<TVal> trgValPerIndex(m_InputSize, TVal::DontCare);
+
+	for (const INDX_ASSIGNMENT& assg : srcValues)
+	{
+		if (IsTValBoolVal(GetValFromAssg(assg)))
+		{
+			srcIndexPerValue[GetValFromAssg(assg) == TVal::True ? 1 : 0].push_back(GetIndFromAssg(assg) + 1);
+		}
+	}
+	for (const INDX_ASSIGNMENT& assg : trgValues)
+	{
+		if (IsTValBoolVal(GetValFromAssg(assg)))
+		{
+			trgIndexPerValue[GetValFromAssg(assg) == TVal::True ? 1 : 0].push_back(GetIndFromAssg(assg) + 1);
+			trgValPerIndex[GetIndFromAssg(assg)] = GetValFromAssg(assg);
+		}
+	}
+
+	const size_t srcNumOfDc = (size_t)m_InputSize - srcIndexPerValue[0].size() - srcIndexPerValue[1].size();
+	const size_t trgNumOfDc = (size_t)m_InputSize - trgIndexPerValue[0].size() - trgIndexPerValue[1].size();
+
+	m_LastMaxVal = srcIndexPerValue[1].size() >= srcIndexPerValue[0].size() ? 1 : 0;
+
+	// a match is blocked by the witness if it maps some completion of src to some completion of trg
+	// i.e. no src index with value 1 (0) is mapped to a trg index with value 0 (1)
+	// all the completions of one side with the same number of ones are symmetric, so such match exists iff the ranges of the number of ones overlap
+	const size_t srcMinOnes = srcIndexPerValue[1].size();
+	const size_t trgMinOnes = trgIndexPerValue[1].size();
+	if (srcMinOnes > trgMinOnes + trgNumOfDc || trgMinOnes > srcMinOnes + srcNumOfDc)
+	{
+		// no match can map the completions, nothing to block
+		return;
+	}
+
+	// if one side is all DC every match is blocked
+	if (srcNumOfDc == m_InputSize || trgNumOfDc == m_InputSize)
+	{
+		AssertNoMatch();
+		if (otherMatchData != nullptr)
+		{
+			otherMatchData->AssertNoMatch();
+		}
+		return;
+	}
+
+	// enforce a single clause with all the conflicting matches, i.e. 1 -> 0 or 0 -> 1
+	// NOTE: unlike the full assignment, both values are needed since the size of the groups is not the same
+	const double enforceLits = (double)(srcIndexPerValue[1].size() * trgIndexPerValue[0].size() + srcIndexPerValue[0].size() * trgIndexPerValue[1].size());
+	if (enforceLits == 0)
+	{
+		// non-DC indexes of one side are mapped only to DC indexes of the other side, every match is blocked
+		AssertNoMatch();
+		if (otherMatchData != nullptr)
+		{
+			otherMatchData->AssertNoMatch();
+		}
+		return;
+	}
+
+	bool useEnforce = m_BlockMatchTypeWithInputsVal == BoolMatchBlockType::ENFORCE_MATCH;
+
+	const bool isDynamicBlock = m_BlockMatchTypeWithInputsVal == BoolMatchBlockType::DYNAMIC_BLOCK;
+	const size_t groupSize = srcIndexPerValue[0].size() + srcIndexPerValue[1].size();
+	double elimLits = (double)groupSize;
+	if (isDynamicBlock)
+	{
+		// each non-DC src index can be matched with any unused trg index with the same value or DC, this is an upper bound
+		for (size_t val = 0; val <= 1; val++)
+		{
+			double numOfOptions = (double)(trgIndexPerValue[val].size() + trgNumOfDc);
+			for (size_t i = 0; i < srcIndexPerValue[val].size() && elimLits <= DYNAMIC_BLOCK_MAX_ELIM_LITS; i++)
+			{
+				elimLits *= max(numOfOptions - (double)i, 1.0);
+			}
+		}
+		useEnforce = IsDynamicBlockEnforce(groupSize, elimLits, enforceLits);
+	}
+
+	clock_t beforeAdd = ThreadClock();
+
+	if (useEnforce)
+	{
+		MatrixIndexVecMatch forcedMatchIndVec;
+		for (size_t srcVal = 0; srcVal <= 1; srcVal++)
+		{
+			for (unsigned srcIndex : srcIndexPerValue[srcVal])
+			{
+				for (unsigned trgIndex : trgIndexPerValue[1 - srcVal])
+				{
+					forcedMatchIndVec.push_back(make_pair((int)srcIndex, (int)trgIndex));
+				}
+			}
+		}
+
+		EnforceMatch(forcedMatchIndVec);
+
+		if (otherMatchData != nullptr)
+		{
+			otherMatchData->EnforceMatch(forcedMatchIndVec);
+		}
+
+		if (isDynamicBlock)
+		{
+			UpdateDynamicBlockStats(1, enforceLits, (double)(ThreadClock() - beforeAdd)/(double)(CLOCKS_PER_SEC));
+		}
+	}
+	else
+	{
+		// every non-DC src index should be mapped to a trg index with the same value or a DC value
+		// eliminate each such combination of the non-DC src indexes
+		vector<unsigned> srcNoDcIndexes = srcIndexPerValue[0];
+		srcNoDcIndexes.insert(srcNoDcIndexes.end(), srcIndexPerValue[1].begin(), srcIndexPerValue[1].end());
+
+		vector<MatrixIndexVecMatch> matchesToElim;
+		MatrixIndexVecMatch currMatch;
+		vector<bool> isTrgUsed(m_InputSize, false);
+
+		auto AddAllComb = [&](auto&& self, size_t srcPos) -> void
+		{
+			if (srcPos == srcNoDcIndexes.size())
+			{
+				matchesToElim.push_back(currMatch);
+				return;
+			}
+
+			int x = (int)srcNoDcIndexes[srcPos];
+			TVal srcVal = srcPos < srcIndexPerValue[0].size() ? TVal::False : TVal::True;
+
+			for (size_t trgPos = 0; trgPos < m_InputSize; trgPos++)
+			{
+				TVal trgVal = trgValPerIndex[trgPos];
+				if (isTrgUsed[trgPos] || (IsTValBoolVal(trgVal) && trgVal != srcVal))
+				{
+					continue;
+				}
+
+				isTrgUsed[trgPos] = true;
+				currMatch.push_back({x, (int)(trgPos + 1)});
+				self(self, srcPos + 1);
+				currMatch.pop_back();
+				isTrgUsed[trgPos] = false;
+			}
+		};
+
+		AddAllComb(AddAllComb, 0);
+
+		EliminateMatches(matchesToElim);
+
+		if (otherMatchData != nullptr)
+		{
+			otherMatchData->EliminateMatches(matchesToElim);
+		}
+
+		if (isDynamicBlock)
+		{
+			UpdateDynamicBlockStats(0, (double)(matchesToElim.size() * groupSize), (double)(ThreadClock() - beforeAdd)/(double)(CLOCKS_PER_SEC));
+		}
+	}
+}
+
+bool BoolMatchMatrixBase::IsDynamicBlockEnforce(size_t groupSize, double elimLits, double enforceLits) const
+{
+	// a single index is eliminated by unit clauses, enforce can not do better
+	if (groupSize <= 1)
+	{
+		return false;
+	}
+
+	if (elimLits > DYNAMIC_BLOCK_MAX_ELIM_LITS)
+	{
+		return true;
+	}
+
+	// not enough samples, use the static threshold but make sure both schemes are sampled
+	if (m_DynBlockNumOfUses[0] < DYNAMIC_BLOCK_WARMUP_USES || m_DynBlockNumOfUses[1] < DYNAMIC_BLOCK_WARMUP_USES)
+	{
+		if (m_DynBlockNumOfUses[0] >= DYNAMIC_BLOCK_WARMUP_USES)
+		{
+			return true;
+		}
+		if (m_DynBlockNumOfUses[1] >= DYNAMIC_BLOCK_WARMUP_USES)
+		{
+			return false;
+		}
+		return groupSize > DYNAMIC_BLOCK_MIN_GROUP_SIZE;
+	}
+
+	// the estimated cost is the time to add the clauses and the time to find the next witness
+	auto GetCost = [&](int scheme, double numOfLits) -> double
+	{
+		double timePerLit = m_DynBlockNumOfLits[scheme] > 0 ? m_DynBlockTimeOnAdd[scheme] / m_DynBlockNumOfLits[scheme] : 0;
+		return timePerLit * numOfLits + m_DynBlockTimeToNext[scheme];
+	};
+
+	return GetCost(1, enforceLits) < GetCost(0, elimLits);
+}
+
+void BoolMatchMatrixBase::UpdateDynamicBlockStats(int scheme, double numOfLits, double addTime)
+{
+	m_DynBlockNumOfUses[scheme]++;
+	m_DynBlockNumOfLits[scheme] += numOfLits;
+	m_DynBlockTimeOnAdd[scheme] += addTime;
+
+	// the time to the next witness is updated in the next call to BlockMatchesByInputsVal
+	m_LastDynBlockScheme = scheme;
+	m_LastDynBlockEndClk = ThreadClock();
+}
+
 void BoolMatchMatrixBase::EliminateMatchesByInputsValForNeg(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues, 
     BoolMatchMatrixBase* otherMatchData)
 {
-	throw runtime_error("EliminateMatchesByInputsValForNeg is not implemented");
+	// verify that this function is used only when negated map is allowed
+	assert(m_NegMapIsAllowed);
+	if (otherMatchData != nullptr)
+	{
+		assert(otherMatchData->m_NegMapIsAllowed == m_NegMapIsAllowed);
+	}
+
+	// will hold all the assignmenst of non-dc (0\1)
+	MULT_INDX_ASSIGNMENT srcNoDcIndx = srcValues;
+	RemoveDCFromIndxAssg(srcNoDcIndx);
+
+	// check if one side contain all dc then there is no map
+	if (srcNoDcIndx.empty() || all_of(trgValues.begin(), trgValues.end(), [](const INDX_ASSIGNMENT& assg) { return !IsTValBoolVal(GetValFromAssg(assg)); }))
+	{
+		AssertNoMatch();
+		if (otherMatchData != nullptr)
+		{
+			otherMatchData->AssertNoMatch();
+		}
+		return;
+	}
+
+	// the value of each trg index, an index without a value is DC
+	vector<TVal> trgValPerIndex(m_InputSize, TVal::DontCare);
+	for (const INDX_ASSIGNMENT& trgAssg : trgValues)
+	{
+		trgValPerIndex[GetIndFromAssg(trgAssg)] = GetValFromAssg(trgAssg);
+	}
+
+	// every non-DC src index should be mapped to a trg index with the same value (pos match), the negated value (neg match) or a DC value (any match)
+	// eliminate each such combination of the non-DC src indexes
+	vector<MatrixIndexVecMatch> matchesToElim;
+	MatrixIndexVecMatch currMatch;
+	vector<bool> isTrgUsed(m_InputSize, false);
+
+	auto AddAllComb = [&](auto&& self, size_t srcPos) -> void
+	{
+		if (srcPos == srcNoDcIndx.size())
+		{
+			matchesToElim.push_back(currMatch);
+			return;
+		}
+
+		// use +1 for matrix indexes (start from 1)
+		int x = (int)(GetIndFromAssg(srcNoDcIndx[srcPos]) + 1);
+		TVal srcVal = GetValFromAssg(srcNoDcIndx[srcPos]);
+
+		for (size_t trgPos = 0; trgPos < m_InputSize; trgPos++)
+		{
+			if (isTrgUsed[trgPos])
+			{
+				continue;
+			}
+
+			int y = (int)(trgPos + 1);
+			TVal trgVal = trgValPerIndex[trgPos];
+
+			isTrgUsed[trgPos] = true;
+			if (IsTValBoolVal(trgVal))
+			{
+				currMatch.push_back({x, srcVal == trgVal ? y : -y});
+				self(self, srcPos + 1);
+				currMatch.pop_back();
+			}
+			else
+			{
+				// DC value can be matched with both polarities
+				for (int polY : {y, -y})
+				{
+					currMatch.push_back({x, polY});
+					self(self, srcPos + 1);
+					currMatch.pop_back();
+				}
+			}
+			isTrgUsed[trgPos] = false;
+		}
+	};
+
+	AddAllComb(AddAllComb, 0);
+
+	EliminateMatches(matchesToElim);
+
+	// if other matchData send eliminate from that aswell
+	if (otherMatchData != nullptr)
+	{
+		otherMatchData->EliminateMatches(matchesToElim);
+	}
+}
+
+pair<double, double> BoolMatchMatrixBase::GetNumOfBlockLitsForNeg(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues) const
+{
+	size_t srcNumOfNoDc = count_if(srcValues.begin(), srcValues.end(), [](const INDX_ASSIGNMENT& assg) { return IsTValBoolVal(GetValFromAssg(assg)); });
+	size_t trgNumOfNoDc = count_if(trgValues.begin(), trgValues.end(), [](const INDX_ASSIGNMENT& assg) { return IsTValBoolVal(GetValFromAssg(assg)); });
+	// an index without a value is DC
+	size_t trgNumOfDc = (size_t)m_InputSize - trgNumOfNoDc;
+
+	// each non-DC src index can be matched with any unused non-DC trg index (one polarity) or DC trg index (both polarities)
+	double elimLits = (double)srcNumOfNoDc;
+	double numOfOptions = (double)(trgNumOfNoDc + 2 * trgNumOfDc);
+	for (size_t i = 0; i < srcNumOfNoDc && elimLits <= DYNAMIC_BLOCK_MAX_ELIM_LITS; i++)
+	{
+		elimLits *= max(numOfOptions - (double)i, 1.0);
+	}
+
+	return {elimLits, (double)(srcNumOfNoDc * trgNumOfNoDc)};
 }
 
 // Enforce matches according to the current values of src and trg
@@ -397,6 +1023,54 @@ void BoolMatchMatrixBase::ResetEliminatedMatches()
     m_MatchSelector = m_Solver->GetNewVar();
 }
 
+void BoolMatchMatrixBase::AllocateDataMatchMatrix()
+{
+	assert(m_DataMatchMatrix == nullptr);
+	m_DataMatchMatrix = new MatrixIndexVars[GerMatrixSize()];
+}
+
+SATLIT BoolMatchMatrixBase::GetNewMatrixVar()
+{
+	m_NumOfMatrixVars++;
+	return m_Solver->GetNewVar();
+}
+
+void BoolMatchMatrixBase::AddClauseWithConst(const vector<SATLIT>& cls)
+{
+	vector<SATLIT> simpCls;
+	simpCls.reserve(cls.size());
+	for (SATLIT lit : cls)
+	{
+		if (lit == CONST_LIT_TRUE)
+		{
+			// clause is already satisfied
+			return;
+		}
+		if (lit != CONST_LIT_FALSE)
+		{
+			simpCls.push_back(lit);
+		}
+	}
+
+	if (simpCls.empty())
+	{
+		// all the lits are false, the clause can not be satisfied
+		simpCls.push_back(CONST_LIT_FALSE);
+	}
+
+	m_Solver->AddClause(simpCls);
+}
+
+SATLIT BoolMatchMatrixBase::CreateCubeVar(const vector<SATLIT>& cube)
+{
+	SATLIT cubeVar = GetNewMatrixVar();
+	for (SATLIT lit : cube)
+	{
+		AddClauseWithConst({NegateSATLit(cubeVar), lit});
+	}
+	return cubeVar;
+}
+
 size_t BoolMatchMatrixBase::GerMatrixSize() const
 {
 	return (size_t)GetMatrixColRowSize() * (size_t)GetMatrixColRowSize();
@@ -478,4 +1152,9 @@ void BoolMatchMatrixBase::PrintStats() const
 	cout << "c Time on eliminate match: " << m_TimeOnEliminateMatch << endl;
 	cout << "c Time on enforce match: " << m_TimeOnEnforceMatch << endl;
 	cout << "c Time on block matches by inputs val: " << m_TimeOnBlockMatchesByInputsVal << endl;
+	cout << "c Number of matrix variables: " << m_NumOfMatrixVars << endl;
+	if (m_DynBlockNumOfUses[0] + m_DynBlockNumOfUses[1] > 0)
+	{
+		cout << "c Dynamic block used eliminate " << m_DynBlockNumOfUses[0] << " times and enforce " << m_DynBlockNumOfUses[1] << " times" << endl;
+	}
 }
\ No newline at end of file
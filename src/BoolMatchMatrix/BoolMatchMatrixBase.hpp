@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <random>
 
 #include "Globals/BoolMatchGloblas.hpp"
 #include "BoolMatchSolver/BoolMatchSolverBase.hpp"
@@ -14,6 +15,52 @@ enum class BoolMatchBlockType
 
 static const unsigned DEF_BLOCK_MATCH_TYPE_UINT = 2;
 
+// the encoding used for the match matrix variables
+enum class BoolMatchMatrixType
+{
+    // two variables per index, one for the positive and one for the negative match
+    SINGLE_VARS,
+    // one match variable per index and one polarity variable per row (only when negated map is allowed)
+    COMB_VARS,
+    // each row hold the binary encoding of the matched column, n*log(n) variables
+    LOG_ENC,
+    // a single variable only for each feasible match
+    SPARSE
+};
+
+static const unsigned DEF_MATRIX_TYPE_UINT = 0;
+
+// given unsigned convert it to BoolMatchMatrixType
+inline BoolMatchMatrixType ConvertToBoolMatchMatrixType(unsigned value) {
+    switch (value) {
+        case 0:
+            return BoolMatchMatrixType::SINGLE_VARS;
+        case 1:
+            return BoolMatchMatrixType::COMB_VARS;
+        case 2:
+            return BoolMatchMatrixType::LOG_ENC;
+        case 3:
+            return BoolMatchMatrixType::SPARSE;
+        default:
+            throw std::invalid_argument("Invalid value for BoolMatchMatrixType");
+    }
+}
+
+inline std::string ConvertBoolMatchMatrixTypeToString(BoolMatchMatrixType matrixType) {
+    switch (matrixType) {
+        case BoolMatchMatrixType::SINGLE_VARS:
+            return "SINGLE_VARS";
+        case BoolMatchMatrixType::COMB_VARS:
+            return "COMB_VARS";
+        case BoolMatchMatrixType::LOG_ENC:
+            return "LOG_ENC";
+        case BoolMatchMatrixType::SPARSE:
+            return "SPARSE";
+        default:
+            throw std::invalid_argument("Invalid value for BoolMatchMatrixType");
+    }
+}
+
 // given unsigned convert it to BoolMatchBlockType
 inline BoolMatchBlockType ConvertToBoolMatchBlockType(unsigned value) {
     switch (value) {
@@ -47,7 +94,7 @@ public:
     // represnt each matrix index where it may indicate different mapping\encodings
     // for the BoolMatchMatrixCombVars
 	// [0] = true -> there is a match with this indexes
-	// [1] = true -> map is pos, otherwise map is neg
+	// [1] = true -> map is pos, otherwise map is neg (the same polarity var is shared by all the indexes of a row)
     // for the BoolMatchMatrixSingleVars
     // [0] = true -> there is a positive match with this indexes
     // [1] = true -> there is a negative match with this indexes
@@ -80,7 +127,8 @@ public:
     // UnSAT: no more matches
     // Timeout: Timeout
     // NOTE: we need to block the found match otherwise can get the same one
-    SOLVER_RET_STATUS FindNextMatch();
+    // assump - extra assumptions for the call, i.e. to activate constraints added with AddRandomXorConstraint
+    SOLVER_RET_STATUS FindNextMatch(const std::vector<SATLIT>& assump = {});
 
     // get the current match
     // will be implemented in the derived classes 
@@ -100,6 +148,14 @@ public:
     // call EliminateMatch iteratively
     void EliminateMatches(const std::vector<MatrixIndexVecMatch>& matchesToElim, const bool ignoreSelector = false);
 
+    // eliminate a single match only when assumpLit is assumed, used to eliminate matches temporarily
+    void EliminateMatchUnderAssump(const MatrixIndexVecMatch& matchToElim, SATLIT assumpLit);
+
+    // add a random XOR constraint over the match variables, each variable is taken with probability 1/2 and the parity is random
+    // the constraint (with its chain clauses) is active only when the returned lit is assumed, assert its negation to remove the constraint
+    // NOTE: the match variables are all the lits of the match cubes, where each of them is determined by the match
+    SATLIT AddRandomXorConstraint(std::mt19937_64& randGen);
+
     // enforce a single match, i.e. [(1,3),(2,1)] mean (1,3) -or- (2,1) must exist
     // Note - the actual implementation will be in the derived classes with _EnforceMatch
     void EnforceMatch(const MatrixIndexVecMatch& matchToEnforce);
@@ -118,12 +174,27 @@ public:
     // return m_MatchSelector
     SATLIT GetMatchSelector() {return m_MatchSelector;};
 
+    // get the assumption lits that restrict the matches to the ones containing the given (partial) match, the selector is not included
+    std::vector<SATLIT> GetMatchAssump(const MatrixIndexVecMatch& match) const;
+
     // reset the matches eliminted with the selector, also create a new one
     // Note: the function will work only if selector was created, otherwise it will throw an exception
     void ResetEliminatedMatches();
 
     bool IsNegMatchAllowed() {return m_NegMapIsAllowed;};
 
+    // suggest the solver to pick the match, by fixing the polarity of the match lits to true and boosting their score
+    // matches that share lits (i.e. row polarity) are decided by the last call
+    // NOTE: does not work for ipasir solvers
+    void PreferMatch(const MatrixIndexMatch& match, double boostScore);
+
+    // allow only the canonical match among all the matches that are equal under the inputs symmetries
+    // srcSymClasses and trgSymClasses hold classes of matrix indexes where swapping any two inputs of a class keeps the output
+    // the canonical match maps the inputs of every src class in increasing order, and every trg class is mapped from increasing src inputs
+    // where the order of each side keeps the inputs of every class consecutive
+    // if negated map is allowed, the inputs mapped from the same src class to the same trg class are also ordered by polarity (positive first)
+    void BreakInputSymmetries(const std::vector<std::vector<int>>& srcSymClasses, const std::vector<std::vector<int>>& trgSymClasses);
+
     // return the number of created blocked clauses to block matches
     unsigned long long GetNumOfBlockedClsMatches() const {return m_NumOfBlockedClsMatches;};
 
@@ -138,6 +209,20 @@ protected:
 
     // *** Functions ***
 
+    // allocate m_DataMatchMatrix, used by the derived classes that hold a dense matrix
+    void AllocateDataMatchMatrix();
+
+    // return a new solver variable and count it as a matrix variable
+    SATLIT GetNewMatrixVar();
+
+    // add a clause where constant lits are simplified
+    // a clause with CONST_LIT_TRUE is skipped, CONST_LIT_FALSE lits are removed
+    void AddClauseWithConst(const std::vector<SATLIT>& cls);
+
+    // create a new var that imply all the lits of the cube, i.e. (var -> cube[0] & cube[1] & ...)
+    // used to enforce a match that is represented by more than a single literal
+    SATLIT CreateCubeVar(const std::vector<SATLIT>& cube);
+
     size_t GerMatrixSize() const;
     // index start from 1 since we canot have 0 and -0
     inline static unsigned GetFirstIndex() {return (unsigned)1;};
@@ -148,6 +233,10 @@ protected:
     size_t GetAbsMatrixPosFromIndexes(const MatrixIndexMatch& match) const;
     size_t GetAbsMatrixPosFromIndexes(MatrixIndex x, MatrixIndex y) const;
 
+    // get the lits that together represent the match (x,y)
+    // CONST_LIT_TRUE lits are omitted, a match that can not be used is {CONST_LIT_FALSE}
+    virtual std::vector<SATLIT> GetMatchCube(const MatrixIndexMatch& match) const = 0;
+
     // create new vars and assert exactly 1 on every col and row
     // indexMapping: if given index mapping is not empty assert the mapping
     virtual void AssertRowAndCol(const MatrixIndexVecMatch& indexMapping) = 0;
@@ -158,21 +247,40 @@ protected:
     // the actuall function to enforce the match implemented in the derived classes
     virtual void _EnforceMatch(const MatrixIndexVecMatch& matchToEnforce) = 0;
 
+    // decide for dynamic block if to enforce (true) or eliminate (false) the matches of a witness
+    // groupSize is the number of src indexes that need to be blocked, elimLits and enforceLits the number of literals each scheme will add
+    // both schemes block the same matches, eliminate with many short clauses and enforce with a single long clause
+    // the cost of each scheme is estimated by the observed time to add a literal and the observed time to find the next witness
+    bool IsDynamicBlockEnforce(size_t groupSize, double elimLits, double enforceLits) const;
+
+    // update the cost model stats after a dynamic block, scheme is 0 for eliminate and 1 for enforce
+    void UpdateDynamicBlockStats(int scheme, double numOfLits, double addTime);
+
     // either eliminate all matches or enforce matches according to the current values of src and trg
     // where we assume no negated map is allowed
     void EliminateOrEnforceMatchesByInputsVal(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues, 
         BoolMatchMatrixBase* otherMatchData = nullptr);
 
+    // either eliminate all matches or enforce matches according to the partial values of src and trg (DC values or missing indexes)
+    // where we assume no negated map is allowed
+    // a match is blocked if it does not map a src index with value 1 (0) to a trg index with value 0 (1)
+    // the enforce clause hold all these conflicting matches, the eliminate clauses hold every map of the non-DC src indexes to the same value or DC
+    void EliminateOrEnforceMatchesByInputsValWithDC(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues, 
+        BoolMatchMatrixBase* otherMatchData = nullptr);
+
     // eliminate all matches according to the current values of src and trg
     // where we assume negated map is allowed
-    // NOTE: the usage of EliminateMatchesByInputsValForNeg is restrected to some Generalization techniques
-    // this is because it is not complete and might cause problems if dont-care (X) values are used
+    // NOTE: eliminating only the matches between non-DC indexes is not complete if dont-care (X) values are used
     // consider the input values (1,X,X) and (1,X,X) the match x_11 will be blocked but we might get the same result if 1->2,2->1,3->3
-    // this however is not a problem if the weak input assumption is used instead of very weak assumption.
-    // also if Ucore generalization is used this also might casue a problem.
+    // so a non-DC src index mapped to a DC trg index is also eliminated (with both polarities), which block exactly the matches of EnforceMatchesByInputsValForNeg
+    // the number of clauses is around (n + #DC)^k where k is the number of non-DC src indexes, so it should be used for small k
     void EliminateMatchesByInputsValForNeg(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues, 
         BoolMatchMatrixBase* otherMatchData = nullptr);
 
+    // get the number of literals of EliminateMatchesByInputsValForNeg and EnforceMatchesByInputsValForNeg, in the form of <eliminate, enforce>
+    // the number of eliminate literals is an upper bound
+    std::pair<double, double> GetNumOfBlockLitsForNeg(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues) const;
+
     // Enforce matches according to the current values of src and trg
     // where we assume negated map is allowed
     void EnforceMatchesByInputsValForNeg(const MULT_INDX_ASSIGNMENT& srcValues, const MULT_INDX_ASSIGNMENT& trgValues, 
@@ -188,7 +296,14 @@ protected:
     const bool m_UseMatchSelector;
 
     // the minimum group size for dynamic block to choose blocking instead of enforcing
+    // used only until the cost model has enough samples of both schemes
     static const size_t DYNAMIC_BLOCK_MIN_GROUP_SIZE = 3;
+    // the number of uses of each scheme before the dynamic block trust the cost model
+    static const unsigned long long DYNAMIC_BLOCK_WARMUP_USES = 4;
+    // the max number of literals eliminate can use in a single block (k! clauses of size k), above it always enforce
+    static constexpr double DYNAMIC_BLOCK_MAX_ELIM_LITS = 1e5;
+    // the weight of the last sample in the moving average of the time to the next block
+    static constexpr double DYNAMIC_BLOCK_TIME_DECAY = 0.2;
 
     // *** Variables ***
 
@@ -196,6 +311,7 @@ protected:
     // the size of the inputs, also determine the size of the matrix
     unsigned m_InputSize;
     // the actual matrix, each index will hold the match variables
+    // NOTE: allocated only by the derived classes that use a dense matrix, otherwise nullptr
     MatrixIndexVars* m_DataMatchMatrix;
 
     // this will be the selector for the valid matches
@@ -204,12 +320,33 @@ protected:
     // NOTE: this will be create each time we reset
     SATLIT m_MatchSelector;
 
+    // the match variables used by AddRandomXorConstraint, collected on the first call
+    std::vector<SATLIT> m_XorVars;
 
     // *** Stats ***
 
     // will hold the number of added blocked clauses
     unsigned long long m_NumOfBlockedClsMatches;
 
+    // will hold the number of variables created for the matrix encoding
+    unsigned long long m_NumOfMatrixVars;
+
+    // *** Dynamic block cost model ***
+    // hold running stats for each block scheme, [0] - eliminate, [1] - enforce
+
+    // the number of times each scheme was chosen
+    std::array<unsigned long long, 2> m_DynBlockNumOfUses;
+    // the number of literals added by each scheme
+    std::array<double, 2> m_DynBlockNumOfLits;
+    // the time spent on adding the clauses of each scheme
+    std::array<double, 2> m_DynBlockTimeOnAdd;
+    // moving average of the time from a block of each scheme until the next block, i.e. the time to find the next witness
+    std::array<double, 2> m_DynBlockTimeToNext;
+    // the scheme of the last dynamic block, -1 if there is no pending block
+    int m_LastDynBlockScheme;
+    // the time the last dynamic block ended
+    clock_t m_LastDynBlockEndClk;
+
     // hold the last max value from EliminateOrEnforceMatchesByInputsVal
 	unsigned m_LastMaxVal;
     
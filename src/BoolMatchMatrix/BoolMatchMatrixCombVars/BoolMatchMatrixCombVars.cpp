@@ -0,0 +1,210 @@
+#include "BoolMatchMatrix/BoolMatchMatrixCombVars/BoolMatchMatrixCombVars.hpp"
+
+using namespace std;
+
+BoolMatchMatrixCombVars::BoolMatchMatrixCombVars(BoolMatchSolverBase* solver, unsigned inputSize, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+	bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector):
+BoolMatchMatrixBase(solver, inputSize, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector)
+{
+	CreateMatrixVars(indexMapping);
+
+    // assert the row and col
+    AssertRowAndCol(indexMapping);
+}
+
+BoolMatchMatrixCombVars::BoolMatchMatrixCombVars(BoolMatchSolverBase* solver, vector<SATLIT> srcInputs, vector<SATLIT> trgInputs, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+        bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector):
+BoolMatchMatrixBase(solver, srcInputs, trgInputs, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector)
+{
+	CreateMatrixVars(indexMapping);
+
+	// connect the matrix index vars with the given inputs (SATLIT)
+	size_t index = 0;
+	for (const SATLIT srcInp : srcInputs)
+	{
+		for (const SATLIT trgInp : trgInputs)
+		{
+			SATLIT matchVar = m_DataMatchMatrix[index][0];
+			SATLIT polVar = m_DataMatchMatrix[index][1];
+			// match & pol -> assert no 0,1 or 1,0
+			AddClauseWithConst({ NegateSATLit(matchVar), NegateSATLit(polVar), srcInp, NegateSATLit(trgInp) });
+			AddClauseWithConst({ NegateSATLit(matchVar), NegateSATLit(polVar), NegateSATLit(srcInp), trgInp });
+			// match & !pol -> assert no 0,0 or 1,1
+			AddClauseWithConst({ NegateSATLit(matchVar), polVar, srcInp, trgInp });
+			AddClauseWithConst({ NegateSATLit(matchVar), polVar, NegateSATLit(srcInp), NegateSATLit(trgInp) });
+			index++;
+		}
+	}
+
+    // assert the row and col
+    AssertRowAndCol(indexMapping);
+}
+
+void BoolMatchMatrixCombVars::CreateMatrixVars(const MatrixIndexVecMatch& indexMapping)
+{
+	AllocateDataMatchMatrix();
+	m_MatchCubeVars.assign(GerMatrixSize(), {0, 0});
+
+	// save if a neg match is required in the row by indexMapping, even if neg map is not allowed
+	vector<bool> isNegRowMapped (GetMatrixColRowSize(), false);
+	for (const MatrixIndexMatch& indexMatch : indexMapping)
+	{
+		if (!IsMatchPos(indexMatch))
+		{
+			isNegRowMapped[GetAbsRealIndex(indexMatch.first)] = true;
+		}
+	}
+
+	for (unsigned x = GetFirstIndex(); x <= GetMatrixColRowSize(); x++)
+	{
+		// a single polarity var for the row, since each row contain exactly one match
+		SATLIT polVar = (m_NegMapIsAllowed || isNegRowMapped[x - GetFirstIndex()]) ? GetNewMatrixVar() : CONST_LIT_TRUE;
+		for (unsigned y = GetFirstIndex(); y <= GetMatrixColRowSize(); y++)
+		{
+			m_DataMatchMatrix[GetAbsMatrixPosFromIndexes(x, y)] = {GetNewMatrixVar(), polVar};
+		}
+	}
+}
+
+vector<SATLIT> BoolMatchMatrixCombVars::GetMatchCube(const MatrixIndexMatch& match) const
+{
+	// matrix index can not be 0
+	assert(match.first != 0 && match.second != 0);
+
+	const MatrixIndexVars& indexVars = m_DataMatchMatrix[GetAbsMatrixPosFromIndexes(match)];
+	SATLIT polLit = IsMatchPos(match) ? indexVars[1] : NegateSATLit(indexVars[1]);
+
+	if (polLit == CONST_LIT_TRUE)
+	{
+		return {indexVars[0]};
+	}
+	// the match polarity is not possible
+	if (polLit == CONST_LIT_FALSE)
+	{
+		return {CONST_LIT_FALSE};
+	}
+
+	return {indexVars[0], polLit};
+}
+
+SATLIT BoolMatchMatrixCombVars::GetMatchLit(const MatrixIndexMatch& match)
+{
+	vector<SATLIT> cube = GetMatchCube(match);
+	if (cube.size() == 1)
+	{
+		return cube[0];
+	}
+
+	SATLIT& cubeVar = m_MatchCubeVars[GetAbsMatrixPosFromIndexes(match)][IsMatchPos(match) ? 0 : 1];
+	if (cubeVar == 0)
+	{
+		cubeVar = CreateCubeVar(cube);
+	}
+
+	return cubeVar;
+}
+
+MatrixIndexVecMatch BoolMatchMatrixCombVars::GetCurrMatch() const
+{
+    MatrixIndexVecMatch currMatch(GetMatrixColRowSize());
+
+	for (unsigned x = GetFirstIndex(); x <= GetMatrixColRowSize(); x++)
+	{
+		for (unsigned y = GetFirstIndex(); y <= GetMatrixColRowSize(); y++)
+		{
+			const MatrixIndexVars& indexVars = m_DataMatchMatrix[GetAbsMatrixPosFromIndexes(x, y)];
+			if (m_Solver->IsSATLitSatisfied(indexVars[0]))
+			{
+				bool isPos = m_Solver->IsSATLitSatisfied(indexVars[1]);
+				currMatch[x-1] = { (int)x, isPos ? (int)y : -(int)y };
+				break;
+			}
+		}
+	}
+
+	return currMatch;
+}
+
+void BoolMatchMatrixCombVars::AssertRowAndCol(const MatrixIndexVecMatch& indexMapping)
+{
+	// iterate over all the index mapping which we need to assume
+	for (const MatrixIndexMatch& indexMatch : indexMapping)
+	{
+		for (SATLIT lit : GetMatchCube(indexMatch))
+		{
+			m_Solver->AddClause(lit);
+		}
+	}
+
+	vector<vector<SATLIT>> xMatches(GetMatrixColRowSize());
+	vector<vector<SATLIT>> yMatches(GetMatrixColRowSize());
+
+	for (unsigned x = GetFirstIndex(); x <= GetMatrixColRowSize(); x++)
+	{
+		for (unsigned y = GetFirstIndex(); y <= GetMatrixColRowSize(); y++)
+		{
+			SATLIT matchVar = m_DataMatchMatrix[GetAbsMatrixPosFromIndexes(x, y)][0];
+
+			// use x -1 / y-1 since index start from 1 
+			xMatches[x - GetFirstIndex()].emplace_back(matchVar);
+			yMatches[y - GetFirstIndex()].emplace_back(matchVar);
+		}
+	}
+
+	// one match exactly from each row
+	for (auto& xMatch : xMatches)
+	{
+		m_Solver->AssertExactlyOne(xMatch);
+	}
+	// one match exactly from each col
+	for (auto& yMatch : yMatches)
+	{
+		m_Solver->AssertExactlyOne(yMatch);
+	}
+}
+
+void BoolMatchMatrixCombVars::_EliminateMatch(const MatrixIndexVecMatch& matchToElim, const bool ignoreSelector)
+{
+	vector<SATLIT> matrixVars;
+	// reserve up to two vars per match
+	matrixVars.reserve(2 * matchToElim.size() + 1);
+
+	for (const MatrixIndexMatch& singleMatch : matchToElim)
+	{
+		// the match is a cube, so eliminating it only require the negation of its lits
+		for (SATLIT lit : GetMatchCube(singleMatch))
+		{
+			matrixVars.push_back(NegateSATLit(lit));
+		}
+	}
+
+	if (m_UseMatchSelector && !ignoreSelector)
+	{
+		matrixVars.push_back(NegateSATLit(m_MatchSelector));
+	}
+
+	AddClauseWithConst(matrixVars);
+
+	m_NumOfBlockedClsMatches += 1;
+}
+
+void BoolMatchMatrixCombVars::_EnforceMatch(const MatrixIndexVecMatch& matchToEnforce)
+{
+	vector<SATLIT> matrixVars;
+	// reserve one var per match
+	matrixVars.reserve(matchToEnforce.size() + 1);
+
+	for (const MatrixIndexMatch& singleMatch : matchToEnforce)
+	{
+		matrixVars.push_back(GetMatchLit(singleMatch));
+	}
+
+	if (m_UseMatchSelector)
+	{
+		matrixVars.push_back(NegateSATLit(m_MatchSelector));
+	}
+
+	AddClauseWithConst(matrixVars);
+
+	m_NumOfBlockedClsMatches += 1;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "BoolMatchMatrix/BoolMatchMatrixBase.hpp"
+
+/*
+    match matrix with a single match var for each index and a polarity var for each row
+    a positive match (x,y) is represented by match(x,y) & pol(x), a negative match by match(x,y) & !pol(x)
+    if neg map is not allowed the polarity is CONST_LIT_TRUE, so only n^2 vars are used (instead of 2*n^2)
+*/
+class BoolMatchMatrixCombVars : virtual public BoolMatchMatrixBase
+{
+
+public:
+    // initialize the class
+    // call the base class constructor
+    BoolMatchMatrixCombVars(BoolMatchSolverBase* solver, unsigned inputSize, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+        bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector);
+
+    // initialize the class witht the circuits inputs
+    // call the base class constructor
+    BoolMatchMatrixCombVars(BoolMatchSolverBase* solver, std::vector<SATLIT> srcInputs, std::vector<SATLIT> trgInputs, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+        bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector);
+
+    // get the current match 
+    MatrixIndexVecMatch GetCurrMatch() const;
+
+protected:
+
+    // allocate the matrix and create the match vars and the row polarity vars
+    // the polarity var of a row is created only if neg map is allowed or a neg match of the row is required by indexMapping
+    void CreateMatrixVars(const MatrixIndexVecMatch& indexMapping);
+
+    // get the lits that together represent the match (x,y), i.e. {match(x,y), pol(x)}
+    // CONST_LIT_TRUE lits are omitted
+    std::vector<SATLIT> GetMatchCube(const MatrixIndexMatch& match) const;
+
+    // get a single lit that imply the match (x,y)
+    // if the match is represented by more than one lit, a cube var is created (once) and returned
+    SATLIT GetMatchLit(const MatrixIndexMatch& match);
+
+    // assert exactly 1 on every col and row
+    // indexMapping: if given index mapping is not empty assert the mapping
+    void AssertRowAndCol(const MatrixIndexVecMatch& indexMapping);
+
+    // eliminate combination of matches
+    void _EliminateMatch(const MatrixIndexVecMatch& matchToElim, const bool ignoreSelector = false);
+    // enforce combinations of matches
+    void _EnforceMatch(const MatrixIndexVecMatch& matchToEnforce);
+
+    /* Vars */
+
+    // for each index hold the cube vars (created on demand) for the [0] pos and [1] neg match
+    // 0 means the cube var was not created yet
+    std::vector<MatrixIndexVars> m_MatchCubeVars;
+};
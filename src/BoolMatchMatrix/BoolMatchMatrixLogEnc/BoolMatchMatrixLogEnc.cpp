@@ -0,0 +1,275 @@
+#include "BoolMatchMatrix/BoolMatchMatrixLogEnc/BoolMatchMatrixLogEnc.hpp"
+
+using namespace std;
+
+BoolMatchMatrixLogEnc::BoolMatchMatrixLogEnc(BoolMatchSolverBase* solver, unsigned inputSize, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+	bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector):
+BoolMatchMatrixBase(solver, inputSize, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector),
+m_NumOfBits(0)
+{
+	CreateMatrixVars(indexMapping);
+
+    // assert the row and col
+    AssertRowAndCol(indexMapping);
+}
+
+BoolMatchMatrixLogEnc::BoolMatchMatrixLogEnc(BoolMatchSolverBase* solver, vector<SATLIT> srcInputs, vector<SATLIT> trgInputs, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+        bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector):
+BoolMatchMatrixBase(solver, srcInputs, trgInputs, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector),
+m_NumOfBits(0)
+{
+	CreateMatrixVars(indexMapping);
+
+	// connect each possible row value with the given inputs (SATLIT)
+	for (size_t x = 0; x < srcInputs.size(); x++)
+	{
+		const SATLIT srcInp = srcInputs[x];
+		const SATLIT polVar = m_RowPolVars[x];
+		for (size_t y = 0; y < trgInputs.size(); y++)
+		{
+			const SATLIT trgInp = trgInputs[y];
+
+			// the row bits are not equal to y
+			vector<SATLIT> notMatchCls = GetValueCube(m_RowBits[x], (unsigned)y);
+			transform(notMatchCls.begin(), notMatchCls.end(), notMatchCls.begin(), [](SATLIT lit) { return NegateSATLit(lit); });
+
+			auto AddConnectCls = [&](SATLIT polLit, SATLIT srcLit, SATLIT trgLit) -> void
+			{
+				vector<SATLIT> cls = notMatchCls;
+				cls.push_back(polLit);
+				cls.push_back(srcLit);
+				cls.push_back(trgLit);
+				AddClauseWithConst(cls);
+			};
+
+			// match & pol -> assert no 0,1 or 1,0
+			AddConnectCls(NegateSATLit(polVar), srcInp, NegateSATLit(trgInp));
+			AddConnectCls(NegateSATLit(polVar), NegateSATLit(srcInp), trgInp);
+			// match & !pol -> assert no 0,0 or 1,1
+			AddConnectCls(polVar, srcInp, trgInp);
+			AddConnectCls(polVar, NegateSATLit(srcInp), NegateSATLit(trgInp));
+		}
+	}
+
+    // assert the row and col
+    AssertRowAndCol(indexMapping);
+}
+
+void BoolMatchMatrixLogEnc::CreateMatrixVars(const MatrixIndexVecMatch& indexMapping)
+{
+	// use at least one bit, so a single input still have a var
+	m_NumOfBits = 1;
+	while (((size_t)1 << m_NumOfBits) < (size_t)GetMatrixColRowSize())
+	{
+		m_NumOfBits++;
+	}
+
+	// save if a neg match is required in the row by indexMapping, even if neg map is not allowed
+	vector<bool> isNegRowMapped (GetMatrixColRowSize(), false);
+	for (const MatrixIndexMatch& indexMatch : indexMapping)
+	{
+		if (!IsMatchPos(indexMatch))
+		{
+			isNegRowMapped[GetAbsRealIndex(indexMatch.first)] = true;
+		}
+	}
+
+	m_RowBits.assign(GetMatrixColRowSize(), vector<SATLIT>());
+	m_ColBits.assign(GetMatrixColRowSize(), vector<SATLIT>());
+	m_RowPolVars.assign(GetMatrixColRowSize(), CONST_LIT_TRUE);
+
+	for (unsigned i = 0; i < GetMatrixColRowSize(); i++)
+	{
+		for (unsigned bit = 0; bit < m_NumOfBits; bit++)
+		{
+			m_RowBits[i].push_back(GetNewMatrixVar());
+			m_ColBits[i].push_back(GetNewMatrixVar());
+		}
+
+		if (m_NegMapIsAllowed || isNegRowMapped[i])
+		{
+			m_RowPolVars[i] = GetNewMatrixVar();
+		}
+	}
+}
+
+vector<SATLIT> BoolMatchMatrixLogEnc::GetValueCube(const vector<SATLIT>& bits, unsigned value) const
+{
+	vector<SATLIT> cube(bits.size());
+	for (size_t bit = 0; bit < bits.size(); bit++)
+	{
+		cube[bit] = ((value >> bit) & 1) ? bits[bit] : NegateSATLit(bits[bit]);
+	}
+	return cube;
+}
+
+vector<SATLIT> BoolMatchMatrixLogEnc::GetMatchCube(const MatrixIndexMatch& match) const
+{
+	// matrix index can not be 0
+	assert(match.first != 0 && match.second != 0);
+
+	size_t x = GetAbsRealIndex(match.first);
+	SATLIT polLit = IsMatchPos(match) ? m_RowPolVars[x] : NegateSATLit(m_RowPolVars[x]);
+
+	// the match polarity is not possible
+	if (polLit == CONST_LIT_FALSE)
+	{
+		return {CONST_LIT_FALSE};
+	}
+
+	vector<SATLIT> cube = GetValueCube(m_RowBits[x], (unsigned)GetAbsRealIndex(match.second));
+	if (polLit != CONST_LIT_TRUE)
+	{
+		cube.push_back(polLit);
+	}
+
+	return cube;
+}
+
+SATLIT BoolMatchMatrixLogEnc::GetMatchLit(const MatrixIndexMatch& match)
+{
+	vector<SATLIT> cube = GetMatchCube(match);
+	if (cube.size() == 1)
+	{
+		return cube[0];
+	}
+
+	size_t key = 2 * GetAbsMatrixPosFromIndexes(match) + (IsMatchPos(match) ? 0 : 1);
+	auto it = m_MatchCubeVars.find(key);
+	if (it != m_MatchCubeVars.end())
+	{
+		return it->second;
+	}
+
+	SATLIT cubeVar = CreateCubeVar(cube);
+	m_MatchCubeVars[key] = cubeVar;
+	return cubeVar;
+}
+
+void BoolMatchMatrixLogEnc::AssertValueInRange(const vector<SATLIT>& bits)
+{
+	// the max allowed value
+	const unsigned maxVal = GetMatrixColRowSize() - 1;
+
+	// a value is larger than maxVal iff at the first bit (from the most significant) where they differ the value bit is 1
+	// so for each 0 bit of maxVal, block the case where the more significant bits are equal and the bit is 1
+	for (int bit = (int)bits.size() - 1; bit >= 0; bit--)
+	{
+		if ((maxVal >> bit) & 1)
+		{
+			continue;
+		}
+
+		vector<SATLIT> cls = {NegateSATLit(bits[bit])};
+		for (int highBit = (int)bits.size() - 1; highBit > bit; highBit--)
+		{
+			// the high bit is not equal to the bit of maxVal
+			cls.push_back(((maxVal >> highBit) & 1) ? NegateSATLit(bits[highBit]) : bits[highBit]);
+		}
+		m_Solver->AddClause(cls);
+	}
+}
+
+MatrixIndexVecMatch BoolMatchMatrixLogEnc::GetCurrMatch() const
+{
+    MatrixIndexVecMatch currMatch(GetMatrixColRowSize());
+
+	for (unsigned x = 0; x < GetMatrixColRowSize(); x++)
+	{
+		unsigned y = 0;
+		for (unsigned bit = 0; bit < m_NumOfBits; bit++)
+		{
+			if (m_Solver->IsSATLitSatisfied(m_RowBits[x][bit]))
+			{
+				y |= (1 << bit);
+			}
+		}
+
+		bool isPos = m_Solver->IsSATLitSatisfied(m_RowPolVars[x]);
+		currMatch[x] = { PosToIndex(x), isPos ? PosToIndex(y) : -PosToIndex(y) };
+	}
+
+	return currMatch;
+}
+
+void BoolMatchMatrixLogEnc::AssertRowAndCol(const MatrixIndexVecMatch& indexMapping)
+{
+	// iterate over all the index mapping which we need to assume
+	for (const MatrixIndexMatch& indexMatch : indexMapping)
+	{
+		for (SATLIT lit : GetMatchCube(indexMatch))
+		{
+			m_Solver->AddClause(lit);
+		}
+	}
+
+	for (unsigned i = 0; i < GetMatrixColRowSize(); i++)
+	{
+		AssertValueInRange(m_RowBits[i]);
+		AssertValueInRange(m_ColBits[i]);
+	}
+
+	// channel each row to its col, if row x is matched to col y then col y is matched to row x
+	// since each col hold a single value, two rows can not be matched to the same col
+	// and since all the rows are in range, each col is matched exactly once
+	for (unsigned x = 0; x < GetMatrixColRowSize(); x++)
+	{
+		for (unsigned y = 0; y < GetMatrixColRowSize(); y++)
+		{
+			vector<SATLIT> notMatchCls = GetValueCube(m_RowBits[x], y);
+			transform(notMatchCls.begin(), notMatchCls.end(), notMatchCls.begin(), [](SATLIT lit) { return NegateSATLit(lit); });
+
+			for (SATLIT colBitLit : GetValueCube(m_ColBits[y], x))
+			{
+				vector<SATLIT> cls = notMatchCls;
+				cls.push_back(colBitLit);
+				m_Solver->AddClause(cls);
+			}
+		}
+	}
+}
+
+void BoolMatchMatrixLogEnc::_EliminateMatch(const MatrixIndexVecMatch& matchToElim, const bool ignoreSelector)
+{
+	vector<SATLIT> matrixVars;
+	matrixVars.reserve((m_NumOfBits + 1) * matchToElim.size() + 1);
+
+	for (const MatrixIndexMatch& singleMatch : matchToElim)
+	{
+		// the match is a cube, so eliminating it only require the negation of its lits
+		for (SATLIT lit : GetMatchCube(singleMatch))
+		{
+			matrixVars.push_back(NegateSATLit(lit));
+		}
+	}
+
+	if (m_UseMatchSelector && !ignoreSelector)
+	{
+		matrixVars.push_back(NegateSATLit(m_MatchSelector));
+	}
+
+	AddClauseWithConst(matrixVars);
+
+	m_NumOfBlockedClsMatches += 1;
+}
+
+void BoolMatchMatrixLogEnc::_EnforceMatch(const MatrixIndexVecMatch& matchToEnforce)
+{
+	vector<SATLIT> matrixVars;
+	// reserve one var per match
+	matrixVars.reserve(matchToEnforce.size() + 1);
+
+	for (const MatrixIndexMatch& singleMatch : matchToEnforce)
+	{
+		matrixVars.push_back(GetMatchLit(singleMatch));
+	}
+
+	if (m_UseMatchSelector)
+	{
+		matrixVars.push_back(NegateSATLit(m_MatchSelector));
+	}
+
+	AddClauseWithConst(matrixVars);
+
+	m_NumOfBlockedClsMatches += 1;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "BoolMatchMatrix/BoolMatchMatrixBase.hpp"
+
+/*
+    match matrix where each row hold the binary (log) encoding of its matched col
+    the inverse mapping (col -> row) is also encoded in binary and channeled from the rows, which ensure the matrix is a permutation
+    together with a polarity var for each row (only when neg map is allowed) the matrix use 2*n*log(n) + n vars instead of 2*n^2
+    NOTE: the number of vars is much smaller but the number of channeling clauses is n^2*log(n) and the propagation is weaker
+*/
+class BoolMatchMatrixLogEnc : virtual public BoolMatchMatrixBase
+{
+
+public:
+    // initialize the class
+    // call the base class constructor
+    BoolMatchMatrixLogEnc(BoolMatchSolverBase* solver, unsigned inputSize, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+        bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector);
+
+    // initialize the class witht the circuits inputs
+    // call the base class constructor
+    BoolMatchMatrixLogEnc(BoolMatchSolverBase* solver, std::vector<SATLIT> srcInputs, std::vector<SATLIT> trgInputs, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+        bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector);
+
+    // get the current match 
+    MatrixIndexVecMatch GetCurrMatch() const;
+
+protected:
+
+    // create the bits for each row and col and the row polarity vars
+    // the polarity var of a row is created only if neg map is allowed or a neg match of the row is required by indexMapping
+    void CreateMatrixVars(const MatrixIndexVecMatch& indexMapping);
+
+    // get the lits that represent the given value (start from 0) with the given bits
+    std::vector<SATLIT> GetValueCube(const std::vector<SATLIT>& bits, unsigned value) const;
+
+    // get the lits that together represent the match (x,y), i.e. the bits of row x equal to y and pol(x)
+    // CONST_LIT_TRUE lits are omitted
+    std::vector<SATLIT> GetMatchCube(const MatrixIndexMatch& match) const;
+
+    // get a single lit that imply the match (x,y)
+    // if the match is represented by more than one lit, a cube var is created (once) and returned
+    SATLIT GetMatchLit(const MatrixIndexMatch& match);
+
+    // assert that the value represented by the bits is smaller than the matrix size
+    void AssertValueInRange(const std::vector<SATLIT>& bits);
+
+    // assert the range of each row and col, and channel each row to the col it is matched to
+    // indexMapping: if given index mapping is not empty assert the mapping
+    void AssertRowAndCol(const MatrixIndexVecMatch& indexMapping);
+
+    // eliminate combination of matches
+    void _EliminateMatch(const MatrixIndexVecMatch& matchToElim, const bool ignoreSelector = false);
+    // enforce combinations of matches
+    void _EnforceMatch(const MatrixIndexVecMatch& matchToEnforce);
+
+    /* Vars */
+
+    // number of bits used to encode an index
+    unsigned m_NumOfBits;
+
+    // for each row (src) hold the bits of the matched col, from the least significant bit
+    std::vector<std::vector<SATLIT>> m_RowBits;
+    // for each col (trg) hold the bits of the matched row, from the least significant bit
+    std::vector<std::vector<SATLIT>> m_ColBits;
+    // for each row hold the polarity var, true -> map is pos, otherwise map is neg
+    std::vector<SATLIT> m_RowPolVars;
+
+    // hold the cube vars (created on demand) for each match
+    // the key is 2 * matrix position + (0 for pos match, 1 for neg match)
+    std::unordered_map<size_t, SATLIT> m_MatchCubeVars;
+};
@@ -6,6 +6,8 @@ BoolMatchMatrixSingleVars::BoolMatchMatrixSingleVars(BoolMatchSolverBase* solver
 	bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector):
 BoolMatchMatrixBase(solver, inputSize, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector)
 {
+	CreateMatrixVars(indexMapping);
+
     // assert the row and col
     AssertRowAndCol(indexMapping);
 }
@@ -14,27 +16,32 @@ BoolMatchMatrixSingleVars::BoolMatchMatrixSingleVars(BoolMatchSolverBase* solver
         bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector):
 BoolMatchMatrixBase(solver, srcInputs, trgInputs, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector)
 {
-	// create a matrix index vars with the given inputs (SATLIT)
-	auto CreateMatrixIndexVars = [&](const SATLIT srcInp, const SATLIT trgInp) -> MatrixIndexVars
+	CreateMatrixVars(indexMapping);
+
+	// connect the matrix index vars with the given inputs (SATLIT)
+	auto ConnectMatrixIndexVars = [&](const MatrixIndexVars& indexVars, const SATLIT srcInp, const SATLIT trgInp) -> void
 	{
-		SATLIT isMatchPosVar = m_Solver->GetNewVar();
-		SATLIT isMatchNegVar = m_Solver->GetNewVar();
+		SATLIT isMatchPosVar = indexVars[0];
+		SATLIT isMatchNegVar = indexVars[1];
 		// match pos -> assert no 0,1 or 1,0
 		m_Solver->AddClause({ NegateSATLit(isMatchPosVar), srcInp, NegateSATLit(trgInp) });
 		m_Solver->AddClause({ NegateSATLit(isMatchPosVar), NegateSATLit(srcInp), trgInp});
 		// match neg -> assert no 0,0 or 1,1
-		m_Solver->AddClause({ NegateSATLit(isMatchNegVar), srcInp, trgInp });
-		m_Solver->AddClause({ NegateSATLit(isMatchNegVar), NegateSATLit(srcInp), NegateSATLit(trgInp)});
-		return {isMatchPosVar, isMatchNegVar};
+		// no need if the neg match can not be used
+		if (isMatchNegVar != CONST_LIT_FALSE)
+		{
+			m_Solver->AddClause({ NegateSATLit(isMatchNegVar), srcInp, trgInp });
+			m_Solver->AddClause({ NegateSATLit(isMatchNegVar), NegateSATLit(srcInp), NegateSATLit(trgInp)});
+		}
 	};
 
-	// create match index from first depth
+	// connect match index from first depth
 	size_t index = 0;
 	for (const SATLIT srcInp : srcInputs)
 	{
 		for (const SATLIT trgInp : trgInputs)
 		{
-			m_DataMatchMatrix[index] = CreateMatrixIndexVars(srcInp, trgInp);
+			ConnectMatrixIndexVars(m_DataMatchMatrix[index], srcInp, trgInp);
 			index++;
 		}
 	}
@@ -71,6 +78,28 @@ MatrixIndexVecMatch BoolMatchMatrixSingleVars::GetCurrMatch() const
 	return currMatch;
 }
 
+void BoolMatchMatrixSingleVars::CreateMatrixVars(const MatrixIndexVecMatch& indexMapping)
+{
+	AllocateDataMatchMatrix();
+
+	// save if a neg match is required by indexMapping, even if neg map is not allowed
+	vector<bool> isNegIndexMapped (GerMatrixSize(), false);
+	for (const MatrixIndexMatch& indexMatch : indexMapping)
+	{
+		if (!IsMatchPos(indexMatch))
+		{
+			isNegIndexMapped[GetAbsMatrixPosFromIndexes(indexMatch)] = true;
+		}
+	}
+
+	for (size_t i = 0; i < GerMatrixSize(); ++i)
+	{
+		// if neg map is not allowed the neg var is always false, so there is no need for a new var
+		SATLIT isMatchNegVar = (m_NegMapIsAllowed || isNegIndexMapped[i]) ? GetNewMatrixVar() : CONST_LIT_FALSE;
+		m_DataMatchMatrix[i] = {GetNewMatrixVar(), isMatchNegVar};
+	}
+}
+
 SATLIT BoolMatchMatrixSingleVars::GetIndexVar(const MatrixIndexMatch& match) const
 {
 	return GetIndexVar(match.first, match.second);
@@ -123,9 +152,15 @@ void BoolMatchMatrixSingleVars::AssertRowAndCol(const MatrixIndexVecMatch& index
 	
 			// use x -1 / y-1 since index start from 1 
 			xMatches[x - GetFirstIndex()].emplace_back(posIndexVar);
-			xMatches[x - GetFirstIndex()].emplace_back(negIndexVar);
-
 			yMatches[y - GetFirstIndex()].emplace_back(posIndexVar);
+
+			// the neg var is const false when neg map is not allowed and not asserted by indexMapping
+			if (negIndexVar == CONST_LIT_FALSE)
+			{
+				continue;
+			}
+
+			xMatches[x - GetFirstIndex()].emplace_back(negIndexVar);
 			yMatches[y - GetFirstIndex()].emplace_back(negIndexVar);
 
 			size_t matrixActuallPos = GetAbsMatrixPosFromIndexes(x, y);
@@ -22,9 +22,16 @@ public:
 
 protected:
 
+    // allocate the matrix and create two vars for each index
+    // the neg var is created only if neg map is allowed or it is required by indexMapping, otherwise it is CONST_LIT_FALSE
+    void CreateMatrixVars(const MatrixIndexVecMatch& indexMapping);
+
     // get index in the m_DataMatchMatrix with (x,y) coord
     // depend if x,y are negatives return IndexVars[0] if positive otherwise IndexVars[1] if negative
     SATLIT GetIndexVar(const MatrixIndexMatch& match) const;
+
+    // the match is represented by its index var
+    std::vector<SATLIT> GetMatchCube(const MatrixIndexMatch& match) const { return {GetIndexVar(match)}; };
     
     SATLIT GetIndexVar(int x, int y) const;
 
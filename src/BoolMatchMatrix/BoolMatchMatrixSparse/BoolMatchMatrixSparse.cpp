@@ -0,0 +1,213 @@
+#include "BoolMatchMatrix/BoolMatchMatrixSparse/BoolMatchMatrixSparse.hpp"
+
+using namespace std;
+
+BoolMatchMatrixSparse::BoolMatchMatrixSparse(BoolMatchSolverBase* solver, unsigned inputSize, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+	bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector, const MatrixIndexVecMatch& feasibleMatches):
+BoolMatchMatrixBase(solver, inputSize, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector)
+{
+	CreateMatrixVars(indexMapping, feasibleMatches);
+
+    // assert the row and col
+    AssertRowAndCol(indexMapping);
+}
+
+BoolMatchMatrixSparse::BoolMatchMatrixSparse(BoolMatchSolverBase* solver, vector<SATLIT> srcInputs, vector<SATLIT> trgInputs, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+        bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector, const MatrixIndexVecMatch& feasibleMatches):
+BoolMatchMatrixBase(solver, srcInputs, trgInputs, blockMatchTypeWithInputsVal, allowNegMap, indexMapping, useMatchSelector)
+{
+	CreateMatrixVars(indexMapping, feasibleMatches);
+
+	// connect only the feasible matches with the given inputs (SATLIT)
+	for (const MatrixIndexVecMatch& rowMatches : m_RowFeasibleMatches)
+	{
+		for (const MatrixIndexMatch& match : rowMatches)
+		{
+			SATLIT matchVar = GetIndexVar(match);
+			SATLIT srcInp = srcInputs[GetAbsRealIndex(match.first)];
+			SATLIT trgInp = trgInputs[GetAbsRealIndex(match.second)];
+
+			if (IsMatchPos(match))
+			{
+				// match pos -> assert no 0,1 or 1,0
+				m_Solver->AddClause({ NegateSATLit(matchVar), srcInp, NegateSATLit(trgInp) });
+				m_Solver->AddClause({ NegateSATLit(matchVar), NegateSATLit(srcInp), trgInp});
+			}
+			else
+			{
+				// match neg -> assert no 0,0 or 1,1
+				m_Solver->AddClause({ NegateSATLit(matchVar), srcInp, trgInp });
+				m_Solver->AddClause({ NegateSATLit(matchVar), NegateSATLit(srcInp), NegateSATLit(trgInp)});
+			}
+		}
+	}
+
+    // assert the row and col
+    AssertRowAndCol(indexMapping);
+}
+
+MatrixIndexVecMatch BoolMatchMatrixSparse::GetCurrMatch() const
+{
+    MatrixIndexVecMatch currMatch(GetMatrixColRowSize());
+
+	for (size_t x = 0; x < m_RowFeasibleMatches.size(); x++)
+	{
+		for (const MatrixIndexMatch& match : m_RowFeasibleMatches[x])
+		{
+			if (m_Solver->IsSATLitSatisfied(GetIndexVar(match)))
+			{
+				currMatch[x] = match;
+				break;
+			}
+		}
+	}
+
+	return currMatch;
+}
+
+void BoolMatchMatrixSparse::CreateMatrixVars(const MatrixIndexVecMatch& indexMapping, const MatrixIndexVecMatch& feasibleMatches)
+{
+	m_RowFeasibleMatches.assign(GetMatrixColRowSize(), MatrixIndexVecMatch());
+
+	if (feasibleMatches.empty())
+	{
+		// all the matches are feasible
+		for (unsigned x = GetFirstIndex(); x <= GetMatrixColRowSize(); x++)
+		{
+			for (unsigned y = GetFirstIndex(); y <= GetMatrixColRowSize(); y++)
+			{
+				AddFeasibleMatch({(int)x, (int)y});
+				if (m_NegMapIsAllowed)
+				{
+					AddFeasibleMatch({(int)x, -(int)y});
+				}
+			}
+		}
+	}
+	else
+	{
+		for (const MatrixIndexMatch& match : feasibleMatches)
+		{
+			// neg match is not feasible if neg map is not allowed
+			if (m_NegMapIsAllowed || IsMatchPos(match))
+			{
+				AddFeasibleMatch(match);
+			}
+		}
+	}
+
+	// the mapping must be feasible, even if it is a neg match and neg map is not allowed
+	for (const MatrixIndexMatch& indexMatch : indexMapping)
+	{
+		AddFeasibleMatch(indexMatch);
+	}
+}
+
+void BoolMatchMatrixSparse::AddFeasibleMatch(const MatrixIndexMatch& match)
+{
+	// matrix index can not be 0
+	assert(match.first != 0 && match.second != 0);
+
+	size_t key = GetMatchKey(match);
+	if (m_FeasibleMatchVars.find(key) != m_FeasibleMatchVars.end())
+	{
+		return;
+	}
+
+	m_FeasibleMatchVars[key] = GetNewMatrixVar();
+
+	// save the match in the form of (x,y) or (x,-y)
+	int x = (int)GetAbsRealIndex(match.first) + 1;
+	int y = (int)GetAbsRealIndex(match.second) + 1;
+	m_RowFeasibleMatches[x - 1].push_back({x, IsMatchPos(match) ? y : -y});
+}
+
+size_t BoolMatchMatrixSparse::GetMatchKey(const MatrixIndexMatch& match) const
+{
+	return 2 * GetAbsMatrixPosFromIndexes(match) + (IsMatchPos(match) ? 0 : 1);
+}
+
+SATLIT BoolMatchMatrixSparse::GetIndexVar(const MatrixIndexMatch& match) const
+{
+	auto it = m_FeasibleMatchVars.find(GetMatchKey(match));
+	return it != m_FeasibleMatchVars.end() ? it->second : CONST_LIT_FALSE;
+}
+
+void BoolMatchMatrixSparse::AssertRowAndCol(const MatrixIndexVecMatch& indexMapping)
+{
+	// iterate over all the index mapping which we need to assume
+	for (const MatrixIndexMatch& indexMatch : indexMapping)
+	{
+		m_Solver->AddClause(GetIndexVar(indexMatch));
+	}
+
+	vector<vector<SATLIT>> xMatches(GetMatrixColRowSize());
+	vector<vector<SATLIT>> yMatches(GetMatrixColRowSize());
+
+	for (const MatrixIndexVecMatch& rowMatches : m_RowFeasibleMatches)
+	{
+		for (const MatrixIndexMatch& match : rowMatches)
+		{
+			SATLIT matchVar = GetIndexVar(match);
+			xMatches[GetAbsRealIndex(match.first)].push_back(matchVar);
+			yMatches[GetAbsRealIndex(match.second)].push_back(matchVar);
+		}
+	}
+
+	// one match exactly from each row and col
+	// a row or col without feasible matches is asserted false, meaning there is no match
+	for (auto& xMatch : xMatches)
+	{
+		AddClauseWithConst(xMatch);
+		m_Solver->AssertAtMostOne(xMatch);
+	}
+	for (auto& yMatch : yMatches)
+	{
+		AddClauseWithConst(yMatch);
+		m_Solver->AssertAtMostOne(yMatch);
+	}
+}
+
+void BoolMatchMatrixSparse::_EliminateMatch(const MatrixIndexVecMatch& matchToElim, const bool ignoreSelector)
+{
+	vector<SATLIT> matrixVars;
+	// reserve one var per match
+	matrixVars.reserve(matchToElim.size() + 1);
+
+	for (const MatrixIndexMatch& singleMatch : matchToElim)
+	{
+		// a non feasible match is negated to CONST_LIT_TRUE, so the clause is skipped
+		matrixVars.push_back(NegateSATLit(GetIndexVar(singleMatch)));
+	}
+
+	if (m_UseMatchSelector && !ignoreSelector)
+	{
+		matrixVars.push_back(NegateSATLit(m_MatchSelector));
+	}
+
+	AddClauseWithConst(matrixVars);
+
+	m_NumOfBlockedClsMatches += 1;
+}
+
+void BoolMatchMatrixSparse::_EnforceMatch(const MatrixIndexVecMatch& matchToEnforce)
+{
+	vector<SATLIT> matrixVars;
+	// reserve one var per match
+	matrixVars.reserve(matchToEnforce.size() + 1);
+
+	for (const MatrixIndexMatch& singleMatch : matchToEnforce)
+	{
+		// a non feasible match is CONST_LIT_FALSE and removed from the clause
+		matrixVars.push_back(GetIndexVar(singleMatch));
+	}
+
+	if (m_UseMatchSelector)
+	{
+		matrixVars.push_back(NegateSATLit(m_MatchSelector));
+	}
+
+	AddClauseWithConst(matrixVars);
+
+	m_NumOfBlockedClsMatches += 1;
+}
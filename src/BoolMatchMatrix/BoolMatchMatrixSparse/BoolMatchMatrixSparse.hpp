@@ -0,0 +1,68 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "BoolMatchMatrix/BoolMatchMatrixBase.hpp"
+
+/*
+    match matrix that hold a var only for the feasible matches (x,y,polarity)
+    the feasible matches are given by the caller (input classes, user constraints, structural analysis etc..)
+    any other match is CONST_LIT_FALSE, so the memory and the decoding of the current match are O(number of feasible matches) instead of O(n^2)
+*/
+class BoolMatchMatrixSparse : virtual public BoolMatchMatrixBase
+{
+
+public:
+    // initialize the class
+    // call the base class constructor
+    // feasibleMatches - the matches that can be used, if empty all the matches are feasible (neg matches only if neg map is allowed)
+    // NOTE: the matches of indexMapping are always feasible
+    BoolMatchMatrixSparse(BoolMatchSolverBase* solver, unsigned inputSize, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+        bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector, const MatrixIndexVecMatch& feasibleMatches);
+
+    // initialize the class witht the circuits inputs
+    // call the base class constructor
+    BoolMatchMatrixSparse(BoolMatchSolverBase* solver, std::vector<SATLIT> srcInputs, std::vector<SATLIT> trgInputs, const BoolMatchBlockType& blockMatchTypeWithInputsVal,
+        bool allowNegMap, const MatrixIndexVecMatch& indexMapping, bool useMatchSelector, const MatrixIndexVecMatch& feasibleMatches);
+
+    // get the current match 
+    MatrixIndexVecMatch GetCurrMatch() const;
+
+    // return the number of feasible matches
+    size_t GetNumOfFeasibleMatches() const { return m_FeasibleMatchVars.size(); };
+
+protected:
+
+    // create a var for each feasible match
+    void CreateMatrixVars(const MatrixIndexVecMatch& indexMapping, const MatrixIndexVecMatch& feasibleMatches);
+
+    // add a var for the match if it was not already added
+    void AddFeasibleMatch(const MatrixIndexMatch& match);
+
+    // the key of the match in m_FeasibleMatchVars
+    size_t GetMatchKey(const MatrixIndexMatch& match) const;
+
+    // get the var of the match, CONST_LIT_FALSE if the match is not feasible
+    SATLIT GetIndexVar(const MatrixIndexMatch& match) const;
+
+    // the match is represented by its index var
+    std::vector<SATLIT> GetMatchCube(const MatrixIndexMatch& match) const { return {GetIndexVar(match)}; };
+
+    // assert exactly 1 on every col and row, only over the feasible matches
+    // indexMapping: if given index mapping is not empty assert the mapping
+    void AssertRowAndCol(const MatrixIndexVecMatch& indexMapping);
+
+    // eliminate combination of matches
+    void _EliminateMatch(const MatrixIndexVecMatch& matchToElim, const bool ignoreSelector = false);
+    // enforce combinations of matches
+    void _EnforceMatch(const MatrixIndexVecMatch& matchToEnforce);
+
+    /* Vars */
+
+    // hold the var of each feasible match
+    // the key is 2 * matrix position + (0 for pos match, 1 for neg match)
+    std::unordered_map<size_t, SATLIT> m_FeasibleMatchVars;
+
+    // for each row hold its feasible matches, in the form of (x,y) or (x,-y)
+    std::vector<MatrixIndexVecMatch> m_RowFeasibleMatches;
+};
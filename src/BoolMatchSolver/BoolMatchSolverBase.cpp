@@ -12,7 +12,9 @@ m_IsSolverInitFromAIG(false),
 m_TargetSATLitOffset(0),
 m_MaxVar(1),
 m_SrcOutputLit(0),
-m_TrgOutputLit(0)
+m_TrgOutputLit(0),
+m_OutputDiffLits({CONST_LIT_TRUE, CONST_LIT_TRUE}),
+m_OutputDiffAssump(CONST_LIT_TRUE)
 {
 }
 
@@ -422,6 +424,17 @@ SATLIT BoolMatchSolverBase::GetInputWeakEqAssmp(AIGLIT srcAIGLit, AIGLIT trgAIGL
     return res;
 }
 
+vector<SATLIT> BoolMatchSolverBase::GetInputDCAssmp(AIGLIT aigLit, bool isLitFromSrc) const
+{
+    assert(m_IsSolverInitFromAIG);
+    // assert that we are in dr encoding
+    assert(m_CirEncoding == DUALRAIL_ENC);
+
+    DRVAR drVar = AIGLitToDR(aigLit, isLitFromSrc ? 0 : m_TargetSATLitOffset);
+
+    return {NegateSATLit(GetPos(drVar)), NegateSATLit(GetNeg(drVar))};
+}
+
 TVal BoolMatchSolverBase::GetTValFromAIGLit(AIGLIT aigLit, bool isLitFromSrc) const
 {
     assert(m_IsSolverInitFromAIG);
@@ -731,6 +744,46 @@ void BoolMatchSolverBase::AssertOutputDiff(bool isNegMatch)
     }
 }
 
+void BoolMatchSolverBase::CreateOutputDiffForBothPolarities()
+{
+    assert(m_IsSolverInitFromAIG);
+    switch (m_CirEncoding)
+    {
+        case TSEITIN_ENC:
+        {
+            // the outputs differ from the negated target output iff they are equal
+            SATLIT srcOutVar = AIGLitToSATLit(m_SrcOutputLit, 0);
+            SATLIT trgOutVar = AIGLitToSATLit(m_TrgOutputLit, m_TargetSATLitOffset);
+            m_OutputDiffLits[0] = IsNotEqual(srcOutVar, trgOutVar);
+            m_OutputDiffLits[1] = NegateSATLit(m_OutputDiffLits[0]);
+        break;
+        }
+        case DUALRAIL_ENC:
+        {
+            // X is neither equal nor different, so each polarity has its own lit
+            DRVAR srcOutDRVar = AIGLitToDR(m_SrcOutputLit, 0);
+            DRVAR trgOutDRVar = AIGLitToDR(m_TrgOutputLit, m_TargetSATLitOffset);
+            m_OutputDiffLits[0] = IsNotEqualDR(srcOutDRVar, trgOutDRVar);
+            m_OutputDiffLits[1] = IsNotEqualDR(srcOutDRVar, NegateDRVar(trgOutDRVar));
+        break;
+        }
+        default:
+        {
+            throw runtime_error("Unkown circuit encoding");
+
+        break;
+        }
+    }
+
+    SetOutputNegMatch(false);
+}
+
+void BoolMatchSolverBase::SetOutputNegMatch(bool isNegMatch)
+{
+    assert(m_OutputDiffLits[0] != CONST_LIT_TRUE);
+    m_OutputDiffAssump = m_OutputDiffLits[isNegMatch ? 1 : 0];
+}
+
 void BoolMatchSolverBase::WriteAnd(SATLIT l, SATLIT r1, SATLIT r2)
 {
     AddClause({l, NegateSATLit(r1), NegateSATLit(r2)});
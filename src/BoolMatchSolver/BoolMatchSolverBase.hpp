@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <unordered_map>
 #include <utility>
@@ -129,6 +130,14 @@ public:
 
     void BoostInputScore(AIGLIT lit, bool isSrc, double value = 1.0);
 
+    // fix the polarity for a general SAT lit (i.e. match matrix vars)
+    // Note: does not work for ipasir solvers
+    void FixLitPolarity(SATLIT lit, bool onlyOnce = false) { _FixPolarity(lit, onlyOnce); };
+
+    // boost the score for a general SAT lit (i.e. match matrix vars)
+    // Note: does not work for ipasir solvers
+    void BoostLitScore(SATLIT lit, double value = 1.0) { _BoostScore(AbsSATLit(lit), value); };
+
     // get the circuit encoding for the current solver
     const CirEncoding& GetEnc() const;
 
@@ -142,6 +151,9 @@ public:
 
     SATLIT GetInputWeakEqAssmp(AIGLIT srcAIGLit, AIGLIT trgAIGLit, bool isEq, bool useVeryWeakEq = false);
 
+    // the assumptions that the input is X (both rails are 0), only for the DR enc
+    std::vector<SATLIT> GetInputDCAssmp(AIGLIT aigLit, bool isLitFromSrc) const;
+
     // value from AIG index, used only on the circuit inputs
     TVal GetTValFromAIGLit(AIGLIT aigLit, bool isLitFromSrc) const;
 
@@ -173,6 +185,13 @@ public:
     // NOTE: currently we assume only 1 output
     void AssertOutputDiff(bool isNegMatch);
 
+    // create the mitter on the outputs for both the positive and the negated target output, without asserting any of them
+    // the mitter chosen by SetOutputNegMatch is added as the last assumption of every solve call, so the positions of the given assumptions are kept
+    void CreateOutputDiffForBothPolarities();
+
+    // choose the mitter created by CreateOutputDiffForBothPolarities, i.e. if the outputs differ from the negated target output
+    void SetOutputNegMatch(bool isNegMatch);
+
 protected:
 
     // handle every new SAT lit that is added to the solver
@@ -248,6 +267,11 @@ protected:
     AIGLIT m_SrcOutputLit;
     AIGLIT m_TrgOutputLit;
 
+    // the lits that the outputs differ, from the positive [0] and the negated [1] target output, CONST_LIT_TRUE if not created
+    std::array<SATLIT, 2> m_OutputDiffLits;
+    // the mitter lit added to the assumptions of every solve call, CONST_LIT_TRUE if none
+    SATLIT m_OutputDiffAssump;
+
     // for each 2 AIGLIT inputs we save the SAT lit that represent the equality
     std::unordered_map<std::pair<AIGLIT, AIGLIT>, SATLIT, pair_hash> m_InputEqAssmpMap;
 
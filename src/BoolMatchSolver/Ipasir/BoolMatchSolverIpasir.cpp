@@ -47,6 +47,11 @@ void BoolMatchSolverIpasir::AddClause(const vector<SATLIT>& cls)
 
 SOLVER_RET_STATUS BoolMatchSolverIpasir::Solve()
 {
+    if (m_OutputDiffAssump != CONST_LIT_TRUE)
+    {
+        ipasir_assume(m_IpasirSolver, m_OutputDiffAssump);
+    }
+
     return ipasir_solve(m_IpasirSolver);
 }
 
@@ -57,6 +62,11 @@ SOLVER_RET_STATUS BoolMatchSolverIpasir::SolveUnderAssump(std::vector<SATLIT>& a
     {
         ipasir_assume(m_IpasirSolver, lit);
     }
+    // the mitter is the last assumption, so the positions of the given ones are kept
+    if (m_OutputDiffAssump != CONST_LIT_TRUE)
+    {
+        ipasir_assume(m_IpasirSolver, m_OutputDiffAssump);
+    }
 
     return ipasir_solve(m_IpasirSolver);
 }
@@ -68,6 +78,11 @@ SOLVER_RET_STATUS BoolMatchSolverIpasir::SolveUnderAssump(const std::vector<SATL
     {
         ipasir_assume(m_IpasirSolver, lit);
     }
+    // the mitter is the last assumption, so the positions of the given ones are kept
+    if (m_OutputDiffAssump != CONST_LIT_TRUE)
+    {
+        ipasir_assume(m_IpasirSolver, m_OutputDiffAssump);
+    }
 
     return ipasir_solve(m_IpasirSolver);
 }
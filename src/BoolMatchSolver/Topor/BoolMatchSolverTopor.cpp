@@ -52,11 +52,26 @@ void BoolMatchSolverTopor::AddClause(const vector<SATLIT>& cls)
 
 SOLVER_RET_STATUS BoolMatchSolverTopor::Solve()
 {
+    if (m_OutputDiffAssump != CONST_LIT_TRUE)
+    {
+        vector<SATLIT> assmp;
+        return SolveUnderAssump(assmp);
+    }
+
     return GetToporResult(m_ToporSolver->Solve());
 }
 
 SOLVER_RET_STATUS BoolMatchSolverTopor::SolveUnderAssump(std::vector<SATLIT>& assmp)
 {
+    if (m_OutputDiffAssump != CONST_LIT_TRUE)
+    {
+        // the mitter is the last assumption, so the positions of the given ones are kept
+        assmp.push_back(m_OutputDiffAssump);
+        SOLVER_RET_STATUS res = GetToporResult(m_ToporSolver->Solve(assmp));
+        assmp.pop_back();
+        return res;
+    }
+
     return GetToporResult(m_ToporSolver->Solve(assmp));
 }
 
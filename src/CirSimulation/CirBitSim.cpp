@@ -0,0 +1,39 @@
+#include "CirBitSim.hpp"
+
+using namespace std;
+
+CirBitSim::CirBitSim(const AigerParser& aigerParser):
+m_Inputs(aigerParser.GetInputs()), m_Outputs(aigerParser.GetOutputs()), m_AndGates(aigerParser.GetAndGated())
+{
+    m_IndexSimVal.resize((size_t)aigerParser.GetMaxIndex() + 1, 0);
+};
+
+uint64_t CirBitSim::SimulateOutput(const vector<uint64_t>& inputsVal, const size_t outIndex)
+{
+    Simulate(inputsVal);
+
+    return GetSimValForLit(m_Outputs[outIndex]);
+}
+
+void CirBitSim::Simulate(const vector<uint64_t>& inputsVal)
+{
+    assert(inputsVal.size() == m_Inputs.size());
+
+    for (size_t i = 0; i < m_Inputs.size(); i++)
+    {
+        m_IndexSimVal[AIGLitToAIGIndex(m_Inputs[i])] = inputsVal[i];
+    }
+
+    // we assume the gates are in order from bottom-up
+    for (const AigAndGate& gate : m_AndGates)
+    {
+        m_IndexSimVal[AIGLitToAIGIndex(gate.GetL())] = GetSimValForLit(gate.GetR0()) & GetSimValForLit(gate.GetR1());
+    }
+}
+
+uint64_t CirBitSim::GetSimValForLit(AIGLIT lit) const
+{
+    // index 0 is the const false
+    uint64_t val = AIGLitToAIGIndex(lit) == 0 ? 0 : m_IndexSimVal[AIGLitToAIGIndex(lit)];
+    return IsAIGLitNeg(lit) ? ~val : val;
+}
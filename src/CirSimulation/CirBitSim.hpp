@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "Globals/BoolMatchGloblas.hpp"
+#include "Aiger/AigerParser.hpp"
+
+/*
+    class for bit-parallel (64 patterns) simulation of the circuit
+    get the aig from AigerParser class
+*/
+class CirBitSim
+{
+public:
+    CirBitSim(const AigerParser& aigerParser);
+
+    // simulate 64 patterns at once, inputsVal[i] hold the patterns of the i'th input
+    // return the patterns of the output
+    uint64_t SimulateOutput(const std::vector<uint64_t>& inputsVal, const size_t outIndex = 0);
+
+    // simulate 64 patterns at once, the value of any lit is then given by GetSimValForLit
+    void Simulate(const std::vector<uint64_t>& inputsVal);
+
+    // get the simulated value of the lit
+    uint64_t GetSimValForLit(AIGLIT lit) const;
+
+    size_t GetNumOfInputs() const { return m_Inputs.size(); };
+
+protected:
+
+    // hold the inputs
+    const std::vector<AIGLIT> m_Inputs;
+    // hold all the outputs
+    const std::vector<AIGLIT> m_Outputs;
+    // hold all the gates
+    const std::vector<AigAndGate> m_AndGates;
+
+    // for every AIGINDEX hold the curr simulated value
+    std::vector<uint64_t> m_IndexSimVal;
+};
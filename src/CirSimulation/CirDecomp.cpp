@@ -0,0 +1,494 @@
+#include "CirDecomp.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <random>
+
+using namespace std;
+
+// the patterns of the first 6 vars in a truth table word
+static const uint64_t VAR_MASKS[6] = {0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+
+// existentially quantify the vars in varsMask out of the truth table
+static vector<uint64_t> ExistsVars(const vector<uint64_t>& tt, uint32_t varsMask)
+{
+    vector<uint64_t> res = tt;
+    for (unsigned var = 0; varsMask != 0; var++, varsMask >>= 1)
+    {
+        if ((varsMask & 1) == 0)
+        {
+            continue;
+        }
+
+        if (var < 6)
+        {
+            const unsigned shift = 1u << var;
+            for (uint64_t& word : res)
+            {
+                const uint64_t hi = word & VAR_MASKS[var];
+                const uint64_t lo = word & ~VAR_MASKS[var];
+                word = hi | (hi >> shift) | lo | (lo << shift);
+            }
+        }
+        else
+        {
+            const size_t step = (size_t)1 << (var - 6);
+            for (size_t w = 0; w < res.size(); w += 2 * step)
+            {
+                for (size_t j = w; j < w + step; j++)
+                {
+                    res[j] |= res[j + step];
+                    res[j + step] = res[j];
+                }
+            }
+        }
+    }
+
+    return res;
+}
+
+// the number of ones of a truth table over numOfVars vars
+static uint64_t CountOnes(const vector<uint64_t>& tt, unsigned numOfVars)
+{
+    uint64_t numOfOnes = 0;
+    for (const uint64_t word : tt)
+    {
+        numOfOnes += popcount(word);
+    }
+
+    // a table of less than 6 vars is repeated in the word
+    return numOfVars < 6 ? numOfOnes >> (6 - numOfVars) : numOfOnes;
+}
+
+
+CirDecomp::CirDecomp(const AigerParser& aigerParser, bool isOutputNeg, unsigned maxExactBlockSize):
+m_Inputs(aigerParser.GetInputs()), m_Outputs(aigerParser.GetOutputs()),
+m_BitSim(aigerParser),
+m_IsDecomposed(false),
+m_NumOfBlocks(0),
+m_NumOfExactBlocks(0)
+{
+    const size_t inputSize = m_Inputs.size();
+    const size_t maxIndex = (size_t)aigerParser.GetMaxIndex();
+    maxExactBlockSize = min(maxExactBlockSize, MAX_EXACT_BLOCK_SIZE);
+
+    m_GateInputs.resize(maxIndex + 1, {0, 0});
+    for (const AigAndGate& gate : aigerParser.GetAndGated())
+    {
+        m_GateInputs[AIGLitToAIGIndex(gate.GetL())] = {gate.GetR0(), gate.GetR1()};
+    }
+
+    m_InputPos.resize(maxIndex + 1, -1);
+    for (size_t i = 0; i < inputSize; i++)
+    {
+        m_InputPos[AIGLitToAIGIndex(m_Inputs[i])] = (int)i;
+    }
+
+    m_IsIndexVisited.resize(maxIndex + 1, false);
+
+    // nothing is known on the inputs unless the decomposition succeeds
+    auto setNotDecomposed = [&]()
+    {
+        m_InputKind.assign(inputSize, InputKind::INEXACT);
+        m_BlockSize.assign(inputSize, inputSize);
+        m_BlockOnsetSize.assign(inputSize, 0);
+        m_IsDecomposed = false;
+        m_NumOfBlocks = 0;
+        m_NumOfExactBlocks = 0;
+    };
+
+    setNotDecomposed();
+
+    const AIGLIT rootLit = isOutputNeg ? NegateAIGLit(m_Outputs[0]) : m_Outputs[0];
+
+    // group the leaves with a shared input into a block, by union-find over the inputs
+    vector<size_t> inputParent(inputSize);
+    iota(inputParent.begin(), inputParent.end(), 0);
+    auto findRoot = [&](size_t i) -> size_t
+    {
+        while (inputParent[i] != i)
+        {
+            inputParent[i] = inputParent[inputParent[i]];
+            i = inputParent[i];
+        }
+        return i;
+    };
+
+    vector<AIGLIT> leaves;
+    vector<size_t> leafFirstInput;
+    vector<bool> isInSupport(inputSize, false);
+    for (const AIGLIT leaf : GetAndLeaves(rootLit))
+    {
+        if (AIGLitToAIGIndex(leaf) == 0)
+        {
+            if (!IsAIGLitNeg(leaf))
+            {
+                // the output is zero
+                return;
+            }
+            // a true leaf does not change the AND
+            continue;
+        }
+
+        vector<size_t> support = GetSupport(leaf);
+        for (size_t i : support)
+        {
+            isInSupport[i] = true;
+            inputParent[findRoot(i)] = findRoot(support[0]);
+        }
+
+        leaves.push_back(leaf);
+        leafFirstInput.push_back(support[0]);
+    }
+
+    // the inputs and the leaves of each block
+    vector<int> blockOfRoot(inputSize, -1);
+    vector<vector<size_t>> inputsOfBlock;
+    vector<vector<AIGLIT>> leavesOfBlock;
+    for (size_t i = 0; i < inputSize; i++)
+    {
+        if (!isInSupport[i])
+        {
+            continue;
+        }
+
+        const size_t root = findRoot(i);
+        if (blockOfRoot[root] < 0)
+        {
+            blockOfRoot[root] = (int)inputsOfBlock.size();
+            inputsOfBlock.emplace_back();
+            leavesOfBlock.emplace_back();
+        }
+        inputsOfBlock[blockOfRoot[root]].push_back(i);
+    }
+    for (size_t l = 0; l < leaves.size(); l++)
+    {
+        leavesOfBlock[blockOfRoot[findRoot(leafFirstInput[l])]].push_back(leaves[l]);
+    }
+
+    // the inputs not in the cone of the output
+    for (size_t i = 0; i < inputSize; i++)
+    {
+        if (!isInSupport[i])
+        {
+            m_InputKind[i] = InputKind::NOT_ESSENTIAL;
+        }
+    }
+
+    vector<vector<AIGLIT>> leavesOfInexactBlock;
+    for (size_t b = 0; b < inputsOfBlock.size(); b++)
+    {
+        if (inputsOfBlock[b].size() <= maxExactBlockSize)
+        {
+            if (!RefineExactBlock(leavesOfBlock[b], inputsOfBlock[b]))
+            {
+                // the output is zero
+                setNotDecomposed();
+                return;
+            }
+        }
+        else
+        {
+            for (size_t i : inputsOfBlock[b])
+            {
+                m_BlockSize[i] = inputsOfBlock[b].size();
+            }
+            leavesOfInexactBlock.push_back(leavesOfBlock[b]);
+        }
+    }
+
+    // the exact blocks of the other circuit are inside the blocks only if the output is not zero
+    if (!IsNonZeroBySim(leavesOfInexactBlock))
+    {
+        setNotDecomposed();
+        return;
+    }
+
+    // a structural block may be refined into several exact blocks
+    m_NumOfBlocks = m_NumOfExactBlocks + leavesOfInexactBlock.size();
+    m_IsDecomposed = true;
+}
+
+vector<pair<size_t, size_t>> CirDecomp::GetForbiddenPairs(const CirDecomp& srcDecomp, const CirDecomp& trgDecomp)
+{
+    vector<pair<size_t, size_t>> forbiddenPairs;
+    if (!srcDecomp.m_IsDecomposed || !trgDecomp.m_IsDecomposed)
+    {
+        return forbiddenPairs;
+    }
+
+    for (size_t x = 0; x < srcDecomp.m_Inputs.size(); x++)
+    {
+        const InputKind srcKind = srcDecomp.m_InputKind[x];
+        for (size_t y = 0; y < trgDecomp.m_Inputs.size(); y++)
+        {
+            const InputKind trgKind = trgDecomp.m_InputKind[y];
+
+            bool isForbidden = false;
+            if (srcKind == InputKind::EXACT && trgKind == InputKind::EXACT)
+            {
+                // an exact block is mapped onto an exact block of the same function
+                isForbidden = srcDecomp.m_BlockSize[x] != trgDecomp.m_BlockSize[y] || srcDecomp.m_BlockOnsetSize[x] != trgDecomp.m_BlockOnsetSize[y];
+            }
+            else if (srcKind == InputKind::EXACT)
+            {
+                // an exact block is mapped inside a single block of the other circuit
+                isForbidden = trgKind == InputKind::NOT_ESSENTIAL || srcDecomp.m_BlockSize[x] > trgDecomp.m_BlockSize[y];
+            }
+            else if (trgKind == InputKind::EXACT)
+            {
+                isForbidden = srcKind == InputKind::NOT_ESSENTIAL || trgDecomp.m_BlockSize[y] > srcDecomp.m_BlockSize[x];
+            }
+
+            if (isForbidden)
+            {
+                forbiddenPairs.push_back({x, y});
+            }
+        }
+    }
+
+    return forbiddenPairs;
+}
+
+vector<AIGLIT> CirDecomp::GetAndLeaves(AIGLIT rootLit) const
+{
+    vector<AIGLIT> leaves;
+    // an AND gate with several fanouts may be reached more than once, and it is split only once
+    vector<bool> isLitVisited(2 * m_GateInputs.size(), false);
+    vector<AIGLIT> litsToVisit = {rootLit};
+
+    while (!litsToVisit.empty())
+    {
+        const AIGLIT lit = litsToVisit.back();
+        litsToVisit.pop_back();
+
+        if (isLitVisited[lit])
+        {
+            continue;
+        }
+        isLitVisited[lit] = true;
+
+        const AIGINDEX index = AIGLitToAIGIndex(lit);
+        const bool isGate = index != 0 && m_InputPos[index] < 0;
+        if (isGate && !IsAIGLitNeg(lit))
+        {
+            litsToVisit.push_back(m_GateInputs[index].first);
+            litsToVisit.push_back(m_GateInputs[index].second);
+        }
+        else
+        {
+            leaves.push_back(lit);
+        }
+    }
+
+    return leaves;
+}
+
+vector<size_t> CirDecomp::GetSupport(AIGLIT lit)
+{
+    vector<size_t> support;
+    vector<AIGINDEX> visitedIndexes;
+    vector<AIGINDEX> indexesToVisit = {AIGLitToAIGIndex(lit)};
+
+    while (!indexesToVisit.empty())
+    {
+        const AIGINDEX index = indexesToVisit.back();
+        indexesToVisit.pop_back();
+
+        if (index == 0 || m_IsIndexVisited[index])
+        {
+            continue;
+        }
+        m_IsIndexVisited[index] = true;
+        visitedIndexes.push_back(index);
+
+        if (m_InputPos[index] >= 0)
+        {
+            support.push_back((size_t)m_InputPos[index]);
+        }
+        else
+        {
+            indexesToVisit.push_back(AIGLitToAIGIndex(m_GateInputs[index].first));
+            indexesToVisit.push_back(AIGLitToAIGIndex(m_GateInputs[index].second));
+        }
+    }
+
+    for (const AIGINDEX index : visitedIndexes)
+    {
+        m_IsIndexVisited[index] = false;
+    }
+
+    // a non-const lit has at least one input in its cone
+    assert(!support.empty());
+    return support;
+}
+
+vector<uint64_t> CirDecomp::GetTruthTable(const vector<AIGLIT>& leaves, const vector<size_t>& blockInputs)
+{
+    const size_t numOfVars = blockInputs.size();
+    const size_t numOfWords = numOfVars > 6 ? (size_t)1 << (numOfVars - 6) : 1;
+
+    vector<uint64_t> inputsVal(m_Inputs.size(), 0);
+    vector<uint64_t> tt(numOfWords);
+    for (size_t w = 0; w < numOfWords; w++)
+    {
+        for (size_t k = 0; k < numOfVars; k++)
+        {
+            inputsVal[blockInputs[k]] = k < 6 ? VAR_MASKS[k] : (((w >> (k - 6)) & 1) ? ~0ULL : 0);
+        }
+
+        m_BitSim.Simulate(inputsVal);
+
+        tt[w] = ~0ULL;
+        for (const AIGLIT leaf : leaves)
+        {
+            tt[w] &= m_BitSim.GetSimValForLit(leaf);
+        }
+    }
+
+    return tt;
+}
+
+bool CirDecomp::RefineExactBlock(const vector<AIGLIT>& leaves, const vector<size_t>& blockInputs)
+{
+    const unsigned numOfVars = (unsigned)blockInputs.size();
+    const vector<uint64_t> tt = GetTruthTable(leaves, blockInputs);
+
+    if (CountOnes(tt, numOfVars) == 0)
+    {
+        return false;
+    }
+
+    // an input is essential if quantifying it out change the block function
+    uint32_t essentialVars = 0;
+    for (unsigned k = 0; k < numOfVars; k++)
+    {
+        if (ExistsVars(tt, 1u << k) != tt)
+        {
+            essentialVars |= 1u << k;
+        }
+        else
+        {
+            m_InputKind[blockInputs[k]] = InputKind::NOT_ESSENTIAL;
+        }
+    }
+
+    // the function is the AND of its projections on vars and on the other essential vars
+    auto isSeparable = [&](uint32_t vars) -> bool
+    {
+        const vector<uint64_t> varsProj = ExistsVars(tt, essentialVars & ~vars);
+        const vector<uint64_t> otherProj = ExistsVars(tt, vars);
+        for (size_t w = 0; w < tt.size(); w++)
+        {
+            if (tt[w] != (varsProj[w] & otherProj[w]))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    uint32_t uncoveredVars = essentialVars;
+    while (uncoveredVars != 0)
+    {
+        const unsigned var = (unsigned)countr_zero(uncoveredVars);
+
+        // the separable sets are the unions of the finest blocks, so the smallest one with var is its block
+        vector<unsigned> otherVars;
+        for (unsigned k = var + 1; k < numOfVars; k++)
+        {
+            if ((uncoveredVars >> k) & 1)
+            {
+                otherVars.push_back(k);
+            }
+        }
+
+        vector<uint32_t> candBlocks((size_t)1 << otherVars.size());
+        for (size_t s = 0; s < candBlocks.size(); s++)
+        {
+            candBlocks[s] = 1u << var;
+            for (size_t k = 0; k < otherVars.size(); k++)
+            {
+                if ((s >> k) & 1)
+                {
+                    candBlocks[s] |= 1u << otherVars[k];
+                }
+            }
+        }
+        stable_sort(candBlocks.begin(), candBlocks.end(), [](uint32_t a, uint32_t b) { return popcount(a) < popcount(b); });
+
+        // all the uncovered vars are always separable, since the covered vars are a union of blocks
+        uint32_t blockVars = uncoveredVars;
+        for (const uint32_t candBlock : candBlocks)
+        {
+            if (isSeparable(candBlock))
+            {
+                blockVars = candBlock;
+                break;
+            }
+        }
+
+        // the projection is over all the vars, so its onset is repeated for every value of the other vars
+        const unsigned blockSize = (unsigned)popcount(blockVars);
+        const uint64_t blockOnsetSize = CountOnes(ExistsVars(tt, essentialVars & ~blockVars), numOfVars) >> (numOfVars - blockSize);
+
+        for (unsigned k = 0; k < numOfVars; k++)
+        {
+            if ((blockVars >> k) & 1)
+            {
+                m_InputKind[blockInputs[k]] = InputKind::EXACT;
+                m_BlockSize[blockInputs[k]] = blockSize;
+                m_BlockOnsetSize[blockInputs[k]] = blockOnsetSize;
+            }
+        }
+
+        m_NumOfExactBlocks++;
+        uncoveredVars &= ~blockVars;
+    }
+
+    return true;
+}
+
+bool CirDecomp::IsNonZeroBySim(const vector<vector<AIGLIT>>& leavesOfBlock)
+{
+    // the same patterns in every run
+    mt19937_64 randGen(0);
+
+    vector<uint64_t> inputsVal(m_Inputs.size());
+    vector<bool> isNonZero(leavesOfBlock.size(), false);
+    size_t numOfNonZero = 0;
+
+    for (unsigned w = 0; w < NUM_OF_SIM_WORDS && numOfNonZero < leavesOfBlock.size(); w++)
+    {
+        for (uint64_t& val : inputsVal)
+        {
+            val = randGen();
+        }
+
+        m_BitSim.Simulate(inputsVal);
+
+        for (size_t b = 0; b < leavesOfBlock.size(); b++)
+        {
+            if (isNonZero[b])
+            {
+                continue;
+            }
+
+            uint64_t blockVal = ~0ULL;
+            for (const AIGLIT leaf : leavesOfBlock[b])
+            {
+                blockVal &= m_BitSim.GetSimValForLit(leaf);
+            }
+
+            if (blockVal != 0)
+            {
+                isNonZero[b] = true;
+                numOfNonZero++;
+            }
+        }
+    }
+
+    return numOfNonZero == leavesOfBlock.size();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+
+#include "Globals/BoolMatchGloblas.hpp"
+#include "Aiger/AigerParser.hpp"
+#include "CirSimulation/CirBitSim.hpp"
+
+/*
+    class for the top-level disjoint-support decomposition (DSD) of the circuit output, f = g1(X1) & g2(X2) & ..
+    the AND tree under the output is split into leaves, and leaves with a shared input are grouped into a block
+    a block with few inputs is simulated exhaustively and split again into its finest AND-decomposition, so its blocks are exact
+    the finest decomposition of a non-zero function is unique, so a valid match maps every exact block onto an exact block of the same size and onset
+    a block with many inputs is not exact, but the exact blocks of the other circuit it is matched to are inside it
+*/
+class CirDecomp
+{
+public:
+    // isOutputNeg - if to decompose the negated output, i.e. an OR decomposition of the output
+    // maxExactBlockSize - the max number of inputs of a block that is simulated exhaustively
+    CirDecomp(const AigerParser& aigerParser, bool isOutputNeg, unsigned maxExactBlockSize = DEF_MAX_EXACT_BLOCK_SIZE);
+
+    // get the pairs of src and trg inputs (start from 0) that are not in any valid match, by the decompositions of both circuits
+    // the pairs hold for both input polarities, since negating inputs does not change the blocks or their onset size
+    static std::vector<std::pair<size_t, size_t>> GetForbiddenPairs(const CirDecomp& srcDecomp, const CirDecomp& trgDecomp);
+
+    // false if the output may be zero, in this case the decomposition is not used
+    bool IsDecomposed() const { return m_IsDecomposed; };
+
+    size_t GetNumOfBlocks() const { return m_NumOfBlocks; };
+
+    size_t GetNumOfExactBlocks() const { return m_NumOfExactBlocks; };
+
+    static const unsigned DEF_MAX_EXACT_BLOCK_SIZE = 10;
+    // the refinement try the subsets of the block inputs, so the block size is limited
+    static const unsigned MAX_EXACT_BLOCK_SIZE = 14;
+    // the number of 64 bit random patterns words to check a block that is not exact is not zero
+    static const unsigned NUM_OF_SIM_WORDS = 64;
+
+protected:
+
+    enum class InputKind
+    {
+        // in an exact block
+        EXACT,
+        // the output does not depend on the input
+        NOT_ESSENTIAL,
+        // in a block that is too large to simulate
+        INEXACT
+    };
+
+    // split the AND tree under the lit into its leaves
+    std::vector<AIGLIT> GetAndLeaves(AIGLIT rootLit) const;
+
+    // get the inputs (positions) in the cone of the lit
+    std::vector<size_t> GetSupport(AIGLIT lit);
+
+    // get the truth table of the AND of the leaves over the block inputs, other inputs are 0
+    std::vector<uint64_t> GetTruthTable(const std::vector<AIGLIT>& leaves, const std::vector<size_t>& blockInputs);
+
+    // refine an exact block into its finest AND-decomposition, and set its inputs kind, block size and onset size
+    // return false if the block is zero
+    bool RefineExactBlock(const std::vector<AIGLIT>& leaves, const std::vector<size_t>& blockInputs);
+
+    // return true if the AND of the leaves of each block is not zero under some random pattern
+    bool IsNonZeroBySim(const std::vector<std::vector<AIGLIT>>& leavesOfBlock);
+
+    // hold the inputs
+    const std::vector<AIGLIT> m_Inputs;
+    // hold all the outputs
+    const std::vector<AIGLIT> m_Outputs;
+
+    // the two inputs of each AND gate by its AIGINDEX
+    std::vector<std::pair<AIGLIT, AIGLIT>> m_GateInputs;
+    // the position of each input by its AIGINDEX, -1 if the index is not an input
+    std::vector<int> m_InputPos;
+    // if the AIGINDEX was visited in the current cone, reset after each cone
+    std::vector<bool> m_IsIndexVisited;
+
+    // bit-parallel simulation of the circuit
+    CirBitSim m_BitSim;
+
+    bool m_IsDecomposed;
+
+    // *** Decomposition ***
+
+    // for every input its kind, the size of its block and the onset size of its block function (only for an exact block)
+    std::vector<InputKind> m_InputKind;
+    std::vector<size_t> m_BlockSize;
+    std::vector<uint64_t> m_BlockOnsetSize;
+
+    // *** Stats ***
+
+    // the number of blocks after the refinement of the small structural blocks, and how many of them are exact, 0 if not decomposed
+    size_t m_NumOfBlocks;
+    size_t m_NumOfExactBlocks;
+};
@@ -0,0 +1,123 @@
+#include "CirInputSig.hpp"
+
+#include <bit>
+#include <random>
+#include <cmath>
+
+using namespace std;
+
+CirInputSig::CirInputSig(const AigerParser& aigerParser, unsigned numOfSimWords):
+m_Inputs(aigerParser.GetInputs()), m_Outputs(aigerParser.GetOutputs()), m_AndGates(aigerParser.GetAndGated()),
+m_MaxIndex(aigerParser.GetMaxIndex()),
+m_BitSim(aigerParser)
+{
+    m_Depth.resize(m_Inputs.size(), 0);
+    m_Fanout.resize(m_Inputs.size(), 0);
+    m_Sensitivity.resize(m_Inputs.size(), 0);
+    m_OnesWhenTrue.resize(m_Inputs.size(), 0);
+    m_OnesWhenFalse.resize(m_Inputs.size(), 0);
+
+    ComputeStructSig();
+    ComputeSimSig(numOfSimWords);
+};
+
+double CirInputSig::GetSimilarity(const CirInputSig& srcSig, size_t x, const CirInputSig& trgSig, size_t y, bool isPos)
+{
+    // a neg match swap the cofactors of the trg input
+    double trgOnesWhenTrue = isPos ? trgSig.m_OnesWhenTrue[y] : trgSig.m_OnesWhenFalse[y];
+    double trgOnesWhenFalse = isPos ? trgSig.m_OnesWhenFalse[y] : trgSig.m_OnesWhenTrue[y];
+
+    // the simulation signatures are functional, so they get a larger weight than the structural ones
+    double dist = fabs(srcSig.m_Depth[x] - trgSig.m_Depth[y]) + fabs(srcSig.m_Fanout[x] - trgSig.m_Fanout[y]) +
+        2 * fabs(srcSig.m_Sensitivity[x] - trgSig.m_Sensitivity[y]) +
+        fabs(srcSig.m_OnesWhenTrue[x] - trgOnesWhenTrue) + fabs(srcSig.m_OnesWhenFalse[x] - trgOnesWhenFalse);
+
+    return 1.0 / (1.0 + dist);
+}
+
+void CirInputSig::ComputeStructSig()
+{
+    vector<unsigned> indexDepth((size_t)m_MaxIndex + 1, 0);
+    vector<unsigned> indexFanout((size_t)m_MaxIndex + 1, 0);
+
+    // the output is at depth 1, so inputs not in the output cone stay at 0
+    for (const AIGLIT outLit : m_Outputs)
+    {
+        indexDepth[AIGLitToAIGIndex(outLit)] = 1;
+    }
+
+    // we assume the gates are in order from bottom-up
+    for (auto gateRevIt = m_AndGates.rbegin(); gateRevIt != m_AndGates.rend(); ++gateRevIt)
+    {
+        unsigned gateDepth = indexDepth[AIGLitToAIGIndex(gateRevIt->GetL())];
+        for (const AIGLIT inLit : {gateRevIt->GetR0(), gateRevIt->GetR1()})
+        {
+            AIGINDEX inIndex = AIGLitToAIGIndex(inLit);
+            indexFanout[inIndex]++;
+            if (gateDepth > 0)
+            {
+                indexDepth[inIndex] = max(indexDepth[inIndex], gateDepth + 1);
+            }
+        }
+    }
+
+    unsigned maxDepth = 1;
+    unsigned maxFanout = 1;
+    for (const AIGLIT inputLit : m_Inputs)
+    {
+        maxDepth = max(maxDepth, indexDepth[AIGLitToAIGIndex(inputLit)]);
+        maxFanout = max(maxFanout, indexFanout[AIGLitToAIGIndex(inputLit)]);
+    }
+
+    for (size_t i = 0; i < m_Inputs.size(); i++)
+    {
+        m_Depth[i] = (double)indexDepth[AIGLitToAIGIndex(m_Inputs[i])] / maxDepth;
+        m_Fanout[i] = (double)indexFanout[AIGLitToAIGIndex(m_Inputs[i])] / maxFanout;
+    }
+}
+
+void CirInputSig::ComputeSimSig(unsigned numOfSimWords)
+{
+    // use a fixed seed so the signatures are deterministic
+    mt19937_64 randGen(0);
+
+    vector<unsigned> flipCount(m_Inputs.size(), 0);
+    vector<unsigned> onesWhenTrue(m_Inputs.size(), 0);
+    vector<unsigned> numOfTrue(m_Inputs.size(), 0);
+    vector<unsigned> onesWhenFalse(m_Inputs.size(), 0);
+
+    for (unsigned word = 0; word < numOfSimWords; word++)
+    {
+        vector<uint64_t> inputsVal(m_Inputs.size());
+        for (size_t i = 0; i < m_Inputs.size(); i++)
+        {
+            inputsVal[i] = randGen();
+        }
+
+        uint64_t outVal = m_BitSim.SimulateOutput(inputsVal);
+
+        for (size_t i = 0; i < m_Inputs.size(); i++)
+        {
+            numOfTrue[i] += popcount(inputsVal[i]);
+            onesWhenTrue[i] += popcount(outVal & inputsVal[i]);
+            onesWhenFalse[i] += popcount(outVal & ~inputsVal[i]);
+        }
+
+        // flip each input and check which patterns flip the output
+        for (size_t i = 0; i < m_Inputs.size(); i++)
+        {
+            inputsVal[i] = ~inputsVal[i];
+            flipCount[i] += popcount(outVal ^ m_BitSim.SimulateOutput(inputsVal));
+            inputsVal[i] = ~inputsVal[i];
+        }
+    }
+
+    const unsigned numOfPatterns = 64 * numOfSimWords;
+    for (size_t i = 0; i < m_Inputs.size(); i++)
+    {
+        unsigned numOfFalse = numOfPatterns - numOfTrue[i];
+        m_Sensitivity[i] = (double)flipCount[i] / numOfPatterns;
+        m_OnesWhenTrue[i] = numOfTrue[i] > 0 ? (double)onesWhenTrue[i] / numOfTrue[i] : 0;
+        m_OnesWhenFalse[i] = numOfFalse > 0 ? (double)onesWhenFalse[i] / numOfFalse : 0;
+    }
+}
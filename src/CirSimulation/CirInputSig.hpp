@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include "Globals/BoolMatchGloblas.hpp"
+#include "Aiger/AigerParser.hpp"
+#include "CirSimulation/CirBitSim.hpp"
+
+/*
+    class for cheap signatures of the circuit inputs
+    combine structural information (depth, fanout) with random bit-parallel simulation
+    the signatures are used as a similarity score between src and trg inputs, they do not prove anything about a match
+*/
+class CirInputSig
+{
+public:
+    // numOfSimWords - the number of 64 bit random patterns words to simulate
+    CirInputSig(const AigerParser& aigerParser, unsigned numOfSimWords = DEF_NUM_OF_SIM_WORDS);
+
+    // get the similarity between input x of srcSig and input y of trgSig (start from 0)
+    // isPos - if the match is positive, otherwise the cofactors of the trg input are swapped
+    // return a value in (0,1] where 1 means the signatures are identical
+    static double GetSimilarity(const CirInputSig& srcSig, size_t x, const CirInputSig& trgSig, size_t y, bool isPos);
+
+    static const unsigned DEF_NUM_OF_SIM_WORDS = 4;
+
+protected:
+
+    // compute the depth and the fanout of each input
+    void ComputeStructSig();
+
+    // compute the simulation signatures of each input
+    void ComputeSimSig(unsigned numOfSimWords);
+
+    // hold the inputs
+    const std::vector<AIGLIT> m_Inputs;
+    // hold all the outputs
+    const std::vector<AIGLIT> m_Outputs;
+    // hold all the gates
+    const std::vector<AigAndGate> m_AndGates;
+
+    const AIGINDEX m_MaxIndex;
+
+    // bit-parallel simulation of the circuit
+    CirBitSim m_BitSim;
+
+    // *** Signatures ***
+
+    // the longest path (number of gates) from the input to the output, relative to the circuit depth
+    std::vector<double> m_Depth;
+    // the number of gates the input is used in, relative to the max fanout
+    std::vector<double> m_Fanout;
+    // the fraction of patterns where flipping the input flips the output
+    std::vector<double> m_Sensitivity;
+    // the fraction of patterns where the output is 1 when the input is 1 -or- 0
+    std::vector<double> m_OnesWhenTrue;
+    std::vector<double> m_OnesWhenFalse;
+};
@@ -0,0 +1,159 @@
+#include "CirStructSig.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+CirStructSig::CirStructSig(const AigerParser& aigerParser, unsigned numOfRounds, bool isInputPolarityFree, bool isOutputPolarityFree):
+m_Inputs(aigerParser.GetInputs()),
+m_NumOfRounds(numOfRounds)
+{
+    m_Fingerprints.resize(m_NumOfRounds + 1, vector<uint64_t>(m_Inputs.size(), 0));
+
+    ComputeFingerprints(aigerParser, isInputPolarityFree, isOutputPolarityFree);
+};
+
+uint64_t CirStructSig::Mix(uint64_t h, uint64_t v)
+{
+    // splitmix64 finalizer over the combined value
+    uint64_t z = h ^ (v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+double CirStructSig::GetSimilarity(const CirStructSig& srcSig, size_t x, const CirStructSig& trgSig, size_t y)
+{
+    const unsigned numOfRounds = min(srcSig.m_NumOfRounds, trgSig.m_NumOfRounds);
+
+    // every round refines the previous one, so the fingerprints agree on a prefix of the rounds
+    unsigned numOfEqualRounds = 0;
+    while (numOfEqualRounds <= numOfRounds && srcSig.m_Fingerprints[numOfEqualRounds][x] == trgSig.m_Fingerprints[numOfEqualRounds][y])
+    {
+        numOfEqualRounds++;
+    }
+
+    return (double)(numOfEqualRounds + 1) / (numOfRounds + 2);
+}
+
+size_t CirStructSig::GetNumOfClasses() const
+{
+    vector<uint64_t> fingerprints = m_Fingerprints[m_NumOfRounds];
+    sort(fingerprints.begin(), fingerprints.end());
+    return (size_t)(unique(fingerprints.begin(), fingerprints.end()) - fingerprints.begin());
+}
+
+void CirStructSig::ComputeFingerprints(const AigerParser& aigerParser, bool isInputPolarityFree, bool isOutputPolarityFree)
+{
+    const vector<AigAndGate>& andGates = aigerParser.GetAndGated();
+    const vector<AIGLIT>& outputs = aigerParser.GetOutputs();
+    const size_t numOfIndexes = (size_t)aigerParser.GetMaxIndex() + 1;
+
+    enum NodeKind : uint64_t { CONST_NODE = 1, INPUT_NODE = 2, GATE_NODE = 3 };
+    vector<uint64_t> nodeKind(numOfIndexes, GATE_NODE);
+    nodeKind[0] = CONST_NODE;
+    for (const AIGLIT inputLit : m_Inputs)
+    {
+        nodeKind[AIGLitToAIGIndex(inputLit)] = INPUT_NODE;
+    }
+
+    // the inversion of an edge, ignored on the edges of the inputs if needed
+    auto getEdgeInv = [&](AIGLIT inLit) -> uint64_t
+    {
+        if (isInputPolarityFree && nodeKind[AIGLitToAIGIndex(inLit)] == INPUT_NODE)
+        {
+            return 0;
+        }
+        return IsAIGLitNeg(inLit) ? 1 : 0;
+    };
+
+    // the fanins of each gate and the fanouts of each node, with the edge inversion
+    vector<vector<pair<AIGINDEX, uint64_t>>> fanins(numOfIndexes);
+    vector<vector<pair<AIGINDEX, uint64_t>>> fanouts(numOfIndexes);
+    // the level from the inputs and the depth from the output (0 if not in the output cone)
+    vector<unsigned> level(numOfIndexes, 0);
+    vector<unsigned> depth(numOfIndexes, 0);
+
+    // we assume the gates are in order from bottom-up
+    for (const AigAndGate& gate : andGates)
+    {
+        const AIGINDEX gateIndex = AIGLitToAIGIndex(gate.GetL());
+        for (const AIGLIT inLit : {gate.GetR0(), gate.GetR1()})
+        {
+            const AIGINDEX inIndex = AIGLitToAIGIndex(inLit);
+            fanins[gateIndex].push_back({inIndex, getEdgeInv(inLit)});
+            fanouts[inIndex].push_back({gateIndex, getEdgeInv(inLit)});
+            level[gateIndex] = max(level[gateIndex], level[inIndex] + 1);
+        }
+    }
+
+    // the key of each node as an output, 0 if it is not an output
+    vector<uint64_t> outputKey(numOfIndexes, 0);
+    for (size_t outPos = 0; outPos < outputs.size(); outPos++)
+    {
+        const AIGINDEX outIndex = AIGLitToAIGIndex(outputs[outPos]);
+        const uint64_t outInv = (!isOutputPolarityFree && IsAIGLitNeg(outputs[outPos])) ? 1 : 0;
+        outputKey[outIndex] = Mix(outputKey[outIndex], Mix(outPos + 1, outInv));
+        depth[outIndex] = 1;
+    }
+
+    for (auto gateRevIt = andGates.rbegin(); gateRevIt != andGates.rend(); ++gateRevIt)
+    {
+        const unsigned gateDepth = depth[AIGLitToAIGIndex(gateRevIt->GetL())];
+        if (gateDepth == 0)
+        {
+            continue;
+        }
+        for (const AIGLIT inLit : {gateRevIt->GetR0(), gateRevIt->GetR1()})
+        {
+            depth[AIGLitToAIGIndex(inLit)] = max(depth[AIGLitToAIGIndex(inLit)], gateDepth + 1);
+        }
+    }
+
+    vector<uint64_t> label(numOfIndexes);
+    for (size_t index = 0; index < numOfIndexes; index++)
+    {
+        label[index] = Mix(Mix(Mix(nodeKind[index], level[index]), depth[index]), outputKey[index]);
+    }
+
+    auto saveInputsLabel = [&](unsigned round)
+    {
+        for (size_t i = 0; i < m_Inputs.size(); i++)
+        {
+            m_Fingerprints[round][i] = label[AIGLitToAIGIndex(m_Inputs[i])];
+        }
+    };
+    saveInputsLabel(0);
+
+    vector<uint64_t> nextLabel(numOfIndexes);
+    vector<uint64_t> edgeKeys;
+    // the multiset of the neighbours keys, sorted so the hash does not depend on the order of the edges
+    auto hashEdges = [&](const vector<pair<AIGINDEX, uint64_t>>& edges) -> uint64_t
+    {
+        edgeKeys.clear();
+        for (const auto& [neighbour, inv] : edges)
+        {
+            edgeKeys.push_back(Mix(label[neighbour], inv));
+        }
+        sort(edgeKeys.begin(), edgeKeys.end());
+
+        uint64_t h = edgeKeys.size();
+        for (uint64_t key : edgeKeys)
+        {
+            h = Mix(h, key);
+        }
+        return h;
+    };
+
+    for (unsigned round = 1; round <= m_NumOfRounds; round++)
+    {
+        for (size_t index = 0; index < numOfIndexes; index++)
+        {
+            nextLabel[index] = Mix(Mix(label[index], hashEdges(fanins[index])), hashEdges(fanouts[index]));
+        }
+        label.swap(nextLabel);
+
+        saveInputsLabel(round);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "Globals/BoolMatchGloblas.hpp"
+#include "Aiger/AigerParser.hpp"
+
+/*
+    class for canonical structural fingerprints of the circuit inputs, independent of the circuit function
+    Weisfeiler-Lehman style hashing over the AIG: every node starts with its level from the inputs and from the output
+    and every round hashes into each node the labels of its fanins and fanouts with the edges inversions
+    the fingerprint of an input after round r describes its neighbourhood up to r levels away, a later round refines the earlier
+    isomorphic circuits get the same fingerprints for matched inputs, near-isomorphic circuits differ only near the changes
+    the fingerprints do not prove anything about a match, they are linear-time hints for ordering only
+    NOTE: they are not used for pruning, since the level, the depth and the refinement rounds change when a circuit is restructured
+    so inputs of a valid match between restructured circuits may get different fingerprints
+*/
+class CirStructSig
+{
+public:
+    // numOfRounds - the number of refinement rounds after the initial labels
+    // isInputPolarityFree - if to ignore the inversions on the edges of the inputs, so an input and its negation get the same fingerprints
+    // isOutputPolarityFree - if to ignore the inversion of the output
+    CirStructSig(const AigerParser& aigerParser, unsigned numOfRounds = DEF_NUM_OF_ROUNDS, bool isInputPolarityFree = false, bool isOutputPolarityFree = false);
+
+    // get the similarity between input x of srcSig and input y of trgSig (start from 0) by the number of rounds they agree on
+    // return a value in (0,1] where 1 means the fingerprints are equal in all the rounds
+    static double GetSimilarity(const CirStructSig& srcSig, size_t x, const CirStructSig& trgSig, size_t y);
+
+    uint64_t GetFingerprint(size_t input, unsigned round) const { return m_Fingerprints[round][input]; };
+
+    unsigned GetNumOfRounds() const { return m_NumOfRounds; };
+
+    // the number of different fingerprints of the inputs after the last round
+    size_t GetNumOfClasses() const;
+
+    static const unsigned DEF_NUM_OF_ROUNDS = 4;
+
+protected:
+
+    // mix two values into a hash
+    static uint64_t Mix(uint64_t h, uint64_t v);
+
+    // compute the fingerprints of all the rounds
+    void ComputeFingerprints(const AigerParser& aigerParser, bool isInputPolarityFree, bool isOutputPolarityFree);
+
+    // hold the inputs
+    const std::vector<AIGLIT> m_Inputs;
+
+    const unsigned m_NumOfRounds;
+
+    // the fingerprint of every input (by position) in every round, round 0 is the initial labels
+    std::vector<std::vector<uint64_t>> m_Fingerprints;
+};
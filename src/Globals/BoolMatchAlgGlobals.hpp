@@ -20,6 +20,10 @@ static const std::string EBATP_P_BEST = "EBatP_P_best";
 static const std::string BOOM_NP_BASE = "BOOM_NP_base";
 // the base default algorithm from BOOM for P
 static const std::string BOOM_P_BASE = "BOOM_P_base";
+// choose the algorithm and its parameters from the circuits features
+static const std::string AUTO_MODE = "auto";
+// race several modes, given as "race:<mode>,<mode>,.."
+static const std::string RACE_MODE_PREFIX = "race:";
 
 // pre-configured algorithms modes
 static const std::vector<std::string> MODES = {
@@ -29,7 +33,8 @@ static const std::vector<std::string> MODES = {
     EBATP_P_BEST,
     BOOM_NP_BASE,
     BOOM_P_BASE,
-    NAIVE_ALG
+    NAIVE_ALG,
+    AUTO_MODE
 };
 
 
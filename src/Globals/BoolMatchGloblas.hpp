@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <time.h>
 
 #include <vector>
 
@@ -206,4 +207,18 @@ inline static bool IsMatchPos(const int x, const int y)
 static bool IsMatchPos(const MatrixIndexMatch& match)
 {
     return IsMatchPos(match.first, match.second);
-};
\ No newline at end of file
+};
+
+
+/*
+    *** Time ***
+*/
+
+// the cpu time of the calling thread in clock() ticks
+// unlike clock() it does not count the other threads, so the timing of a worker in a parallel run is its own
+inline static clock_t ThreadClock()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (clock_t)ts.tv_sec * CLOCKS_PER_SEC + (clock_t)(ts.tv_nsec / (1000000000 / CLOCKS_PER_SEC));
+}
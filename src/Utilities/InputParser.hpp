@@ -16,6 +16,12 @@ class InputParser
             tokens.insert( tokens.end(), params.begin(), params.end() );
         }
 
+        // the params are placed first, so they take precedence over the existing ones
+        void PrependParams(const std::vector<std::string>& params)
+        {
+            tokens.insert( tokens.begin(), params.begin(), params.end() );
+        }
+
         const std::string& getCmdOption(const std::string &option) const
         {
             std::vector<std::string>::const_iterator itr;
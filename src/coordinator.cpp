@@ -0,0 +1,487 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+#include <cerrno>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#include "Utilities/InputParser.hpp"
+
+using namespace std;
+
+/*
+    coordinator for a sharded run of boolmatch_tool
+    run every shard ("/general/shard i/N") in a different process and read its output over a pipe
+    the shards report every cube they searched completely, so the coordinator know the remaining cubes of every process
+    a process that died (i.e. OOM) is restarted on its remaining cubes, and when a process finish the remaining cubes of the largest
+    process are split into two new processes
+    the split process is stopped by SIGUSR1, so it reports the cubes it finished and exit, if it did not exit in time it is killed
+*/
+
+// a single running shard process
+struct ShardProc
+{
+    pid_t pid;
+    // the read end of the process output
+    int outFd;
+    unsigned shardIndex;
+    // the cubes of the process, empty until the process report them
+    vector<size_t> cubeIds;
+    // the output that was not handled yet (partial line)
+    string outBuffer;
+    // the matches printed for every cube by its id, printed only after the cube is done
+    map<size_t, vector<string>> cubeLines;
+    // if the process reported it was interrupted (timeout)
+    bool isInterrupted;
+    // if the process was stopped to split its remaining cubes
+    bool isStoppedForSplit;
+    // when the process was stopped for the split
+    chrono::steady_clock::time_point stopTime;
+    // if the process was reaped while its output is still open (i.e. by a child of a script running boolmatch_tool)
+    bool isExited;
+    int exitStatus;
+};
+
+// *** Params ***
+
+static string toolPath;
+static string srcFileName;
+static string trgFileName;
+// the params given to all the processes
+static vector<string> toolParams;
+static unsigned numOfShards = 1;
+static unsigned maxRestarts = 2;
+static bool stopAtFirstValidMatch = false;
+// the timeout of a single poll in milliseconds, the processes state is checked after every poll
+static const int POLL_TIMEOUT_MS = 1000;
+// the seconds a process stopped for a split may take to exit, i.e. to finish its current solver call, before it is killed
+static const unsigned SPLIT_STOP_TIMEOUT = 30;
+
+// *** Variables ***
+
+static vector<ShardProc> procs;
+// the cubes that were searched completely by any process
+static set<size_t> doneCubes;
+// the number of restarts for every shard
+static map<unsigned, unsigned> shardRestarts;
+// if some cubes were not searched (timeout or too many restarts)
+static bool isInterrupted = false;
+// if the first valid match was found when stopAtFirstValidMatch is used
+static bool isStopped = false;
+
+// *** Stats ***
+
+static unsigned long long numOfValidMatches = 0;
+static unsigned numOfRestarts = 0;
+static unsigned numOfSplits = 0;
+
+
+void PrintUsage()
+{
+    cout << "USAGE: ./boolmatch_coordinator <boolmatch_tool_path> <source_file_path> <target_file_path> [</coord/shards> <N>] [</coord/max_restarts> <value>] [boolmatch_tool parameters]" << endl;
+    cout << "\twhere <boolmatch_tool_path> is the path to boolmatch_tool, or to a script running it with the given arguments (i.e. on another machine)" << endl;
+    cout << "[</coord/shards> <N>] represent the number of shards (processes), by default it is 1" << endl;
+    cout << "[</coord/max_restarts> <value>] represent the maximal number of restarts of a shard that died, by default it is 2" << endl;
+}
+
+// launch a process for the shard, if cubeIds is not empty search only these cubes
+void LaunchShard(unsigned shardIndex, const vector<size_t>& cubeIds)
+{
+    // the pipe is not inherited by the other processes, the write end is duplicated to the output of the process
+    int pipeFds[2];
+    if (pipe2(pipeFds, O_CLOEXEC) != 0)
+    {
+        throw runtime_error("Failed to create a pipe");
+    }
+
+    vector<string> args = {toolPath, srcFileName, trgFileName, "/general/shard", to_string(shardIndex) + "/" + to_string(numOfShards)};
+    if (!cubeIds.empty())
+    {
+        string cubeIdsStr;
+        for (size_t cubeId : cubeIds)
+        {
+            cubeIdsStr += (cubeIdsStr.empty() ? "" : ",") + to_string(cubeId);
+        }
+        args.push_back("/general/shard_cubes");
+        args.push_back(cubeIdsStr);
+    }
+    // the shard params come first, since the first occurrence of a param is used
+    args.insert(args.end(), toolParams.begin(), toolParams.end());
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        throw runtime_error("Failed to fork a shard process");
+    }
+
+    if (pid == 0)
+    {
+        dup2(pipeFds[1], STDOUT_FILENO);
+
+        vector<char*> argv;
+        for (string& arg : args)
+        {
+            argv.push_back(arg.data());
+        }
+        argv.push_back(nullptr);
+
+        execv(argv[0], argv.data());
+        // exec failed
+        _exit(127);
+    }
+
+    close(pipeFds[1]);
+    procs.push_back({pid, pipeFds[0], shardIndex, cubeIds, "", {}, false, false, {}, false, 0});
+}
+
+// get the cubes of the process that were not searched yet
+vector<size_t> GetRemainingCubes(const ShardProc& proc)
+{
+    vector<size_t> remainingCubes;
+    for (size_t cubeId : proc.cubeIds)
+    {
+        if (doneCubes.count(cubeId) == 0)
+        {
+            remainingCubes.push_back(cubeId);
+        }
+    }
+    return remainingCubes;
+}
+
+void StopAllShards()
+{
+    isStopped = true;
+    for (const ShardProc& proc : procs)
+    {
+        kill(proc.pid, SIGKILL);
+    }
+}
+
+// handle a single output line of the process
+void HandleLine(ShardProc& proc, const string& line)
+{
+    const string cubesPrefix = "c Shard " + to_string(proc.shardIndex) + "/" + to_string(numOfShards) + " cubes:";
+    const string cubeDonePrefix = "c Shard cube ";
+    const string cubeMatchPrefix = " match: ";
+
+    if (line.rfind(cubesPrefix, 0) == 0)
+    {
+        proc.cubeIds.clear();
+        size_t pos = cubesPrefix.size();
+        while (pos < line.size())
+        {
+            size_t nextPos = line.find(' ', pos + 1);
+            proc.cubeIds.push_back(stoul(line.substr(pos, nextPos - pos)));
+            pos = nextPos == string::npos ? line.size() : nextPos;
+        }
+    }
+    else if (line.rfind(cubeDonePrefix, 0) == 0)
+    {
+        size_t idEnd = 0;
+        size_t cubeId = stoul(line.substr(cubeDonePrefix.size()), &idEnd);
+        const string cubeLineInfo = line.substr(cubeDonePrefix.size() + idEnd);
+
+        // c Shard cube <id> match: <line>
+        if (cubeLineInfo.rfind(cubeMatchPrefix, 0) == 0)
+        {
+            proc.cubeLines[cubeId].push_back(cubeLineInfo.substr(cubeMatchPrefix.size()));
+            return;
+        }
+
+        // c Shard cube <id> done, valid matches <num>
+        unsigned long long cubeValidMatches = stoull(line.substr(line.rfind(' ') + 1));
+
+        // a cube can be searched again after a restart, count it only once
+        if (doneCubes.insert(cubeId).second)
+        {
+            numOfValidMatches += cubeValidMatches;
+            for (const string& cubeLine : proc.cubeLines[cubeId])
+            {
+                cout << cubeLine << endl;
+            }
+        }
+        proc.cubeLines.erase(cubeId);
+
+        if (stopAtFirstValidMatch && cubeValidMatches > 0)
+        {
+            StopAllShards();
+        }
+    }
+    else if (line.find("*** Interrupted ***") != string::npos)
+    {
+        proc.isInterrupted = true;
+    }
+    else if (line.rfind("Error", 0) == 0)
+    {
+        cout << "c Shard " << proc.shardIndex << " (pid " << proc.pid << "): " << line << endl;
+    }
+}
+
+// handle a process that finished, restart or split the remaining cubes if needed
+void HandleProcExit(size_t procIndex)
+{
+    ShardProc proc = procs[procIndex];
+    procs.erase(procs.begin() + procIndex);
+    close(proc.outFd);
+
+    int status = proc.exitStatus;
+    if (!proc.isExited)
+    {
+        waitpid(proc.pid, &status, 0);
+    }
+
+    if (isStopped)
+    {
+        return;
+    }
+
+    vector<size_t> remainingCubes = GetRemainingCubes(proc);
+    bool isExitedOk = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+    // all the cubes of the process were searched
+    if (!proc.cubeIds.empty() && remainingCubes.empty())
+    {
+        return;
+    }
+
+    if (proc.isStoppedForSplit)
+    {
+        // the first new process continue the current cube, the second take the last half of the cubes
+        size_t splitPos = (remainingCubes.size() + 1) / 2;
+        LaunchShard(proc.shardIndex, vector<size_t>(remainingCubes.begin(), remainingCubes.begin() + splitPos));
+        if (splitPos < remainingCubes.size())
+        {
+            LaunchShard(proc.shardIndex, vector<size_t>(remainingCubes.begin() + splitPos, remainingCubes.end()));
+        }
+        numOfSplits++;
+        return;
+    }
+
+    if (isExitedOk)
+    {
+        // a timeout is global, so the remaining cubes are not searched again
+        if (!proc.isInterrupted)
+        {
+            cout << "c Shard " << proc.shardIndex << " (pid " << proc.pid << ") finished without searching all its cubes" << endl;
+        }
+        isInterrupted = true;
+        return;
+    }
+
+    // the process died (i.e. OOM)
+    cout << "c Shard " << proc.shardIndex << " (pid " << proc.pid << ") died with status " << status << ", " << remainingCubes.size() << " remaining cubes" << endl;
+    if (shardRestarts[proc.shardIndex] >= maxRestarts)
+    {
+        cout << "c Shard " << proc.shardIndex << " reached the maximal number of restarts" << endl;
+        isInterrupted = true;
+        return;
+    }
+
+    shardRestarts[proc.shardIndex]++;
+    numOfRestarts++;
+    // if the process died before reporting its cubes, the whole shard is restarted
+    LaunchShard(proc.shardIndex, remainingCubes);
+}
+
+// when a process finished, split the remaining cubes of the process with the most remaining cubes
+void SplitLargestShard()
+{
+    ShardProc* largestProc = nullptr;
+    size_t largestNumOfCubes = 0;
+    for (ShardProc& proc : procs)
+    {
+        size_t numOfRemainingCubes = GetRemainingCubes(proc).size();
+        if (!proc.isStoppedForSplit && numOfRemainingCubes > largestNumOfCubes)
+        {
+            largestProc = &proc;
+            largestNumOfCubes = numOfRemainingCubes;
+        }
+    }
+
+    // the current cube is searched again, so split only when there are at least two more cubes
+    // the process is interrupted and not killed, so it report the cubes it finished and exit cleanly
+    if (largestProc != nullptr && largestNumOfCubes >= 3)
+    {
+        largestProc->isStoppedForSplit = true;
+        largestProc->stopTime = chrono::steady_clock::now();
+        kill(largestProc->pid, SIGUSR1);
+    }
+}
+
+// read the available output of the process and handle its complete lines
+// return the number of bytes read, 0 at the end of the output
+ssize_t ReadProcOutput(ShardProc& proc)
+{
+    char readBuffer[4096];
+    ssize_t numOfBytes = read(proc.outFd, readBuffer, sizeof(readBuffer));
+    if (numOfBytes > 0)
+    {
+        proc.outBuffer.append(readBuffer, numOfBytes);
+        size_t lineEnd = proc.outBuffer.find('\n');
+        while (lineEnd != string::npos && !isStopped)
+        {
+            HandleLine(proc, proc.outBuffer.substr(0, lineEnd));
+            proc.outBuffer.erase(0, lineEnd + 1);
+            lineEnd = proc.outBuffer.find('\n');
+        }
+    }
+    return numOfBytes;
+}
+
+// handle a process that finished, and split the largest process if this one searched all its cubes
+void FinishProc(size_t procIndex)
+{
+    bool isFinishedOk = !procs[procIndex].isStoppedForSplit && GetRemainingCubes(procs[procIndex]).empty();
+    HandleProcExit(procIndex);
+    if (isFinishedOk && !isStopped)
+    {
+        SplitLargestShard();
+    }
+}
+
+// kill the processes that were stopped for a split but did not exit in time
+// and finish the processes that exited while their output is still open, so the poll will not wait for them forever
+void CheckProcsState()
+{
+    auto now = chrono::steady_clock::now();
+    // iterate from the end since finished processes are removed
+    for (int procIndex = (int)procs.size() - 1; procIndex >= 0; procIndex--)
+    {
+        ShardProc& proc = procs[procIndex];
+        if (proc.isStoppedForSplit && now - proc.stopTime > chrono::seconds(SPLIT_STOP_TIMEOUT))
+        {
+            kill(proc.pid, SIGKILL);
+        }
+
+        if (waitpid(proc.pid, &proc.exitStatus, WNOHANG) != proc.pid)
+        {
+            continue;
+        }
+        proc.isExited = true;
+
+        // the output the process wrote before it exited
+        pollfd outPollFd = {proc.outFd, POLLIN, 0};
+        while (poll(&outPollFd, 1, 0) > 0 && ReadProcOutput(proc) > 0)
+        {
+        }
+
+        FinishProc(procIndex);
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    InputParser cmdInput(argc, argv);
+
+    if (argc < 4 || cmdInput.cmdOptionExists("-h") || cmdInput.cmdOptionExists("--h") || cmdInput.cmdOptionExists("-help") || cmdInput.cmdOptionExists("--help"))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    toolPath = argv[1];
+    srcFileName = argv[2];
+    trgFileName = argv[3];
+
+    try
+    {
+        numOfShards = max(cmdInput.getUintCmdOption("/coord/shards", 1), (unsigned)1);
+        maxRestarts = cmdInput.getUintCmdOption("/coord/max_restarts", 2);
+        stopAtFirstValidMatch = cmdInput.getBoolCmdOption("/alg/stop_at_first_valid_match", false);
+    }
+    catch (exception& ex)
+    {
+        cout << "Error while parsing the parameters: " << ex.what() << endl;
+        return -1;
+    }
+
+    // pass all the params except the coordinator ones
+    for (int i = 4; i < argc; i++)
+    {
+        string param = argv[i];
+        if (param.rfind("/coord/", 0) == 0)
+        {
+            i++;
+            continue;
+        }
+        toolParams.push_back(param);
+    }
+
+    auto beforeRun = chrono::steady_clock::now();
+
+    cout << "c Start sharded run with " << numOfShards << " shards" << endl;
+
+    try
+    {
+        for (unsigned shardIndex = 0; shardIndex < numOfShards; shardIndex++)
+        {
+            LaunchShard(shardIndex, {});
+        }
+
+        while (!procs.empty())
+        {
+            vector<pollfd> pollFds;
+            for (const ShardProc& proc : procs)
+            {
+                pollFds.push_back({proc.outFd, POLLIN, 0});
+            }
+
+            if (poll(pollFds.data(), pollFds.size(), POLL_TIMEOUT_MS) < 0 && errno != EINTR)
+            {
+                throw runtime_error("Failed to poll the shard processes");
+            }
+
+            // iterate from the end since finished processes are removed
+            for (int procIndex = (int)pollFds.size() - 1; procIndex >= 0; procIndex--)
+            {
+                if (pollFds[procIndex].revents == 0)
+                {
+                    continue;
+                }
+
+                if (ReadProcOutput(procs[procIndex]) > 0)
+                {
+                    continue;
+                }
+
+                FinishProc(procIndex);
+            }
+
+            CheckProcsState();
+        }
+    }
+    catch (exception& ex)
+    {
+        StopAllShards();
+        cout << "Error acord: " << ex.what() << endl;
+        return -1;
+    }
+
+    double wallTime = chrono::duration<double>(chrono::steady_clock::now() - beforeRun).count();
+
+    if (isInterrupted)
+    {
+        cout << "c *** Interrupted *** " << endl;
+    }
+    else
+    {
+        cout << "c Finished solving the problem" << endl;
+    }
+    cout << "c Number of valid matches: " << numOfValidMatches << endl;
+    cout << "c Number of searched cubes: " << doneCubes.size() << endl;
+    cout << "c Number of restarted shards: " << numOfRestarts << ", number of split shards: " << numOfSplits << endl;
+    cout << "c wall time : " << wallTime << " sec" << endl;
+    cout << "****************************************" << endl;
+
+    return 0;
+}
@@ -1,9 +1,11 @@
 #include <iostream>
 #include <signal.h>
+#include <unistd.h>
 
 #include "Globals/BoolMatchGloblas.hpp"
 #include "Globals/BoolMatchAlgGlobals.hpp"
 #include "BoolMatchAlg/Algorithms.hpp"
+#include "BoolMatchAlg/AutoMode/BoolMatchAutoMode.hpp"
 
 
 using namespace std;
@@ -11,16 +13,23 @@ using namespace std;
 // define global algo for sigHandling
 BoolMatchAlgBase* boolMatchAlg = nullptr;
 
+// the number of stop signals caught
+volatile sig_atomic_t numOfCaughtSignals = 0;
+
 // function for handling sig
-// just print the result with wasInterrupted = true
+// only request the algorithm to stop, the result is printed by main after the search returned and its threads were joined
+// a repeated signal exits at once, i.e. when the search is stuck inside a long solver call
+// NOTE: only async-signal-safe calls are allowed here
 void sigHandler(int s){
-    printf("Caught signal %d\n",s);
-    if(boolMatchAlg != nullptr)
+    numOfCaughtSignals = numOfCaughtSignals + 1;
+    if (numOfCaughtSignals > 1 || boolMatchAlg == nullptr)
     {
-        boolMatchAlg->PrintResult(true);
-        delete boolMatchAlg;
+        const char msg[] = "Caught signal again, exit without the result\n";
+        ssize_t res = write(STDOUT_FILENO, msg, sizeof(msg) - 1);
+        (void)res;
+        _exit(1);
     }
-    exit(1); 
+    boolMatchAlg->RequestStop();
 }
 
 void PrintUsage()
@@ -41,6 +50,9 @@ void PrintUsage()
     cout << "\t For example: ./boolmatch_tool <input_file_name> /mode " << EBATC_P_BEST << endl;
     cout << "\t Note, the default mode is a basic naive iterative algorithm (EBatP) without any parameters [" << NAIVE_ALG << "]" << endl;
     cout << "*** Please note that there are different modes for P and NP" << endl;
+    cout << "\t Note, the mode [" << AUTO_MODE << "] choose the algorithm and its parameters from the circuits features (P or NP is given by /alg/allow_input_neg_map)" << endl;
+    cout << "\t Note, the mode [" << RACE_MODE_PREFIX << "<mode_name>,<mode_name>,..] run the given modes in parallel processes and print the results of the first to finish" << endl;
+    cout << "[</mode/auto/probe_time> <value>] represent the timeout in seconds of the short runs of the best candidates in the auto mode, default is 0 (no runs)" << endl;
 
     // additonal parameters
     cout << endl;
@@ -51,11 +63,35 @@ void PrintUsage()
     cout << "General parameters:" << endl;
     cout << "[</general/timeout> <value>] provide timeout in seconds, if <value> not provided use default of " << DEF_TIMEOUT << " sec" << endl;
     cout << "[</general/print_matches> <0|1>] represent if to print the found matches, by default it is false" << endl;
+    cout << "[</general/threads> <value>] represent the number of threads, where the match space is split between the threads, by default it is 1" << endl;
+    cout << "[</general/shard> <i/N>] represent to search only the shard i of N disjoint shards of the match space, used by boolmatch_coordinator" << endl;
+    cout << "[</general/shard_cubes> <id,id,..>] represent the cubes ids of the shard to search, by default all the cubes of the shard" << endl;
+    cout << "[</general/checkpoint> <file>] represent the file to save the enumeration state into, periodically and at the end of the run (also on timeout or interrupt)" << endl;
+    cout << "[</general/checkpoint_interval> <value>] represent the interval in seconds between saves of the checkpoint, default is 60" << endl;
+    cout << "[</general/resume> <file>] represent the checkpoint file to continue the enumeration from, the circuits and the P/NP, symmetry and exact count parameters must be the same" << endl;
+    cout << "[</general/eco> <file>] represent the checkpoint of a previous run on slightly different circuits, its witnesses and valid matches that still hold are kept before enumerating the rest" << endl;
     cout << "[</alg/allow_input_neg_map> <0|1>] represent if to allow negated map to the inputs, by default it is false" << endl;
+    cout << "[</alg/allow_output_neg_map> <0|1>] represent if to also find the matches to the negated target output in the same run (NPN with negated map to the inputs), by default it is false" << endl;
     cout << "[</alg/stop_at_first_valid_match> <0|1>] represent if to stop at the first valid match, by default it is false" << endl;
 
     cout << endl;
     cout << "General algorithm parameters:" << endl;
+    cout << "[</alg/matrix_type> <value>] represent the match matrix encoding, 0 - single vars (default), 1 - combined vars, 2 - log encoding, 3 - sparse (only feasible matches)" << endl;
+    cout << "[</alg/use_input_similarity> <0|1>] represent if to prefer matches of similar inputs (structural and simulation signatures), iterative algorithm only" << endl;
+    cout << "[</alg/input_similarity_boost_val> <value>] represent the boost value for the most similar match" << endl;
+    cout << "[</alg/use_struct_sig> <0|1>] represent if to prefer matches of inputs with similar structural fingerprints (Weisfeiler-Lehman hashing of the fanout cones), iterative algorithm only" << endl;
+    cout << "[</alg/struct_sig/rounds> <uint>] represent the number of refinement rounds of the structural fingerprints, by default it is 4" << endl;
+    cout << "[</alg/reduce_to_support> <0|1>] represent if to match only the inputs the output depends on, the irrelevant inputs are matched freely and counted as k! (k!*2^k with negated map) matches, by default it is false" << endl;
+    cout << "[</alg/fixed_map> <file>] represent a file of known matches to assert, a line \"<src input lit> <trg input lit>\" per match where \"!<trg input lit>\" is a negated match" << endl;
+    cout << "[</alg/forbidden_pairs> <file>] represent a file of matches that are not allowed, in the same format as the fixed map" << endl;
+    cout << "[</alg/use_dsd> <0|1>] represent if to eliminate the matches between blocks of the disjoint-support decompositions of the outputs, by default it is false" << endl;
+    cout << "[</alg/dsd/max_exact_block_size> <uint>] represent the max number of inputs of a block that is decomposed exactly by simulation (at most 14), by default it is 10" << endl;
+    cout << "[</alg/use_exact_invariants> <0|1>] represent if to eliminate the matches between inputs with different support, unateness or symmetries, decided exactly by SAT, by default it is false" << endl;
+    cout << "[</alg/exact_invariants/threads> <uint>] represent the number of threads that decide the exact invariants of each circuit, by default it is 4" << endl;
+    cout << "[</alg/compress_sym_matches> <0|1>] represent if to enumerate a single match for each class of matches equal under the inputs symmetries, default is 0" << endl;
+    cout << "[</alg/exact_count> <0|1>] represent if to count exactly the valid matches of the partial valid matches (UnSAT core for valid match), default is 0" << endl;
+    cout << "[</alg/sample> <value>] represent the number of near-uniformly random valid matches to return instead of all the matches, iterative algorithm only, default is 0" << endl;
+    cout << "[</alg/sample_seed> <value>] represent the seed for the sampling, default is 0" << endl;
     cout << "[</alg/use_cirsim> <0|1>] represent if to use circuit simulation" << endl;
     cout << "[</alg/use_top_to_bot_sim> <0|1>] represent if to use top to bottom simulation" << endl;
     cout << "[</alg/use_ucore> <0|1>] represent if to use UnSAT core for valid match" << endl;
@@ -72,6 +108,17 @@ void PrintUsage()
     // cout << "[</alg/block/use_ipasir_for_plain> <0|1>] represent if to use ipasir for plain" << endl;
     // cout << "[</alg/block/use_ipasir_for_dual> <0|1>] represent if to use ipasir for dual" << endl;
     cout << "[</alg/block/use_ucore_for_valid_match> <0|1>] represent if to use UnSAT core for valid match" << endl;
+    cout << "[</alg/block/max_extra_witnesses> <value>] represent the maximal number of extra witnesses (found by simulation) to block for every solver call, default is 0" << endl;
+    cout << "[</alg/block/gen_threads> <value>] represent the number of threads that generalize the witnesses while the solver search for the next one, requires a generalization method, default is 0" << endl;
+
+    cout << endl;
+    cout << "Hybrid algorithm parameters (</alg hybrid>, switch between iterative and blocking steps, use the blocking algorithm parameters):" << endl;
+    cout << "[</alg/hybrid/window> <value>] represent the number of steps before checking if to switch between the iterative and blocking steps, default is 32" << endl;
+
+    cout << endl;
+    cout << "Branch and bound algorithm parameters (</alg bnb>, DFS over the partial matches with dual-rail encoding):" << endl;
+    cout << "[</alg/bnb/min_check_depth> <value>] represent the minimal number of mapped inputs for checking a partial match, default is 1" << endl;
+    cout << "[</alg/bnb/use_ipasir> <0|1>] represent if to use ipasir for the dual-rail solver, default is 0" << endl;
 
     cout << endl;
     cout << "Iterative algorithm parameters:" << endl;
@@ -95,7 +142,24 @@ int main(int argc, char **argv)
     }
 
     string mode = cmdInput.getCmdOptionWDef("/mode", NAIVE_ALG);
-    if (!mode.empty())
+    if (mode == AUTO_MODE)
+    {
+        try
+        {
+            BoolMatchAutoMode autoMode(cmdInput);
+            cmdInput.AppendParams(autoMode.SelectParams(argv[1], argv[2]));
+        }
+        catch (exception& ex)
+        {
+            cout << "Error while choosing the mode: " << ex.what() << endl;
+            return -1;
+        }
+    }
+    else if (mode.rfind(RACE_MODE_PREFIX, 0) == 0)
+    {
+        // the params of every mode are given only to its racer
+    }
+    else if (!mode.empty())
     {
         auto itMap = MODE_PARAMS.find(mode);
 
@@ -118,7 +182,15 @@ int main(int argc, char **argv)
 
     try
     {
-        if (alg == "iter")
+        if (mode.rfind(RACE_MODE_PREFIX, 0) == 0)
+        {
+            boolMatchAlg = new BoolMatchAlgRace(cmdInput);
+        }
+        else if (cmdInput.getUintCmdOption("/general/threads", 1) > 1 || cmdInput.cmdOptionExists("/general/shard"))
+        {
+            boolMatchAlg = new BoolMatchAlgParallel(cmdInput);
+        }
+        else if (alg == "iter")
         {
             boolMatchAlg = new BoolMatchAlgIterTseitinEnc(cmdInput);
         }
@@ -126,6 +198,14 @@ int main(int argc, char **argv)
         {
             boolMatchAlg = new BoolMatchAlgBlockTseitinEnc(cmdInput);
         }
+        else if (alg == "hybrid")
+        {
+            boolMatchAlg = new BoolMatchAlgHybrid(cmdInput);
+        }
+        else if (alg == "bnb")
+        {
+            boolMatchAlg = new BoolMatchAlgBranchBound(cmdInput);
+        }
         else
         {
             throw runtime_error("unkown algorithm type provided");
@@ -142,7 +222,8 @@ int main(int argc, char **argv)
     }
 
 
-    // define sigaction for catchin ctr+c etc..
+    // define sigaction for catchin ctr+c, kill etc..
+    // SIGUSR1 is sent by the coordinator to stop a shard it splits
     struct sigaction sigIntHandler;
 
     sigIntHandler.sa_handler = sigHandler;
@@ -150,20 +231,30 @@ int main(int argc, char **argv)
     sigIntHandler.sa_flags = 0;
 
     sigaction(SIGINT, &sigIntHandler, NULL);
+    sigaction(SIGTERM, &sigIntHandler, NULL);
+    sigaction(SIGUSR1, &sigIntHandler, NULL);
 
+    int exitCode = 0;
     try
     { 
+        // a stop request only ends the search, the result is printed as interrupted
         boolMatchAlg->FindAllMatches();
         boolMatchAlg->PrintResult();
+        exitCode = numOfCaughtSignals > 0 ? 1 : 0;
     }
     catch (exception& ex)
     {
-        delete boolMatchAlg;
         cout << "Error acord: " << ex.what() << endl;
-        return -1;
+        exitCode = -1;
     }
 
+    // the algorithm can not be stopped while it is deleted
+    sigIntHandler.sa_handler = SIG_IGN;
+    sigaction(SIGINT, &sigIntHandler, NULL);
+    sigaction(SIGTERM, &sigIntHandler, NULL);
+    sigaction(SIGUSR1, &sigIntHandler, NULL);
+
     delete boolMatchAlg;
 
-    return 0;
+    return exitCode;
 }